@@ -0,0 +1,263 @@
+/**
+* \file AnneauES.cpp
+* \brief Le code de l'anneau de lectures et d'écritures asynchrones.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "AnneauES.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+#ifdef ANNEAU_ES_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace TP3
+{
+
+    AnneauES::AnneauES(unsigned int profondeur, bool secours)
+        : profondeur(profondeur), nbEnCours(0),
+#ifdef ANNEAU_ES_IO_URING
+          anneau(-1), zoneSoumissions(nullptr), tailleZoneSoumissions(0), zoneAchevements(nullptr), tailleZoneAchevements(0),
+          entrees(nullptr), tailleEntrees(0), queueSoumissions(nullptr), masqueSoumissions(nullptr),
+          tableauSoumissions(nullptr), teteAchevements(nullptr), queueAchevements(nullptr), masqueAchevements(nullptr),
+          achevements(nullptr), nbPrepares(0),
+#endif
+          arret(false)
+    {
+        if (profondeur == 0) throw std::logic_error("AnneauES: la profondeur doit être positive");
+#ifdef ANNEAU_ES_IO_URING
+        if (!secours && _ouvrirNoyau()) return;
+#endif
+        fil = std::thread(&AnneauES::_executer, this);
+    }
+
+    AnneauES::~AnneauES()
+    {
+        // Le noyau et le fil écrivent encore dans les tampons des requêtes en cours : on les attend
+        try
+        {
+            while (nbEnCours > 0) attendre();
+        }
+        catch (...)
+        {
+        }
+#ifdef ANNEAU_ES_IO_URING
+        if (anneau >= 0)
+        {
+            _fermerNoyau();
+            return;
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> garde(verrou);
+            arret = true;
+        }
+        requetesPretes.notify_one();
+        fil.join();
+    }
+
+    void AnneauES::lire(int fd, void* tampon, std::size_t taille, std::uint64_t position, std::uint64_t jeton)
+    {
+        _preparer(Requete{false, fd, tampon, taille, position, jeton});
+    }
+
+    void AnneauES::ecrire(int fd, const void* tampon, std::size_t taille, std::uint64_t position, std::uint64_t jeton)
+    {
+        _preparer(Requete{true, fd, const_cast<void*>(tampon), taille, position, jeton});
+    }
+
+    void AnneauES::soumettre()
+    {
+#ifdef ANNEAU_ES_IO_URING
+        if (anneau >= 0)
+        {
+            while (nbPrepares > 0)
+            {
+                long soumises = syscall(__NR_io_uring_enter, anneau, nbPrepares, 0, 0, nullptr, 0);
+                if (soumises < 0 && errno == EINTR) continue;
+                if (soumises < 0) throw std::runtime_error(std::string("AnneauES::soumettre: ") + std::strerror(errno));
+                nbPrepares -= static_cast<unsigned int>(soumises);
+            }
+            return;
+        }
+#endif
+        if (requetes.empty()) return;
+        {
+            std::lock_guard<std::mutex> garde(verrou);
+            soumises.insert(soumises.end(), requetes.begin(), requetes.end());
+        }
+        requetes.clear();
+        requetesPretes.notify_one();
+    }
+
+    AnneauES::Achevement AnneauES::attendre()
+    {
+        if (nbEnCours == 0) throw std::logic_error("AnneauES::attendre: aucune requête en cours");
+#ifdef ANNEAU_ES_IO_URING
+        if (anneau >= 0)
+        {
+            for (;;)
+            {
+                unsigned int tete = *teteAchevements;
+                if (tete != __atomic_load_n(queueAchevements, __ATOMIC_ACQUIRE))
+                {
+                    const io_uring_cqe& fin = static_cast<const io_uring_cqe*>(achevements)[tete & *masqueAchevements];
+                    Achevement achevement{fin.user_data, fin.res};
+                    __atomic_store_n(teteAchevements, tete + 1, __ATOMIC_RELEASE);
+                    nbEnCours--;
+                    return achevement;
+                }
+                // Un seul appel soumet ce qui est prêt et dort jusqu'au prochain achèvement
+                long soumises = syscall(__NR_io_uring_enter, anneau, nbPrepares, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (soumises < 0 && errno == EINTR) continue;
+                if (soumises < 0) throw std::runtime_error(std::string("AnneauES::attendre: ") + std::strerror(errno));
+                nbPrepares -= static_cast<unsigned int>(soumises);
+            }
+        }
+#endif
+        soumettre();
+        std::unique_lock<std::mutex> garde(verrou);
+        achevementsPrets.wait(garde, [this] { return !faites.empty(); });
+        Achevement achevement = faites.front();
+        faites.pop_front();
+        nbEnCours--;
+        return achevement;
+    }
+
+    unsigned int AnneauES::enCours() const
+    {
+        return nbEnCours;
+    }
+
+    bool AnneauES::noyau() const
+    {
+#ifdef ANNEAU_ES_IO_URING
+        return anneau >= 0;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * \brief Ajoute une requête à celles qui partiront au prochain soumettre
+     */
+    void AnneauES::_preparer(const Requete& requete)
+    {
+        if (nbEnCours == profondeur) throw std::logic_error("AnneauES: trop de requêtes en cours");
+        nbEnCours++;
+#ifdef ANNEAU_ES_IO_URING
+        if (anneau >= 0)
+        {
+            unsigned int queue = *queueSoumissions;
+            unsigned int index = queue & *masqueSoumissions;
+            io_uring_sqe& entree = static_cast<io_uring_sqe*>(entrees)[index];
+            std::memset(&entree, 0, sizeof(entree));
+            entree.opcode = requete.ecriture ? IORING_OP_WRITE : IORING_OP_READ;
+            entree.fd = requete.fd;
+            entree.addr = reinterpret_cast<std::uint64_t>(requete.tampon);
+            entree.len = static_cast<std::uint32_t>(std::min<std::size_t>(requete.taille, INT_MAX)); // au-delà : un transfert partiel
+            entree.off = requete.position;
+            entree.user_data = requete.jeton;
+            tableauSoumissions[index] = index;
+            __atomic_store_n(queueSoumissions, queue + 1, __ATOMIC_RELEASE);
+            nbPrepares++;
+            return;
+        }
+#endif
+        requetes.push_back(requete);
+    }
+
+    /**
+     * \brief Le fil de secours : exécute les requêtes soumises dans l'ordre, avec pread et pwrite
+     */
+    void AnneauES::_executer()
+    {
+        std::unique_lock<std::mutex> garde(verrou);
+        for (;;)
+        {
+            requetesPretes.wait(garde, [this] { return arret || !soumises.empty(); });
+            if (soumises.empty()) return;
+            Requete requete = soumises.front();
+            soumises.pop_front();
+            garde.unlock();
+            ssize_t resultat;
+            do
+            {
+                resultat = requete.ecriture ? pwrite(requete.fd, requete.tampon, requete.taille, off_t(requete.position))
+                                            : pread(requete.fd, requete.tampon, requete.taille, off_t(requete.position));
+            } while (resultat < 0 && errno == EINTR);
+            garde.lock();
+            faites.push_back(Achevement{requete.jeton, resultat < 0 ? -std::int64_t(errno) : std::int64_t(resultat)});
+            achevementsPrets.notify_one();
+        }
+    }
+
+#ifdef ANNEAU_ES_IO_URING
+    /**
+     * \brief Crée l'io_uring et projette ses anneaux en mémoire
+     * \return faux si le noyau refuse; l'anneau reste alors fermé
+     */
+    bool AnneauES::_ouvrirNoyau()
+    {
+        io_uring_params parametres;
+        std::memset(&parametres, 0, sizeof(parametres));
+        long fd = syscall(__NR_io_uring_setup, profondeur, &parametres);
+        if (fd < 0) return false;
+        anneau = int(fd);
+        tailleZoneSoumissions = parametres.sq_off.array + parametres.sq_entries * sizeof(unsigned int);
+        tailleZoneAchevements = parametres.cq_off.cqes + parametres.cq_entries * sizeof(io_uring_cqe);
+        bool uneZone = (parametres.features & IORING_FEAT_SINGLE_MMAP) != 0; // les deux anneaux partagent une projection
+        if (uneZone) tailleZoneSoumissions = tailleZoneAchevements = std::max(tailleZoneSoumissions, tailleZoneAchevements);
+        zoneSoumissions = mmap(nullptr, tailleZoneSoumissions, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, anneau, IORING_OFF_SQ_RING);
+        if (zoneSoumissions == MAP_FAILED) zoneSoumissions = nullptr;
+        zoneAchevements = uneZone ? zoneSoumissions
+                                  : mmap(nullptr, tailleZoneAchevements, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, anneau, IORING_OFF_CQ_RING);
+        if (zoneAchevements == MAP_FAILED) zoneAchevements = nullptr;
+        tailleEntrees = parametres.sq_entries * sizeof(io_uring_sqe);
+        entrees = mmap(nullptr, tailleEntrees, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, anneau, IORING_OFF_SQES);
+        if (entrees == MAP_FAILED) entrees = nullptr;
+        if (zoneSoumissions == nullptr || zoneAchevements == nullptr || entrees == nullptr)
+        {
+            _fermerNoyau();
+            return false;
+        }
+        char* soumissions = static_cast<char*>(zoneSoumissions);
+        queueSoumissions = reinterpret_cast<unsigned int*>(soumissions + parametres.sq_off.tail);
+        masqueSoumissions = reinterpret_cast<unsigned int*>(soumissions + parametres.sq_off.ring_mask);
+        tableauSoumissions = reinterpret_cast<unsigned int*>(soumissions + parametres.sq_off.array);
+        char* fins = static_cast<char*>(zoneAchevements);
+        teteAchevements = reinterpret_cast<unsigned int*>(fins + parametres.cq_off.head);
+        queueAchevements = reinterpret_cast<unsigned int*>(fins + parametres.cq_off.tail);
+        masqueAchevements = reinterpret_cast<unsigned int*>(fins + parametres.cq_off.ring_mask);
+        achevements = fins + parametres.cq_off.cqes;
+        return true;
+    }
+
+    /**
+     * \brief Défait les projections et ferme l'io_uring
+     */
+    void AnneauES::_fermerNoyau()
+    {
+        if (entrees != nullptr) munmap(entrees, tailleEntrees);
+        if (zoneAchevements != nullptr && zoneAchevements != zoneSoumissions) munmap(zoneAchevements, tailleZoneAchevements);
+        if (zoneSoumissions != nullptr) munmap(zoneSoumissions, tailleZoneSoumissions);
+        entrees = zoneSoumissions = zoneAchevements = nullptr;
+        close(anneau);
+        anneau = -1;
+    }
+#endif
+
+}//Fin du namespace
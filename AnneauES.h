@@ -0,0 +1,156 @@
+/**
+* \file AnneauES.h
+* \brief Interface d'un anneau de lectures et d'écritures asynchrones dans des fichiers (io_uring, ou un fil de secours)
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define ANNEAU_ES_IO_URING
+#endif
+#endif
+
+#ifndef _ANNEAUES__H
+#define _ANNEAUES__H
+
+namespace TP3
+{
+
+   /**
+   * \class AnneauES
+   *
+   * \brief Lectures et écritures à une position d'un fichier (comme pread et pwrite) qui se
+   *        poursuivent pendant que l'appelant calcule.
+   *
+   * Les requêtes sont préparées par lire et ecrire, partent ensemble au prochain soumettre (ou
+   * attendre), et se terminent dans n'importe quel ordre : attendre donne le jeton de l'une d'elles
+   * avec son résultat. Le tampon d'une requête doit rester valide et intact jusqu'à son achèvement.
+   *
+   * Sous Linux, l'anneau est un io_uring du noyau, appelé directement (io_uring_setup,
+   * io_uring_enter) sans liburing : un seul appel système soumet toutes les requêtes prêtes et
+   * attend un achèvement. Si le noyau le refuse (noyau trop ancien, io_uring interdit) ou ailleurs
+   * qu'à Linux, un fil de secours exécute les requêtes une à une avec pread et pwrite.
+   *
+   * Un seul fil doit utiliser un anneau.
+   *
+   */
+   class AnneauES
+   {
+   public:
+
+      /**
+      * \brief La fin d'une requête
+      */
+      struct Achevement
+      {
+         std::uint64_t jeton;     // Celui donné à lire ou ecrire.
+         std::int64_t resultat;   // Le nombre d'octets lus ou écrits (0 : fin du fichier), ou -errno.
+      };
+
+      /**
+      * \param[in] profondeur le nombre maximal de requêtes en cours
+      * \param[in] secours vrai pour utiliser le fil de secours même si io_uring est disponible
+      * \exception logic_error si profondeur est 0
+      * \exception runtime_error si ni io_uring ni le fil de secours ne peuvent démarrer
+      */
+      explicit AnneauES(unsigned int profondeur, bool secours = false);
+      ~AnneauES();
+
+      AnneauES(const AnneauES&) = delete;
+      AnneauES& operator=(const AnneauES&) = delete;
+
+      /**
+      * \brief Prépare la lecture de taille octets de fd, à partir de position, dans tampon
+      * \exception logic_error s'il y a déjà profondeur requêtes en cours
+      */
+      void lire(int fd, void* tampon, std::size_t taille, std::uint64_t position, std::uint64_t jeton);
+
+      /**
+      * \brief Prépare l'écriture de taille octets de tampon dans fd, à partir de position
+      * \exception logic_error s'il y a déjà profondeur requêtes en cours
+      */
+      void ecrire(int fd, const void* tampon, std::size_t taille, std::uint64_t position, std::uint64_t jeton);
+
+      /**
+      * \brief Lance les requêtes préparées
+      * \exception runtime_error si le noyau refuse la soumission
+      */
+      void soumettre();
+
+      /**
+      * \brief Lance les requêtes préparées puis attend qu'une requête se termine
+      * \exception logic_error si aucune requête n'est en cours
+      * \exception runtime_error si le noyau refuse l'attente
+      */
+      Achevement attendre();
+
+      /**
+      * \brief Donne le nombre de requêtes préparées ou lancées qui ne sont pas encore achevées
+      */
+      unsigned int enCours() const;
+
+      /**
+      * \brief Dit si l'anneau est un io_uring du noyau (faux : le fil de secours)
+      */
+      bool noyau() const;
+
+   private:
+
+      struct Requete
+      {
+         bool ecriture;
+         int fd;
+         void* tampon;
+         std::size_t taille;
+         std::uint64_t position;
+         std::uint64_t jeton;
+      };
+
+      unsigned int profondeur;
+      unsigned int nbEnCours;
+
+#ifdef ANNEAU_ES_IO_URING
+      int anneau;                        // Le descripteur de l'io_uring, -1 : fil de secours.
+      void* zoneSoumissions;             // Les anneaux et les entrées projetés en mémoire.
+      std::size_t tailleZoneSoumissions;
+      void* zoneAchevements;
+      std::size_t tailleZoneAchevements;
+      void* entrees;
+      std::size_t tailleEntrees;
+      unsigned int *queueSoumissions, *masqueSoumissions, *tableauSoumissions;
+      unsigned int *teteAchevements, *queueAchevements, *masqueAchevements;
+      void* achevements;
+      unsigned int nbPrepares;           // Entrées écrites et pas encore soumises.
+
+      bool _ouvrirNoyau();
+      void _fermerNoyau();
+#endif
+
+      // Fil de secours
+      std::thread fil;
+      std::mutex verrou;
+      std::condition_variable requetesPretes, achevementsPrets;
+      std::deque<Requete> requetes;      // Préparées, pas encore soumises.
+      std::deque<Requete> soumises;      // À exécuter par le fil.
+      std::deque<Achevement> faites;
+      bool arret;
+
+      void _preparer(const Requete& requete);
+      void _executer();
+   };
+
+}//Fin du namespace
+
+#endif
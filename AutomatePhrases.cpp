@@ -0,0 +1,131 @@
+/**
+* \file AutomatePhrases.cpp
+* \brief Le code de l'automate d'Aho-Corasick sur les mots.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "AutomatePhrases.h"
+#include <algorithm>
+
+namespace TP3
+{
+
+    AutomatePhrases::AutomatePhrases() : etats(1, Etat{0, AUCUN, 0, 0}), nbPhrases(0)
+    {
+    }
+
+    void AutomatePhrases::ajouter(const std::string& phrase)
+    {
+        std::uint32_t etat = 0;
+        for (std::size_t debut = 0; debut <= phrase.size(); )
+        {
+            std::size_t fin = std::min(phrase.find('_', debut), phrase.size());
+            if (fin > debut)
+            {
+                auto mot = identifiants.emplace(phrase.substr(debut, fin - debut), std::uint32_t(identifiants.size())).first->second;
+                auto suivant = transitions.emplace((std::uint64_t(etat) << 32) | mot, std::uint32_t(etats.size()));
+                if (suivant.second) etats.push_back(Etat{0, AUCUN, 0, etats[etat].profondeur + 1});
+                etat = suivant.first->second;
+            }
+            debut = fin + 1;
+        }
+        if (etat == 0 || etats[etat].longueur != 0) return; // phrase vide ou déjà ajoutée
+        etats[etat].longueur = etats[etat].profondeur;
+        nbPhrases++;
+    }
+
+    void AutomatePhrases::construire()
+    {
+        // Les liens d'un état dépendent de ceux des états moins profonds : arêtes par profondeur croissante
+        std::vector<std::pair<std::uint64_t, std::uint32_t> > aretes(transitions.begin(), transitions.end());
+        std::sort(aretes.begin(), aretes.end(), [this](const std::pair<std::uint64_t, std::uint32_t>& a,
+                                                       const std::pair<std::uint64_t, std::uint32_t>& b) {
+            return etats[a.second].profondeur < etats[b.second].profondeur;
+        });
+        for (const auto& arete : aretes)
+        {
+            std::uint32_t parent = std::uint32_t(arete.first >> 32), mot = std::uint32_t(arete.first), enfant = arete.second;
+            std::uint32_t echec = 0;
+            if (parent != 0)
+            {
+                std::uint32_t f = etats[parent].echec;
+                std::uint32_t suivant = _transition(f, mot);
+                while (suivant == AUCUN && f != 0)
+                {
+                    f = etats[f].echec;
+                    suivant = _transition(f, mot);
+                }
+                if (suivant != AUCUN) echec = suivant;
+            }
+            etats[enfant].echec = echec;
+            etats[enfant].sortie = etats[echec].longueur != 0 ? echec : etats[echec].sortie;
+        }
+    }
+
+    void AutomatePhrases::rechercher(const std::vector<std::string>& mots, std::vector<Correspondance>& correspondances) const
+    {
+        correspondances.clear();
+        if (nbPhrases == 0) return;
+        std::vector<std::uint32_t> plusLongue(mots.size(), 0); // plus longue expression qui commence à chaque mot
+        std::uint32_t etat = 0;
+        for (std::size_t i = 0; i < mots.size(); i++)
+        {
+            auto mot = identifiants.find(mots[i]);
+            if (mot == identifiants.end()) // mot d'aucune expression : on repart de la racine
+            {
+                etat = 0;
+                continue;
+            }
+            std::uint32_t suivant = _transition(etat, mot->second);
+            while (suivant == AUCUN && etat != 0)
+            {
+                etat = etats[etat].echec;
+                suivant = _transition(etat, mot->second);
+            }
+            etat = suivant == AUCUN ? 0 : suivant;
+            for (std::uint32_t t = etats[etat].longueur != 0 ? etat : etats[etat].sortie; t != AUCUN; t = etats[t].sortie)
+            {
+                std::size_t premier = i + 1 - etats[t].longueur;
+                plusLongue[premier] = std::max(plusLongue[premier], etats[t].longueur);
+            }
+        }
+        for (std::size_t i = 0; i < mots.size(); )
+        {
+            if (plusLongue[i] == 0)
+            {
+                i++;
+                continue;
+            }
+            correspondances.push_back(Correspondance{i, plusLongue[i]});
+            i += plusLongue[i];
+        }
+    }
+
+    std::size_t AutomatePhrases::nombrePhrases() const
+    {
+        return nbPhrases;
+    }
+
+    void AutomatePhrases::vider()
+    {
+        identifiants.clear();
+        transitions.clear();
+        etats.assign(1, Etat{0, AUCUN, 0, 0});
+        nbPhrases = 0;
+    }
+
+    /**
+     * \brief Donne l'état atteint depuis etat en lisant mot, ou AUCUN s'il n'y a pas de transition
+     */
+    std::uint32_t AutomatePhrases::_transition(std::uint32_t etat, std::uint32_t mot) const
+    {
+        auto suivant = transitions.find((std::uint64_t(etat) << 32) | mot);
+        return suivant == transitions.end() ? AUCUN : suivant->second;
+    }
+
+}//Fin du namespace
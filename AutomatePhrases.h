@@ -0,0 +1,105 @@
+/**
+* \file AutomatePhrases.h
+* \brief Interface d'un automate d'Aho-Corasick sur les mots, pour reconnaître les expressions de plusieurs mots
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _AUTOMATEPHRASES__H
+#define _AUTOMATEPHRASES__H
+
+namespace TP3
+{
+
+   /**
+   * \class AutomatePhrases
+   *
+   * \brief Automate d'Aho-Corasick dont l'alphabet est l'ensemble des mots des expressions.
+   *
+   * Une expression s'écrit comme dans le fichier de dictionnaire, ses mots joints par '_'
+   * (pomme_de_terre, au_fur_et_a_mesure). Chaque mot reçoit un identifiant; un état est un
+   * préfixe d'expression, et ses transitions sont rangées dans une seule table de hachage
+   * indexée par (état, mot). Les liens d'échec et de sortie sont calculés par construire(),
+   * après quoi rechercher() trouve toutes les expressions d'une suite de mots en une passe.
+   *
+   */
+   class AutomatePhrases
+   {
+   public:
+
+      /**
+      * \brief Une expression reconnue : les mots[premier, premier + nbMots)
+      */
+      struct Correspondance
+      {
+         std::size_t premier;
+         std::size_t nbMots;
+      };
+
+      AutomatePhrases();
+
+      /**
+      * \brief Ajoute une expression, ses mots joints par '_'; les parties vides sont ignorées
+      * \post L'automate doit être reconstruit (construire) avant la prochaine recherche.
+      */
+      void ajouter(const std::string& phrase);
+
+      /**
+      * \brief Calcule les liens d'échec et de sortie
+      */
+      void construire();
+
+      /**
+      * \brief Trouve les expressions d'une suite de mots, en gardant à chaque position la plus
+      *        longue qui y commence et en sautant celles qui chevauchent une expression déjà retenue
+      *
+      * \param[in] mots les mots du texte, normalisés comme les expressions
+      * \param[out] correspondances les expressions retenues, dans l'ordre du texte
+      * \pre construire a été appelée depuis le dernier ajout
+      */
+      void rechercher(const std::vector<std::string>& mots, std::vector<Correspondance>& correspondances) const;
+
+      /**
+      * \brief Donne le nombre d'expressions
+      */
+      std::size_t nombrePhrases() const;
+
+      /**
+      * \brief Retire toutes les expressions
+      */
+      void vider();
+
+   private:
+
+      static constexpr std::uint32_t AUCUN = 0xffffffffu;
+
+      struct Etat
+      {
+         std::uint32_t echec;       // Plus long suffixe propre qui est aussi un état.
+         std::uint32_t sortie;      // Plus long suffixe propre qui termine une expression, ou AUCUN.
+         std::uint32_t longueur;    // Nombre de mots de l'expression qui finit ici, 0 s'il n'y en a pas.
+         std::uint32_t profondeur;  // Nombre de mots du préfixe.
+      };
+
+      std::unordered_map<std::string, std::uint32_t> identifiants;   // Mot -> identifiant.
+      std::unordered_map<std::uint64_t, std::uint32_t> transitions;  // (état << 32 | mot) -> état.
+      std::vector<Etat> etats;                                        // etats[0] est la racine.
+      std::size_t nbPhrases;
+
+      std::uint32_t _transition(std::uint32_t etat, std::uint32_t mot) const;
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,307 @@
+/**
+* \file BancDicoSynonymes.cpp
+* \brief Banc de mesure du dictionnaire des synonymes, sur un lexique synthétique
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+* Usage : BancDicoSynonymes [radicaux]
+* Compilation : g++ -std=c++17 -O2 -pthread BancDicoSynonymes.cpp puis les .cpp du dictionnaire (tous sauf
+*               Principal.cpp, ServeurDico.cpp, ClientCharge.cpp, TransformerFichier.cpp et TestsDicoSynonymes.cpp)
+*
+* Le dépôt n'a pas de lexique français : les radicaux (41000 par défaut) sont faits de syllabes tirées
+* avec une graine fixe. Un radical sur six est un verbe en -er (39 formes conjuguées), deux sur neuf
+* des adjectifs en -al ou -eux (4 formes), les autres des noms en -tion ou -ment (2 formes). Le
+* lexique est écrit au format de chargerDicoSynonyme dans le dossier temporaire du système, avec
+* une ligne de synonymes pour six radicaux. Chaque mesure garde le meilleur de trois essais.
+*
+*/
+
+#include "DicoSynonymes.h"
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <thread>
+#include <unistd.h>
+using namespace std;
+using namespace TP3;
+using Horloge = chrono::steady_clock;
+
+namespace
+{
+	struct Entree
+	{
+		string radical;
+		vector<string> flexions;
+	};
+
+	/**
+	 * \brief Tire un lexique de nombre radicaux distincts, toujours le même pour un même nombre
+	 */
+	vector<Entree> genererLexique(int nombre)
+	{
+		static const char* syllabes[] = {"ba", "be", "bi", "bo", "ca", "ce", "ci", "co", "cou", "da", "de", "di", "do", "dou",
+		                                 "fa", "fe", "fi", "fo", "ga", "ge", "gi", "go", "la", "le", "li", "lo", "lou", "ma",
+		                                 "me", "mi", "mo", "mou", "na", "ne", "ni", "no", "pa", "pe", "pi", "po", "pou", "ra",
+		                                 "re", "ri", "ro", "rou", "sa", "se", "si", "so", "sou", "ta", "te", "ti", "to", "tou",
+		                                 "va", "ve", "vi", "vo", "cha", "che", "chi", "tra", "tre", "pla", "pre", "gra", "bri",
+		                                 "fran", "ten", "mon", "lan", "ser", "vin"};
+		static const vector<string> verbe = {"er", "e", "es", "ons", "ez", "ent", "ais", "ait", "ions", "iez", "aient", "ai",
+		                                     "as", "a", "âmes", "âtes", "èrent", "erai", "eras", "era", "erons", "erez",
+		                                     "eront", "erais", "erait", "erions", "eriez", "eraient", "asse", "asses", "ât",
+		                                     "assions", "assiez", "assent", "é", "ée", "és", "ées", "ant"};
+		static const vector<string> adjectif = {"", "e", "s", "es"};
+		static const vector<string> nom = {"", "s"};
+		mt19937 generateur(4);
+		auto tirer = [&generateur](size_t n) { return size_t(generateur() % n); };
+
+		vector<Entree> lexique;
+		unordered_set<string> vus;
+		while (int(lexique.size()) < nombre)
+		{
+			string base;
+			for (size_t i = 0, n = 1 + tirer(3); i < n; i++) base += syllabes[tirer(size(syllabes))];
+			size_t genre = tirer(18);
+			const vector<string>* fins = &nom;
+			string radical;
+			if (genre < 3) // verbe : le radical est l'infinitif, les formes suivent la base
+			{
+				fins = &verbe;
+				radical = base + "er";
+			}
+			else if (genre < 7)
+			{
+				fins = &adjectif;
+				radical = base += tirer(2) ? "al" : "eux";
+			}
+			else radical = base += tirer(3) ? "tion" : "ment";
+			if (!vus.insert(radical).second) continue;
+			Entree entree{radical, {}};
+			for (const string& fin : *fins) entree.flexions.push_back(base + fin);
+			lexique.push_back(move(entree));
+		}
+		return lexique;
+	}
+
+	/**
+	 * \brief Écrit le lexique au format de chargerDicoSynonyme, avec une ligne de synonymes pour six radicaux
+	 */
+	void ecrireLexique(const vector<Entree>& lexique, const string& chemin)
+	{
+		ofstream fichier(chemin);
+		for (const Entree& entree : lexique)
+		{
+			fichier << entree.radical << '\n';
+			for (size_t i = 0; i < entree.flexions.size(); i++) fichier << (i ? " " : "") << entree.flexions[i];
+			fichier << '\n';
+		}
+		fichier << '$';
+		for (size_t i = 0; i + 2 < lexique.size(); i += 6)
+		{
+			fichier << '\n' << lexique[i].radical << ' ' << lexique[i + 1].radical << ' ' << lexique[i + 2].radical;
+		}
+		fichier << '\n';
+		if (!fichier) throw runtime_error("impossible d'écrire " + chemin);
+	}
+
+	/**
+	 * \brief Ressource qui compte les octets alloués et pas encore rendus
+	 */
+	class RessourceComptee : public pmr::memory_resource
+	{
+	public:
+		size_t octets = 0;
+
+	private:
+		void* do_allocate(size_t n, size_t alignement) override
+		{
+			octets += n;
+			return pmr::new_delete_resource()->allocate(n, alignement);
+		}
+
+		void do_deallocate(void* p, size_t n, size_t alignement) override
+		{
+			octets -= n;
+			pmr::new_delete_resource()->deallocate(p, n, alignement);
+		}
+
+		bool do_is_equal(const pmr::memory_resource& autre) const noexcept override
+		{
+			return this == &autre;
+		}
+	};
+
+	/**
+	 * \brief Donne la meilleure durée de trois exécutions de mesure, en millisecondes
+	 */
+	template <typename Mesure>
+	double meilleur(Mesure mesure)
+	{
+		double resultat = 1e300;
+		for (int essai = 0; essai < 3; essai++)
+		{
+			Horloge::time_point debut = Horloge::now();
+			mesure();
+			resultat = min(resultat, chrono::duration<double, milli>(Horloge::now() - debut).count());
+		}
+		return resultat;
+	}
+
+	/**
+	 * \brief Compare chargerDicoSynonyme et chargerEnParallele, destruction du dictionnaire comprise
+	 */
+	void mesurerChargement(const string& chemin)
+	{
+		double sequentiel = meilleur([&chemin]() {
+			ifstream fichier(chemin);
+			DicoSynonymes dico;
+			dico.chargerDicoSynonyme(fichier);
+		});
+		cout << "chargerDicoSynonyme : " << sequentiel << " ms" << endl;
+		vector<unsigned int> nbsFils = {1, 2, 4};
+		if (thread::hardware_concurrency() > 4) nbsFils.push_back(thread::hardware_concurrency());
+		for (unsigned int nbFils : nbsFils)
+		{
+			double parallele = meilleur([&chemin, nbFils]() {
+				DicoSynonymes dico;
+				dico.chargerEnParallele(chemin, nbFils);
+			});
+			cout << "chargerEnParallele, " << nbFils << " fil(s) : " << parallele << " ms" << endl;
+		}
+		double aLaDemande = meilleur([&chemin]() {
+			DicoSynonymes dico;
+			dico.chargerEnParallele(chemin, 0, true);
+		});
+		cout << "chargerEnParallele, synonymes à la demande : " << aLaDemande << " ms" << endl;
+	}
+
+	/**
+	 * \brief Mesure rang, kieme et page à des positions tirées, contre la copie de tout l'ordre alphabétique
+	 */
+	void mesurerPositions(const DicoSynonymes& dico)
+	{
+		const int nbAppels = 20000;
+		int n = dico.nombreRadicaux();
+		mt19937 generateur(5);
+		vector<int> positions(nbAppels);
+		for (int& position : positions) position = int(generateur() % n);
+		vector<string> mots;
+		for (int position : positions) mots.push_back(dico.kieme(position));
+
+		double kieme = meilleur([&]() { for (int position : positions) dico.kieme(position); });
+		double rang = meilleur([&]() { for (const string& mot : mots) dico.rang(mot); });
+		double page = meilleur([&]() { for (int position : positions) dico.page(position, 50); });
+		double tout = meilleur([&]() { dico.page(0, n); });
+		cout << "kieme : " << kieme * 1e6 / nbAppels << " ns, rang : " << rang * 1e6 / nbAppels << " ns, page de 50 : "
+		     << page * 1e3 / nbAppels << " us; tout l'ordre (page(0, " << n << ")) : " << tout << " ms" << endl;
+	}
+
+	/**
+	 * \brief Mesure numeroRadical contre expansion et rechercherRadical, puis la taille du transducteur seul
+	 */
+	void mesurerTransducteur(const DicoSynonymes& dico, const vector<Entree>& lexique)
+	{
+		vector<string> flexions;
+		map<string, uint32_t> numeros;
+		for (const Entree& entree : lexique)
+		{
+			for (const string& flexion : entree.flexions)
+			{
+				flexions.push_back(flexion);
+				numeros.emplace(flexion, uint32_t(dico.rang(entree.radical)));
+			}
+		}
+		shuffle(flexions.begin(), flexions.end(), mt19937(6));
+
+		Horloge::time_point debut = Horloge::now();
+		dico.numeroRadical(""); // construit le transducteur depuis l'arbre
+		double construction = chrono::duration<double, milli>(Horloge::now() - debut).count();
+		double numero = meilleur([&]() { for (const string& flexion : flexions) dico.numeroRadical(flexion); });
+		double expansion = meilleur([&]() { for (const string& flexion : flexions) dico.expansion(flexion); });
+		const size_t nbRecherches = 200; // chaque recherche hors du cache parcourt tout l'arbre
+		debut = Horloge::now();
+		for (size_t i = 0; i < nbRecherches; i++) dico.rechercherRadical(flexions[i]);
+		double radical = chrono::duration<double, milli>(Horloge::now() - debut).count();
+		cout << "numeroRadical : " << numero * 1e6 / flexions.size() << " ns (transducteur construit en " << construction
+		     << " ms), expansion : " << expansion * 1e6 / flexions.size() << " ns, rechercherRadical hors du cache : "
+		     << radical * 1e3 / nbRecherches << " us" << endl;
+
+		TransducteurFlexions transducteur;
+		debut = Horloge::now();
+		transducteur.construire(vector<pair<string, uint32_t> >(numeros.begin(), numeros.end()));
+		construction = chrono::duration<double, milli>(Horloge::now() - debut).count();
+		cout << "Transducteur : " << transducteur.nombreEtats() << " états, " << transducteur.nombreArcs() << " arcs, "
+		     << transducteur.octets() << " octets (" << double(transducteur.octets()) / transducteur.taille()
+		     << " par flexion), construit en " << construction << " ms" << endl;
+	}
+
+	/**
+	 * \brief Mesure la mémoire et le temps des flexions rangées en paradigmes partagés
+	 */
+	void mesurerFlexions(const vector<Entree>& lexique)
+	{
+		RessourceComptee ressource;
+		DicoSynonymes dico(&ressource);
+		for (const Entree& entree : lexique) dico.ajouterRadical(entree.radical);
+		size_t avant = ressource.octets, nbFlexions = 0;
+		Horloge::time_point debut = Horloge::now();
+		for (const Entree& entree : lexique)
+		{
+			for (const string& flexion : entree.flexions) dico.ajouterFlexion(entree.radical, flexion);
+			nbFlexions += entree.flexions.size();
+		}
+		double ajout = chrono::duration<double, milli>(Horloge::now() - debut).count();
+		cout << "Flexions : " << double(ressource.octets - avant) / nbFlexions << " octets par flexion (dictionnaire : "
+		     << ressource.octets / 1e6 << " Mo), ajouterFlexion : " << ajout * 1e6 / nbFlexions << " ns" << endl;
+
+		double lecture = meilleur([&]() { for (const Entree& entree : lexique) dico.getFlexions(entree.radical); });
+		const size_t nbCycles = min<size_t>(lexique.size(), 20000);
+		double cycle = meilleur([&]() { // une forme de plus, puis retirée : deux paradigmes à trouver ou ranger
+			for (size_t i = 0; i < nbCycles; i++)
+			{
+				dico.ajouterFlexion(lexique[i].radical, lexique[i].radical + "issime");
+				dico.supprimerFlexion(lexique[i].radical, lexique[i].radical + "issime");
+			}
+		});
+		cout << "getFlexions : " << lecture * 1e6 / lexique.size() << " ns par radical, ajouterFlexion puis supprimerFlexion : "
+		     << cycle * 1e6 / nbCycles << " ns" << endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int nombre = argc > 1 ? atoi(argv[1]) : 41000;
+	if (nombre <= 0)
+	{
+		cerr << "Usage : " << argv[0] << " [radicaux]" << endl;
+		return 1;
+	}
+	string chemin = (filesystem::temp_directory_path() / ("banc_dico_" + to_string(getpid()) + ".txt")).string();
+	try
+	{
+		vector<Entree> lexique = genererLexique(nombre);
+		ecrireLexique(lexique, chemin);
+		size_t nbFlexions = 0;
+		for (const Entree& entree : lexique) nbFlexions += entree.flexions.size();
+		cout << "Lexique : " << lexique.size() << " radicaux, " << nbFlexions << " flexions, "
+		     << filesystem::file_size(chemin) / 1e6 << " Mo; " << thread::hardware_concurrency() << " coeur(s)" << endl;
+
+		mesurerChargement(chemin);
+		DicoSynonymes dico;
+		dico.chargerEnParallele(chemin);
+		mesurerPositions(dico);
+		mesurerTransducteur(dico, lexique);
+		mesurerFlexions(lexique);
+	}
+	catch (const exception& e)
+	{
+		cerr << "Erreur : " << e.what() << endl;
+		filesystem::remove(chemin);
+		return 1;
+	}
+	filesystem::remove(chemin);
+	return 0;
+}
@@ -0,0 +1,127 @@
+/**
+* \file CacheRadicaux.cpp
+* \brief Le code du cache borné mot -> radical.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "CacheRadicaux.h"
+
+namespace TP3
+{
+
+    CacheRadicaux::CacheRadicaux(std::size_t capacite) : capacite(capacite), aiguille(0), succes(0), echecs(0)
+    {
+        entrees.reserve(capacite);
+        positions.reserve(capacite);
+    }
+
+    bool CacheRadicaux::trouver(const std::string& mot, std::string& radical, bool& existe)
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        auto itr = positions.find(mot);
+        if (itr == positions.end())
+        {
+            echecs++;
+            return false;
+        }
+        Entree& entree = entrees[itr->second];
+        entree.reference = true;
+        radical = entree.radical;
+        existe = entree.existe;
+        succes++;
+        return true;
+    }
+
+    void CacheRadicaux::inserer(const std::string& mot, const std::string& radical, bool existe)
+    {
+        if (capacite == 0) return;
+        std::lock_guard<std::mutex> garde(verrou);
+        auto itr = positions.find(mot);
+        if (itr != positions.end()) // un autre fil l'a déjà résolu
+        {
+            entrees[itr->second].radical = radical;
+            entrees[itr->second].existe = existe;
+            return;
+        }
+        std::size_t position;
+        if (!libres.empty())
+        {
+            position = libres.back();
+            libres.pop_back();
+        }
+        else if (entrees.size() < capacite)
+        {
+            position = entrees.size();
+            entrees.emplace_back();
+        }
+        else
+        {
+            position = _caseAEvincer();
+            positions.erase(entrees[position].mot);
+        }
+        Entree& entree = entrees[position];
+        entree.mot = mot;
+        entree.radical = radical;
+        entree.existe = existe;
+        entree.reference = false; // une entrée doit servir au moins une fois pour survivre à l'aiguille
+        entree.occupee = true;
+        positions.emplace(mot, position);
+    }
+
+    void CacheRadicaux::invalider(const std::string& mot)
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        auto itr = positions.find(mot);
+        if (itr == positions.end()) return;
+        Entree& entree = entrees[itr->second];
+        entree.occupee = false;
+        entree.reference = false;
+        entree.mot.clear();
+        entree.radical.clear();
+        libres.push_back(itr->second);
+        positions.erase(itr);
+    }
+
+    void CacheRadicaux::vider()
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        entrees.clear();
+        positions.clear();
+        libres.clear();
+        aiguille = 0;
+    }
+
+    std::size_t CacheRadicaux::nombreSucces() const
+    {
+        return succes;
+    }
+
+    std::size_t CacheRadicaux::nombreEchecs() const
+    {
+        return echecs;
+    }
+
+    /**
+     * \brief Avance l'aiguille jusqu'à une entrée occupée dont le bit de référence est à 0
+     * \pre Le cache est plein et le verrou est tenu
+     * \return l'indice de l'entrée à remplacer
+     */
+    std::size_t CacheRadicaux::_caseAEvincer()
+    {
+        for (;;)
+        {
+            Entree& entree = entrees[aiguille];
+            std::size_t position = aiguille;
+            aiguille = (aiguille + 1) % entrees.size();
+            if (!entree.occupee) continue;
+            if (!entree.reference) return position;
+            entree.reference = false;
+        }
+    }
+
+}//Fin du namespace
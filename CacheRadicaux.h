@@ -0,0 +1,109 @@
+/**
+* \file CacheRadicaux.h
+* \brief Interface du cache borné mot -> radical placé devant DicoSynonymes::rechercherRadical
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _CACHERADICAUX__H
+#define _CACHERADICAUX__H
+
+namespace TP3
+{
+
+   /**
+   * \class CacheRadicaux
+   *
+   * \brief Cache de taille bornée des résolutions mot -> radical, avec remplacement CLOCK.
+   *
+   * Une résolution peut être négative (le mot n'est la flexion d'aucun radical), ce qui évite
+   * de refaire le parcours complet pour les mots hors dictionnaire, fréquents dans un texte.
+   * Chaque entrée a un bit de référence mis à 1 à chaque succès; pour faire de la place,
+   * l'aiguille remet les bits à 0 jusqu'à trouver une entrée qui n'a pas servi depuis son
+   * dernier passage. Toutes les méthodes sont protégées par un verrou.
+   *
+   */
+   class CacheRadicaux
+   {
+   public:
+
+      /**
+      * \brief Constructeur
+      * \param[in] capacite le nombre maximal de mots retenus (0 désactive le cache)
+      */
+      explicit CacheRadicaux(std::size_t capacite = 4096);
+
+      CacheRadicaux(const CacheRadicaux&) = delete;
+      CacheRadicaux& operator=(const CacheRadicaux&) = delete;
+
+      /**
+      * \brief Cherche la résolution de mot
+      *
+      * \param[out] radical le radical retenu, si existe
+      * \param[out] existe false si le mot est connu pour n'être la flexion d'aucun radical
+      * \return false si mot n'est pas dans le cache (radical et existe ne sont alors pas modifiés)
+      */
+      bool trouver(const std::string& mot, std::string& radical, bool& existe);
+
+      /**
+      * \brief Retient la résolution de mot, en évinçant au besoin une entrée peu utilisée
+      */
+      void inserer(const std::string& mot, const std::string& radical, bool existe);
+
+      /**
+      * \brief Oublie la résolution de mot, s'il y en a une
+      */
+      void invalider(const std::string& mot);
+
+      /**
+      * \brief Oublie toutes les résolutions
+      */
+      void vider();
+
+      /**
+      * \brief Donne le nombre de recherches trouvées dans le cache depuis sa création
+      */
+      std::size_t nombreSucces() const;
+
+      /**
+      * \brief Donne le nombre de recherches absentes du cache depuis sa création
+      */
+      std::size_t nombreEchecs() const;
+
+   private:
+
+      struct Entree
+      {
+         std::string mot;
+         std::string radical;
+         bool existe = false;
+         bool reference = false;     // Mis à 1 à chaque succès, remis à 0 au passage de l'aiguille.
+         bool occupee = false;
+      };
+
+      std::size_t capacite;
+      std::vector<Entree> entrees;                             // Au plus capacite entrées.
+      std::unordered_map<std::string, std::size_t> positions;  // Mot -> indice dans entrees.
+      std::vector<std::size_t> libres;                         // Indices libérés par invalider.
+      std::size_t aiguille;
+      std::atomic<std::size_t> succes;
+      std::atomic<std::size_t> echecs;
+      mutable std::mutex verrou;
+
+      std::size_t _caseAEvincer();
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,225 @@
+/**
+* \file ClientCharge.cpp
+* \brief Générateur de charge pour ServeurDico : requêtes à la chaîne sur plusieurs connexions, latences et débit
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+* Usage : ClientCharge <dictionnaire.txt> [socket] [connexions] [profondeur] [requetes]
+* Compilation : g++ -std=c++17 -O2 -pthread ClientCharge.cpp ProtocoleDico.cpp
+*
+* Les mots des requêtes sont tirés des radicaux et flexions du fichier de dictionnaire servi.
+* Chaque connexion a son fil et garde jusqu'à profondeur requêtes en vol : une nouvelle requête
+* part dès qu'une réponse arrive. Le mélange est de 50 % RADICAL, 20 % FLEXIONS, 20 % SYNONYMES
+* et 10 % TRANSFORMER (phrase de huit mots). La latence d'une requête va de son envoi à la lecture
+* de sa réponse.
+*
+*/
+
+#include "ProtocoleDico.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+using namespace TP3;
+using Horloge = chrono::steady_clock;
+
+namespace
+{
+	/**
+	 * \brief Donne les radicaux et flexions d'un fichier de dictionnaire (sans les traits)
+	 */
+	vector<string> lireMots(const string& chemin)
+	{
+		ifstream fichier(chemin);
+		if (!fichier) throw runtime_error("impossible d'ouvrir " + chemin);
+		vector<string> mots;
+		string ligne, mot;
+		while (getline(fichier, ligne) && ligne != "$")
+		{
+			istringstream ss(ligne);
+			while (ss >> mot) mots.push_back(mot.substr(0, mot.find(':')));
+		}
+		if (mots.empty()) throw runtime_error(chemin + " ne contient aucun mot");
+		return mots;
+	}
+
+	/**
+	 * \brief Envoie tout le tampon sur un socket bloquant
+	 */
+	void envoyerTout(int s, const string& tampon)
+	{
+		for (size_t envoyes = 0; envoyes < tampon.size(); )
+		{
+			ssize_t n = send(s, tampon.data() + envoyes, tampon.size() - envoyes, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR) continue;
+			if (n <= 0) throw runtime_error(string("send: ") + strerror(errno));
+			envoyes += n;
+		}
+	}
+
+	struct Resultat
+	{
+		vector<double> latences;	// En microsecondes.
+		size_t nbAbsents = 0;
+		size_t nbErreurs = 0;
+	};
+
+	/**
+	 * \brief Envoie nbRequetes requêtes sur une connexion, avec au plus profondeur requêtes en vol
+	 */
+	void charger(const string& chemin, const vector<string>& mots, size_t profondeur, size_t nbRequetes,
+				 unsigned int graine, Resultat& resultat)
+	{
+		int s = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		sockaddr_un adresse{};
+		adresse.sun_family = AF_UNIX;
+		strncpy(adresse.sun_path, chemin.c_str(), sizeof(adresse.sun_path) - 1);
+		if (s < 0 || connect(s, reinterpret_cast<sockaddr*>(&adresse), sizeof(adresse)) < 0)
+			throw runtime_error(chemin + ": " + strerror(errno));
+
+		mt19937 generateur(graine);
+		uniform_int_distribution<size_t> unMot(0, mots.size() - 1);
+		uniform_int_distribution<int> centieme(0, 99);
+		deque<Horloge::time_point> enVol;	// Heure d'envoi des requêtes sans réponse, dans l'ordre.
+		uint32_t prochain = 0;
+		string tampon, recus;
+		ProtocoleDico::Trame requete, reponse;
+		resultat.latences.reserve(nbRequetes);
+
+		// Prépare dans tampon les requêtes qui remplissent la fenêtre, puis les envoie d'un coup
+		auto remplir = [&]() {
+			tampon.clear();
+			while (enVol.size() < profondeur && prochain < nbRequetes)
+			{
+				requete.numero = prochain++;
+				requete.champs.assign(1, mots[unMot(generateur)]);
+				int tirage = centieme(generateur);
+				if (tirage < 50) requete.code = ProtocoleDico::RADICAL;
+				else if (tirage < 70) requete.code = ProtocoleDico::FLEXIONS;
+				else if (tirage < 90)
+				{
+					requete.code = ProtocoleDico::SYNONYMES;
+					requete.champs.push_back(ProtocoleDico::champEntier(0));
+				}
+				else
+				{
+					requete.code = ProtocoleDico::TRANSFORMER;
+					for (int i = 1; i < 8; i++) requete.champs[0] += " " + mots[unMot(generateur)];
+				}
+				ProtocoleDico::ecrire(requete, tampon);
+				enVol.push_back(Horloge::now());
+			}
+			if (!tampon.empty()) envoyerTout(s, tampon);
+		};
+
+		remplir();
+		char morceau[1 << 16];
+		size_t lus = 0;
+		while (!enVol.empty())
+		{
+			ssize_t n = recv(s, morceau, sizeof(morceau), 0);
+			if (n < 0 && errno == EINTR) continue;
+			if (n <= 0) throw runtime_error("connexion fermée par le serveur");
+			recus.append(morceau, n);
+			Horloge::time_point maintenant = Horloge::now();
+			size_t taille;
+			while ((taille = ProtocoleDico::lire(recus.data() + lus, recus.size() - lus, reponse)) > 0)
+			{
+				lus += taille;
+				resultat.latences.push_back(chrono::duration<double, micro>(maintenant - enVol.front()).count());
+				enVol.pop_front();
+				if (reponse.code == ProtocoleDico::ABSENT) resultat.nbAbsents++;
+				else if (reponse.code == ProtocoleDico::ERREUR) resultat.nbErreurs++;
+			}
+			recus.erase(0, lus);
+			lus = 0;
+			remplir();
+		}
+		close(s);
+	}
+
+	double centile(const vector<double>& triees, double p)
+	{
+		return triees[min(triees.size() - 1, size_t(p * triees.size()))];
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		cerr << "Usage : " << argv[0] << " <dictionnaire.txt> [socket] [connexions] [profondeur] [requetes]" << endl;
+		return 1;
+	}
+	string chemin = argc > 2 ? argv[2] : "/tmp/dico.sock";
+	size_t nbConnexions = argc > 3 ? stoul(argv[3]) : 4;
+	size_t profondeur = argc > 4 ? stoul(argv[4]) : 16;
+	size_t nbRequetes = argc > 5 ? stoul(argv[5]) : 200000;
+	if (nbConnexions == 0 || profondeur == 0 || nbRequetes == 0)
+	{
+		cerr << "ERREUR: il faut au moins une connexion, une requete en vol et une requete" << endl;
+		return 1;
+	}
+
+	try
+	{
+		vector<string> mots = lireMots(argv[1]);
+		vector<Resultat> resultats(nbConnexions);
+		vector<thread> fils;
+		atomic<bool> echec(false);
+		Horloge::time_point debut = Horloge::now();
+		for (size_t i = 0; i < nbConnexions; i++)
+		{
+			size_t part = nbRequetes / nbConnexions + (i < nbRequetes % nbConnexions ? 1 : 0);
+			fils.emplace_back([&, i, part]() {
+				try
+				{
+					charger(chemin, mots, profondeur, part, 12345 + i, resultats[i]);
+				}
+				catch (const exception& e)
+				{
+					cerr << "ERREUR: connexion " << i << ": " << e.what() << endl;
+					echec = true;
+				}
+			});
+		}
+		for (auto& f : fils) f.join();
+		double secondes = chrono::duration<double>(Horloge::now() - debut).count();
+		if (echec) return 1;
+
+		vector<double> latences;
+		size_t nbAbsents = 0, nbErreurs = 0;
+		for (const auto& r : resultats)
+		{
+			latences.insert(latences.end(), r.latences.begin(), r.latences.end());
+			nbAbsents += r.nbAbsents;
+			nbErreurs += r.nbErreurs;
+		}
+		sort(latences.begin(), latences.end());
+		cout << latences.size() << " requetes, " << nbConnexions << " connexions, profondeur " << profondeur << endl
+			 << "debit : " << size_t(latences.size() / secondes) << " requetes/s" << endl
+			 << "latence p50 : " << centile(latences, 0.50) << " us, p99 : " << centile(latences, 0.99)
+			 << " us, max : " << latences.back() << " us" << endl
+			 << "reponses ABSENT : " << nbAbsents << ", ERREUR : " << nbErreurs << endl;
+	}
+	catch (const exception& e)
+	{
+		cerr << "ERREUR: " << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
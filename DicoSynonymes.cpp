@@ -10,7 +10,18 @@
 */
 
 #include "DicoSynonymes.h"
+#include "DicoSynonymesDisque.h"
+#include "Tokeniseur.h"
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <future>
+#include <thread>
+#include <mutex>
 
 namespace TP3
 {
@@ -20,7 +31,8 @@ namespace TP3
       *\post      Une instance vide de la classe a été initialisée
       *
       */
-    DicoSynonymes::DicoSynonymes() : racine(nullptr), nbRadicaux(0){
+    DicoSynonymes::DicoSynonymes() : ressource(std::pmr::get_default_resource()), abandonnerNoeuds(false), racine(nullptr), nbRadicaux(0),
+        groupesSynonymes(ressource), paradigmes(ressource), indexRadicaux(ressource), expansionsAJour(false), grapheAJour(false), phrasesAJour(false), signaturesAJour(false), transducteurAJour(false), similitudeAJour(false), profilage(false){
     }
 
       /**
@@ -35,7 +47,8 @@ namespace TP3
       *\exception bad_alloc s'il n'y a pas assez de mémoire
       * Cette méthode appelle chargerDicoSynonyme !
       */
-    DicoSynonymes::DicoSynonymes(std::ifstream &fichier) : racine(nullptr), nbRadicaux(0){
+    DicoSynonymes::DicoSynonymes(std::ifstream &fichier) : ressource(std::pmr::get_default_resource()), abandonnerNoeuds(false), racine(nullptr),
+        nbRadicaux(0), groupesSynonymes(ressource), paradigmes(ressource), indexRadicaux(ressource), expansionsAJour(false), grapheAJour(false), phrasesAJour(false), signaturesAJour(false), transducteurAJour(false), similitudeAJour(false), profilage(false){
         try
         {
             chargerDicoSynonyme(fichier);
@@ -46,20 +59,29 @@ namespace TP3
         }
     }
 
+    DicoSynonymes::DicoSynonymes(std::pmr::memory_resource* ressource, bool abandonnerNoeuds) : ressource(ressource),
+        abandonnerNoeuds(abandonnerNoeuds), racine(nullptr), nbRadicaux(0), groupesSynonymes(ressource), paradigmes(ressource), indexRadicaux(ressource),
+        expansionsAJour(false), grapheAJour(false), phrasesAJour(false), signaturesAJour(false), transducteurAJour(false), similitudeAJour(false), profilage(false){
+    }
+
       /**
       * \brief Charge le dictionnaire de synonymes
       *
       * \pre p_fichier est ouvert
       *
       * \post Le dictionnaire est initialisé.
+      * \post Une flexion écrite flexion:codes (ex. grands:mp) est étiquetée avec les traits de ses codes,
+      *       voir TraitFlexion.
       *
       * \exception invalid_argument si p_fichier n'est pas ouvert
+      * \exception logic_error si un code de trait est inconnu
       *
       */
-	void DicoSynonymes::chargerDicoSynonyme(std::ifstream& fichier)
+	void DicoSynonymes::chargerDicoSynonyme(std::ifstream& fichier, bool synonymesALaDemande)
 	{
         if (!fichier.is_open())
             throw std::logic_error("DicoSynonymes::chargerDicoSynonyme: Le fichier n'est pas ouvert !");
+        _terminerSynonymesALaDemande(); // les groupes d'un chargement précédent gardent leurs numéros
 
 		std::string ligne;
 		std::string buffer;
@@ -70,6 +92,13 @@ namespace TP3
 		{
             std::getline(fichier, ligne);
 
+			if (ligne == "$" && synonymesALaDemande && !journal)
+			{
+				std::string section((std::istreambuf_iterator<char>(fichier)), std::istreambuf_iterator<char>());
+				_prelireSynonymes(section);
+				this->synonymesALaDemande.reset(new SynonymesALaDemande{std::string(), 0, 0, std::move(section), {}, {}});
+				return;
+			}
 			if (ligne == "$")
 			{
 				cat = 3;
@@ -84,23 +113,162 @@ namespace TP3
 			else if (cat == 2)
 			{
 				std::stringstream ss(ligne);
+				std::string forme;
+				Traits traits;
 				while (ss >> buffer)
-					ajouterFlexion(radical, buffer);
+				{
+					_analyserFlexion(buffer, forme, traits);
+					ajouterFlexion(radical, forme, traits);
+				}
 				cat = 1;
 			}
 			else
 			{
-				std::stringstream ss(ligne);
-				ss >> radical;
-				ss >> buffer;
-				int position = -1;
-				ajouterSynonyme(radical, buffer, position);
-				while (ss >> buffer)
-					ajouterSynonyme(radical, buffer, position);
+				_chargerSynonymes(ligne);
 			}
 		}
 	}
 
+     /**
+      * \brief Charge un fichier de dictionnaire en analysant ses radicaux sur plusieurs fils
+      *
+      * \exception runtime_error si le fichier ne peut pas être lu
+      * \exception logic_error si le fichier contient deux fois un radical ou une flexion d'un radical
+      */
+    void DicoSynonymes::chargerEnParallele(const std::string& chemin, unsigned int nbFils, bool synonymesALaDemande)
+    {
+        _terminerSynonymesALaDemande(); // les groupes d'un chargement précédent gardent leurs numéros
+        std::ifstream fichier(chemin, std::ios::binary);
+        if (!fichier) throw std::runtime_error("DicoSynonymes::chargerEnParallele: impossible d'ouvrir " + chemin);
+        std::string texte((std::istreambuf_iterator<char>(fichier)), std::istreambuf_iterator<char>());
+        if (fichier.bad()) throw std::runtime_error("DicoSynonymes::chargerEnParallele: erreur de lecture de " + chemin);
+
+        // Début de chaque ligne de la section des radicaux, puis la position qui suit le '\n' de la
+        // dernière (comme si le fichier se terminait par un '\n')
+        std::vector<std::size_t> lignes;
+        std::size_t synonymes = texte.size(); // début de la section des synonymes
+        std::size_t apresDerniere = 0;
+        for (std::size_t debut = 0; debut < texte.size(); )
+        {
+            std::size_t fin = std::min(texte.find('\n', debut), texte.size());
+            if (fin - debut == 1 && texte[debut] == '$')
+            {
+                synonymes = std::min(fin + 1, texte.size());
+                break;
+            }
+            lignes.push_back(debut);
+            debut = apresDerniere = fin + 1;
+        }
+        std::size_t nbLignes = lignes.size();
+        lignes.push_back(apresDerniere);
+
+        // Une tranche commence toujours sur une ligne de radical (rang pair)
+        if (nbFils == 0) nbFils = std::max(1u, std::thread::hardware_concurrency());
+        if (ressource != std::pmr::new_delete_resource()) nbFils = 1; // une autre ressource n'est en général pas synchronisée
+        std::size_t nbPaires = (nbLignes + 1) / 2;
+        nbFils = unsigned(std::max<std::size_t>(1, std::min<std::size_t>(nbFils, nbPaires)));
+        std::vector<std::future<std::vector<NoeudDicoSynonymes*> > > taches;
+        for (unsigned int i = 1; i < nbFils; i++)
+        {
+            std::size_t premiere = 2 * (nbPaires * i / nbFils), derniere = std::min(nbLignes, 2 * (nbPaires * (i + 1) / nbFils));
+            taches.push_back(std::async(std::launch::async, [this, &texte, &lignes, premiere, derniere]() {
+                return _analyserRadicaux(texte, lignes, premiere, derniere);
+            }));
+        }
+
+        // Chaque tranche donne une suite triée; les suites sont fusionnées deux à deux
+        std::vector<NoeudDicoSynonymes*> noeuds;
+        std::vector<std::size_t> suites(1, 0);
+        std::exception_ptr erreur;
+        try
+        {
+            noeuds = _analyserRadicaux(texte, lignes, 0, std::min(nbLignes, 2 * (nbPaires / nbFils)));
+        }
+        catch (...)
+        {
+            erreur = std::current_exception();
+        }
+        suites.push_back(noeuds.size());
+        for (auto& tache : taches) // toutes les tâches sont attendues, même après une erreur
+        {
+            try
+            {
+                std::vector<NoeudDicoSynonymes*> suite = tache.get();
+                noeuds.insert(noeuds.end(), suite.begin(), suite.end());
+                suites.push_back(noeuds.size());
+            }
+            catch (...)
+            {
+                if (!erreur) erreur = std::current_exception();
+            }
+        }
+        auto plusPetit = [](const NoeudDicoSynonymes* a, const NoeudDicoSynonymes* b) {
+            return _inferieur(a->radical, b->radical);
+        };
+        try
+        {
+            if (erreur) std::rethrow_exception(erreur);
+            while (suites.size() > 2)
+            {
+                std::vector<std::size_t> fusionnees(1, 0);
+                for (std::size_t i = 2; i < suites.size(); i += 2)
+                {
+                    std::inplace_merge(noeuds.begin() + suites[i - 2], noeuds.begin() + suites[i - 1],
+                                       noeuds.begin() + suites[i], plusPetit);
+                    fusionnees.push_back(suites[i]);
+                }
+                if (suites.size() % 2 == 0) fusionnees.push_back(suites.back()); // nombre impair de suites
+                suites.swap(fusionnees);
+            }
+            for (std::size_t i = 1; i < noeuds.size(); i++)
+            {
+                if (_egal(noeuds[i - 1]->radical, noeuds[i]->radical))
+                    throw std::logic_error("On ne peut pas avoir 2 fois le même radical dans le même arbre");
+            }
+        }
+        catch (...)
+        {
+            for (NoeudDicoSynonymes* noeud : noeuds) _detruireNoeud(noeud);
+            throw;
+        }
+
+        if (racine == nullptr)
+        {
+            racine = _construireEquilibre(noeuds, 0, noeuds.size());
+            for (NoeudDicoSynonymes* noeud : noeuds)
+            {
+                indexRadicaux.inserer(noeud->radical, noeud);
+            }
+            nbRadicaux = noeuds.size();
+            cacheRadicaux.vider();
+            _invaliderExpansions();
+            _invaliderGraphe();
+            _invaliderSimilitude();
+            arbreLecture.clear();
+            if (journal) compacterJournal(); // comme une fusion, le chargement ne se journalise pas radical par radical
+        }
+        else
+        {
+            DicoSynonymes lu(ressource);
+            lu.racine = _construireEquilibre(noeuds, 0, noeuds.size());
+            lu.nbRadicaux = noeuds.size();
+            fusionner(lu);
+        }
+
+        if (synonymesALaDemande && !journal)
+        {
+            _prelireSynonymes(std::string_view(texte).substr(synonymes));
+            this->synonymesALaDemande.reset(new SynonymesALaDemande{chemin, synonymes, texte.size(), std::string(), {}, {}});
+            return;
+        }
+        std::stringstream section(texte.substr(synonymes));
+        std::string ligne;
+        while (std::getline(section, ligne))
+        {
+            _chargerSynonymes(ligne);
+        }
+    }
+
       /**
       *\brief     Destructeur.
       *
@@ -108,7 +276,15 @@ namespace TP3
       *
       */
     DicoSynonymes::~DicoSynonymes(){
-        _auxDetruire(racine);
+        try
+        {
+            _attendreCompaction();
+        }
+        catch (const std::exception&)
+        {
+            // l'instantané précédent et le journal complet restent valides
+        }
+        if (!abandonnerNoeuds) _auxDetruire(racine);
     }
 
       /**
@@ -123,9 +299,11 @@ namespace TP3
       *\exception logic_error si le radical existe déjà.
       */
     void DicoSynonymes::ajouterRadical(const std::string& motRadical){
-          if (_rechercherRadical(racine,motRadical) != nullptr) // si le radical existe déja
+          _lireSynonymesALaDemande(); // la section gardée se relit sur l'arbre où elle a été vérifiée
+          if (_trouverNoeud(motRadical) != nullptr) // si le radical existe déja
               throw std::logic_error("On ne peut pas avoir 2 fois le même radical dans le même arbre");
           _insererAVL(racine, motRadical);
+          _journaliser(JournalDicoSynonymes::AJOUTER_RADICAL, motRadical);
       }
 
       /**
@@ -135,15 +313,22 @@ namespace TP3
       *
       *\post   La flexion est ajoutée au dictionnaire des synonymes.
       *
+      *\post   Si traits n'est pas 0, la flexion est étiquetée avec ces traits.
+      *
       *\exception bad_alloc si il n'y a pas suffisament de mémoire.
       *\exception logic_error si motFlexion existe déjà ou motRadical n'existe pas.
       */
-    void DicoSynonymes::ajouterFlexion(const std::string& motRadical, const std::string& motFlexion){
-          NoeudDicoSynonymes* noeud = _rechercherRadical(racine, motRadical);
+    void DicoSynonymes::ajouterFlexion(const std::string& motRadical, const std::string& motFlexion, Traits traits){
+          _lireSynonymesALaDemande();
+          NoeudDicoSynonymes* noeud = _trouverNoeud(motRadical);
           if (noeud == nullptr) throw std::logic_error("Ce radical n'existe pas dans l'arbre"); // si le radical n'existe pas
-          auto itr = std::find(noeud->flexions.begin(), noeud->flexions.end(), motFlexion);
+          auto itr = noeud->flexions.trouver(std::string_view(motFlexion));
           if (itr != noeud->flexions.end()) throw std::logic_error("On ne peut pas avoir 2 fois la même flexion"); // si la flexion existe déja
-          noeud->flexions.push_back(motFlexion); // on ajoute la flexion
+          noeud->flexions.push_back(std::string_view(motFlexion)); // on ajoute la flexion
+          if (traits != 0) _etiqueter(noeud, motFlexion, traits);
+          cacheRadicaux.invalider(motFlexion); // motFlexion peut maintenant se résoudre vers ce radical
+          _marquerExpansions(motRadical, motFlexion);
+          _journaliser(JournalDicoSynonymes::AJOUTER_FLEXION, motRadical, motFlexion, int(traits)); // les traits voyagent dans le numéro de groupe
     }
 
       /**
@@ -156,44 +341,58 @@ namespace TP3
       *\post   Le synonyme est ajouté au dictionnaire des synonymes
       *\       Si numGroupe vaut –1, le synonyme est ajouté dans un nouveau groupe de synonymes
       *\       et retourne le numéro de ce nouveau groupe dans numgroupe par référence.
+      *\       Si un autre radical a déjà mis motSynonyme dans ce groupe, le groupe, qui ne garde
+      *\       qu'une fois chaque mot, est inchangé; le radical en prend tout de même le sens.
       *
       *\exception bad_alloc si il n'y a pas suffisament de mémoire
       *\exception logic_error si motSynonyme est déjà dans la liste des synonymes du motRadical
       *\exception logic_error si numGroupe n'est pas correct ou motRadical n'existe pas.
       */
     void DicoSynonymes::ajouterSynonyme(const std::string& motRadical, const std::string& motSynonyme, int& numGroupe) {
+          _lireSynonymesALaDemande();
+          _ajouterSynonyme(motRadical, motSynonyme, numGroupe);
+      }
+
+     /**
+      * \brief Ajoute un synonyme sans lire d'abord les synonymes à la demande (ajouterSynonyme, pendant leur lecture)
+      */
+    void DicoSynonymes::_ajouterSynonyme(const std::string& motRadical, const std::string& motSynonyme, int& numGroupe)
+    {
+          int numGroupeDemande = numGroupe; // on journalise la demande, pas le numéro attribué
           if (_rechercherRadical(racine,motSynonyme) != nullptr) _insererAVL(racine, motSynonyme);
-          NoeudDicoSynonymes* noeud = _rechercherRadical(racine, motRadical);
+          NoeudDicoSynonymes* noeud = _trouverNoeud(motRadical);
           if (noeud == nullptr) // si le radical n'existe pas
           {
               throw std::logic_error("Le radical n'existe pas dans l'arbre");
           }
+          std::uint32_t idSynonyme = groupesSynonymes.identifiant(motSynonyme);
           for (const auto& groupeSyn : noeud->appSynonymes)
           {
-              for (const auto& synonyme : groupesSynonymes[groupeSyn])
+              if (groupesSynonymes.contient(groupeSyn, idSynonyme)) // si on trouve le synonyme qu'on veut ajouter
               {
-                  if (synonyme->radical == motSynonyme) // si on trouve le synonyme qu'on veut ajouter
-                  {
-                      throw std::logic_error("Le synonyme existe déjà dans ce groupe");
-                  }
+                  throw std::logic_error("Le synonyme existe déjà dans ce groupe");
               }
           }
           if (numGroupe == -1) // si le groupe n'existe pas
           {
-              numGroupe = groupesSynonymes.size();
-              groupesSynonymes.push_back(std::list<NoeudDicoSynonymes*>());
+              numGroupe = groupesSynonymes.creerGroupe();
           }
-          else if (numGroupe < 0 || numGroupe >= groupesSynonymes.size()) // le numéro du groupe est invalide
+          else if (numGroupe < 0 || numGroupe >= groupesSynonymes.nombreGroupes()) // le numéro du groupe est invalide
           {
               throw std::logic_error("Le numéro du groupe n'est pas correct");
           }
           auto itr = std::find(noeud->appSynonymes.begin(), noeud->appSynonymes.end(), numGroupe); // on trouve le groupe
-          if (itr == noeud->appSynonymes.end())
+          bool nouveauSens = itr == noeud->appSynonymes.end();
+          if (nouveauSens)
           {
               noeud->appSynonymes.push_back(numGroupe);
           }
           _insererAVL(racine, motSynonyme);
-          groupesSynonymes[numGroupe].push_back(new NoeudDicoSynonymes(motSynonyme));
+          bool nouveauMembre = groupesSynonymes.ajouter(numGroupe, idSynonyme); // false : un autre radical l'y a déjà mis
+          _marquerExpansions(motRadical, "", numGroupe);
+          if (nouveauSens) _modifierGraphe(numGroupe, motRadical, true); // le radical devient membre du groupe
+          if (nouveauMembre) _modifierGraphe(numGroupe, motSynonyme, true);
+          _journaliser(JournalDicoSynonymes::AJOUTER_SYNONYME, motRadical, motSynonyme, numGroupeDemande);
       }
 
       /**
@@ -211,16 +410,27 @@ namespace TP3
       *\exception logic_error si l'arbre est vide ou motRadical n'existe pas.
       */
     void DicoSynonymes::supprimerRadical(const std::string& motRadical){
+          _lireSynonymesALaDemande();
           if (racine == nullptr) // arbre vide
           {
               throw std::logic_error("L'arbre est vide, on ne peut pas supprimer de radical");
           }
-          NoeudDicoSynonymes* noeud = _rechercherRadical(racine, motRadical);
+          NoeudDicoSynonymes* noeud = _trouverNoeud(motRadical);
           if (noeud == nullptr) // radical n'existe pas
           {
               throw std::logic_error("Le radical que l'on veut supprimer n'existe pas dans l'arbre");
           }
+          for (const auto& flexion : noeud->flexions) // seules ses flexions peuvent se résoudre vers lui
+          {
+              cacheRadicaux.invalider(std::string(flexion));
+              _marquerExpansions(motRadical, std::string(flexion));
+          }
+          _marquerExpansions(motRadical);
+          _invaliderGraphe();
+          _invaliderSimilitude();
+          arbreLecture.clear();
           _auxSupprimerAVL(racine, motRadical);
+          _journaliser(JournalDicoSynonymes::SUPPRIMER_RADICAL, motRadical);
     }
 
       /**
@@ -235,21 +445,26 @@ namespace TP3
       *\exception motFlexion n'existe pas ou motRadical n'existe pas.
       */
     void DicoSynonymes::supprimerFlexion(const std::string& motRadical, const std::string& motFlexion){
+          _lireSynonymesALaDemande();
           if (racine == nullptr) // si arbre est vide
           {
               throw std::logic_error("L'arbre est vide, on ne peut pas effacer de flexion");
           }
-          NoeudDicoSynonymes* noeud = _rechercherRadical(racine, motRadical);
+          NoeudDicoSynonymes* noeud = _trouverNoeud(motRadical);
           if (noeud == nullptr) // si le radical n'existe pas
           {
               throw std::logic_error("Le radical n'existe pas dans l'arbre");
           }
-          auto itr = std::find(noeud->flexions.begin(), noeud->flexions.end(), motFlexion);
+          auto itr = noeud->flexions.trouver(std::string_view(motFlexion));
           if (itr == noeud->flexions.end()) // si la flexion n'existe pas
           {
               throw std::logic_error("La flexion n'existe pas");
           }
           noeud->flexions.erase(itr);
+          _retirerEtiquette(noeud, motFlexion);
+          cacheRadicaux.invalider(motFlexion);
+          _marquerExpansions(motRadical, motFlexion);
+          _journaliser(JournalDicoSynonymes::SUPPRIMER_FLEXION, motRadical, motFlexion);
     }
 
       /**
@@ -263,38 +478,32 @@ namespace TP3
       *\exception logic_error si motSynonyme ou motRadical ou numGroupe n'existent pas.
       */
     void DicoSynonymes::supprimerSynonyme(const std::string& motRadical, const std::string& motSynonyme, int& numGroupe){
-          NoeudDicoSynonymes* noeud = _rechercherRadical(racine, motRadical);
+          _lireSynonymesALaDemande();
+          NoeudDicoSynonymes* noeud = _trouverNoeud(motRadical);
           if (noeud == nullptr) // si le radical n'existe pas
           {
               throw std::logic_error("Le radical n'existe pas dans l'arbre");
           }
-          if (numGroupe < 0 || numGroupe >= groupesSynonymes.size()) // si le numero de groupe est invalide
+          if (numGroupe < 0 || numGroupe >= groupesSynonymes.nombreGroupes()) // si le numero de groupe est invalide
           {
               throw std::logic_error("Le numéro du groupe n'est pas correct");
           }
-          auto& groupeSyn = groupesSynonymes[numGroupe];
-          auto itr = groupeSyn.end();
-          for (auto itr2 = groupeSyn.begin(); itr2 != groupeSyn.end(); ++itr2)
-          {
-              if ((*itr2)->radical == motSynonyme)
-              {
-                  itr = itr2;
-                  break; // on arrête la boucle lorsque le synonyme est trouvé
-              }
-          }
-          if (itr == groupeSyn.end()) // si on a pas trouvé le synonyme, l'iterateur sera == end
+          if (!groupesSynonymes.retirer(numGroupe, motSynonyme)) // si on a pas trouvé le synonyme
           {
               throw std::logic_error("supprimerSynonyme: Le motSynonyme n'existe pas");
           }
-          groupeSyn.erase(itr);
+          _marquerExpansions(motRadical, "", numGroupe);
+          _modifierGraphe(numGroupe, motSynonyme, false);
 
-          if (groupeSyn.empty())
+          if (groupesSynonymes.membres(numGroupe).empty())
           {
-              groupesSynonymes.erase(groupesSynonymes.begin() + numGroupe);
+              _invaliderExpansions(); // les groupes suivants changent de numéro
+              _invaliderGraphe();
+              groupesSynonymes.effacerGroupe(numGroupe);
 
               for (NoeudDicoSynonymes* Noeud : parcourArbre()) // on parcours tous les noeuds de l'arbre
               {
-                  std::vector<int>& synonymes = Noeud->appSynonymes;
+                  std::pmr::vector<int>& synonymes = Noeud->appSynonymes;
                   auto itr3 = std::remove(synonymes.begin(), synonymes.end(), numGroupe);
                   synonymes.erase(itr3, synonymes.end());
                   for (int& groupeSynonyme : synonymes)
@@ -306,6 +515,7 @@ namespace TP3
                   }
               }
           }
+          _journaliser(JournalDicoSynonymes::SUPPRIMER_SYNONYME, motRadical, motSynonyme, numGroupe);
       }
 
 
@@ -329,6 +539,93 @@ namespace TP3
         return nbRadicaux;
     }
 
+    /**
+     * \brief Compte les radicaux plus petits que mot en descendant de la racine
+     * \return le nombre de radicaux plus petits que mot
+     */
+    int DicoSynonymes::rang(const std::string& mot) const
+    {
+        int plusPetits = 0;
+        for (const NoeudDicoSynonymes* noeud = racine; noeud != nullptr; )
+        {
+            if (_inferieur(noeud->radical, mot)) // noeud et tout son sous-arbre gauche sont avant mot
+            {
+                plusPetits += _taille(noeud->gauche) + 1;
+                noeud = noeud->droit;
+            }
+            else
+            {
+                noeud = noeud->gauche;
+            }
+        }
+        return plusPetits;
+    }
+
+    /**
+     * \brief Trouve le radical de position k grâce aux tailles des sous-arbres
+     * \exception logic_error si la position n'existe pas
+     */
+    std::string DicoSynonymes::kieme(int k) const
+    {
+        if (k < 0 || k >= nbRadicaux) throw std::logic_error("DicoSynonymes::kieme: la position n'existe pas");
+        const NoeudDicoSynonymes* noeud = racine;
+        while (k != _taille(noeud->gauche))
+        {
+            if (k < _taille(noeud->gauche))
+            {
+                noeud = noeud->gauche;
+            }
+            else
+            {
+                k -= _taille(noeud->gauche) + 1;
+                noeud = noeud->droit;
+            }
+        }
+        return std::string(noeud->radical);
+    }
+
+    /**
+     * \brief Descend jusqu'au radical de position debut, en gardant les ancêtres qui le suivent,
+     *        puis continue le parcours en ordre à partir de là
+     * \exception logic_error si debut ou nombre est négatif
+     */
+    std::vector<std::string> DicoSynonymes::page(int debut, int nombre) const
+    {
+        if (debut < 0 || nombre < 0) throw std::logic_error("DicoSynonymes::page: debut et nombre doivent être positifs");
+        std::vector<std::string> radicaux;
+        if (debut >= nbRadicaux || nombre == 0) return radicaux;
+        radicaux.reserve(std::min(nombre, nbRadicaux - debut));
+        std::vector<const NoeudDicoSynonymes*> pile; // ancêtres pas encore visités, le prochain au sommet
+        const NoeudDicoSynonymes* noeud = racine;
+        int k = debut;
+        while (noeud != nullptr)
+        {
+            if (k < _taille(noeud->gauche))
+            {
+                pile.push_back(noeud);
+                noeud = noeud->gauche;
+            }
+            else if (k == _taille(noeud->gauche))
+            {
+                pile.push_back(noeud);
+                break;
+            }
+            else
+            {
+                k -= _taille(noeud->gauche) + 1;
+                noeud = noeud->droit;
+            }
+        }
+        while (!pile.empty() && int(radicaux.size()) < nombre)
+        {
+            noeud = pile.back();
+            pile.pop_back();
+            radicaux.emplace_back(noeud->radical);
+            for (noeud = noeud->droit; noeud != nullptr; noeud = noeud->gauche) pile.push_back(noeud);
+        }
+        return radicaux;
+    }
+
      /**
       * \brief Retourne le radical du mot entré en paramètre
       *
@@ -347,29 +644,12 @@ namespace TP3
         {
             throw std::logic_error("L'arbre est vide");
         }
-        float SimilitudePlusElevee = 0;
-        std::vector<NoeudDicoSynonymes*> vecteurnoeuds = parcourArbre(); // vecteur de tous les noeuds de l'arbre
-        NoeudDicoSynonymes* Noeudchoisi = nullptr; // initialise le noeud qui sera choisi
-        for (NoeudDicoSynonymes* noeud : vecteurnoeuds) // on parcours le vecteur de noeuds
-        {
-            for (const auto& flexion : noeud->flexions)
-            {
-                if (flexion == mot) // si la flexion est celle qu'on cherche
-                {
-                    float similitudetemp = similitude(noeud->radical, mot); //on calcule le degré de similitude
-                    if (similitudetemp > SimilitudePlusElevee) // si la nouvelle similitude est plus grande
-                    {
-                        SimilitudePlusElevee = similitudetemp;
-                        Noeudchoisi = noeud;
-                    }
-                }
-            }
-        }
-        if (Noeudchoisi == nullptr)
+        std::string radical;
+        if (!_resoudreRadical(mot, radical))
         {
             throw std::logic_error("La flexion n'existe pas pour ce radical");
         }
-        return Noeudchoisi->radical;
+        return radical;
     }
 
 
@@ -421,7 +701,8 @@ namespace TP3
       *
       */
     int DicoSynonymes::getNombreSens(std::string radical) const{
-         NoeudDicoSynonymes* noeud = _rechercherRadical(racine, radical);
+         _lireSynonymesALaDemande();
+         NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
          if (noeud == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
          return noeud->appSynonymes.size();
     }
@@ -435,14 +716,15 @@ namespace TP3
       * \exception logic_error si le numéro de groupe de synonme n'est pas correct ou si celui-ci est vide
       */
     std::string DicoSynonymes::getSens(std::string radical, int position) const{
-         NoeudDicoSynonymes* noeud = _rechercherRadical(racine, radical);
+         _lireSynonymesALaDemande();
+         NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
          if (noeud == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
          if (position < 0 || position >= noeud->appSynonymes.size()) throw std::logic_error("La position n'existe pas");
          int groupNumber = noeud->appSynonymes[position];
-         if (groupNumber < 0 || groupNumber >= groupesSynonymes.size()) throw std::logic_error("Le numéro du groupe n'est pas correct");
-         auto& groupeSyn = groupesSynonymes[groupNumber];
+         if (groupNumber < 0 || groupNumber >= groupesSynonymes.nombreGroupes()) throw std::logic_error("Le numéro du groupe n'est pas correct");
+         auto& groupeSyn = groupesSynonymes.membres(groupNumber);
          if (groupeSyn.empty()) throw std::logic_error("Le groupe de synonymes est vide");
-         return groupeSyn.front()->radical;
+         return std::string(groupesSynonymes.mot(groupeSyn.front()));
      }
 
      /**
@@ -454,16 +736,18 @@ namespace TP3
       * \exception logic_error si le numéro de groupe de synonme n'est pas correct
       */
     std::vector<std::string> DicoSynonymes::getSynonymes(std::string radical, int position) const{
-         NoeudDicoSynonymes* noeud = _rechercherRadical(racine, radical);
+         _lireSynonymesALaDemande();
+         NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
          if (noeud == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
          if (position < 0 || position >= noeud->appSynonymes.size()) throw std::logic_error("La position n'existe pas");
          int groupNumber = noeud->appSynonymes[position];
-         if (groupNumber < 0 || groupNumber >= groupesSynonymes.size()) throw std::logic_error("Le numéro du groupe n'est  pas correct");
+         if (groupNumber < 0 || groupNumber >= groupesSynonymes.nombreGroupes()) throw std::logic_error("Le numéro du groupe n'est  pas correct");
          std::vector<std::string> Vecteursynonymes;
-         auto& groupeSyn = groupesSynonymes[groupNumber];
+         auto& groupeSyn = groupesSynonymes.membres(groupNumber);
+         Vecteursynonymes.reserve(groupeSyn.size());
          for (auto synonyme : groupeSyn) // on parcours les synonymes du groupe
          {
-             Vecteursynonymes.push_back(synonyme->radical);
+             Vecteursynonymes.emplace_back(groupesSynonymes.mot(synonyme));
          }
          return Vecteursynonymes;
     }
@@ -477,246 +761,1756 @@ namespace TP3
       */
     std::vector<std::string> DicoSynonymes::getFlexions(std::string radical) const
     {
-        std::vector<std::string> flexions;
-        NoeudDicoSynonymes* noeud = _rechercherRadical(racine, radical);
+        NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
         if (noeud == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
-        for (const auto& flexion : noeud->flexions) // on parcours les flexions du radical
+        std::vector<std::string> flexions(noeud->flexions.size());
+        for (std::size_t i = 0; i < flexions.size(); i++) // chaque forme est écrite directement à sa place
         {
-            flexions.push_back(flexion);
+            noeud->flexions.forme(i, flexions[i]);
         }
         return flexions;
     }
 
      /**
-	  * \brief Indique si l'arbre est équilibré selon le facteur HB(1)
-	  *
-	  * \post L'arbre est inchangé
-	  * \return bool indiquant si l'arbre est AVL
+      * \brief Comme rechercherRadical, sans exception : donne le radical de mot, s'il en a un
       *
-	  */
-    bool DicoSynonymes::estArbreAVL() const{
-         if (this->estVide()) return true;
-         std::queue<NoeudDicoSynonymes*> file;
-         NoeudDicoSynonymes * Noeud;
-         file.push(racine);
-         while (!file.empty())
-         {
-             Noeud = file.front();
-             if (_amplitudeDuDebalancement(Noeud) > 1) // si l'arbre n'est pas équilibré
-             {
-                 return false;
-             }
-             file.pop();
-             if (Noeud->gauche != nullptr) // si il  y a un autre noeud à gauche
-             {
-                 file.push(Noeud->gauche);
-             }
-             if (Noeud->droit != nullptr) // si il y a un autre noeud à droite
-             {
-                 file.push(Noeud->droit);
-             }
-         }
-         return true;
-     }
-
-	// Mettez l'implantation des autres méthodes (surtout privées) ici.
-
-    /**
-     * \brief Insère un radical dans l'arbre
-     * \param[in] noeud le noeud où l'on veut insérer
-     * \param[in] Radical le radical que l'on veut insérer
-     */
-    void DicoSynonymes::_insererAVL(NoeudDicoSynonymes*& noeud, const std::string& Radical)
+      * \post Le dictionnaire reste inchangé.
+      * \return le radical, ou std::nullopt si l'arbre est vide ou si mot n'est la flexion d'aucun radical
+      */
+    std::optional<std::string> DicoSynonymes::essayerRechercherRadical(const std::string& mot) const
     {
-        if (_rechercherRadical(racine,Radical) != nullptr) return; // si le radical existe déja on sort
-        if (noeud == nullptr)
-        {
-            noeud = new NoeudDicoSynonymes(Radical);
-            nbRadicaux++;
-            return;
-        }
-        else if (Radical < noeud->radical) // plus petit donc insertion à gauche
-        {
-            _insererAVL(noeud->gauche, Radical);
-        }
-        else if (Radical >= noeud->radical) // plus grand donc on insert à droite
-        {
-            _insererAVL(noeud->droit, Radical);
-        }
-        _miseAJourHauteurNoeud(noeud);
-        _balancerUnNoeud(noeud); // on garde les hauteurs et l'arbre balancé
+        std::string radical;
+        if (racine == nullptr || !_resoudreRadical(mot, radical)) return std::nullopt;
+        return radical;
     }
 
-    /**
-     * \brief Met à jour la hauteur d'un noeud pour que celle-ci soit toujours valide
-     * \param[in] noeud le noeud dont on veut mettre à jour la hauteur
-     */
-    void DicoSynonymes::_miseAJourHauteurNoeud(NoeudDicoSynonymes*& noeud)
+     /**
+      * \brief Comme getNombreSens, sans exception
+      * \return le nombre de sens, ou std::nullopt si le radical n'existe pas
+      */
+    std::optional<int> DicoSynonymes::essayerNombreSens(const std::string& radical) const
     {
-        if (noeud != nullptr) {
-            noeud->hauteur = 1 + std::max(_hauteur(noeud->droit), _hauteur(noeud->gauche));
-        }
+        _lireSynonymesALaDemande();
+        const NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
+        if (noeud == nullptr) return std::nullopt;
+        return int(noeud->appSynonymes.size());
     }
 
-    /**
-     * \brief Effectue les balancement nécéssaire d'un noeud pour que l'arbre reste équilibré
-     * \param[in] noeud le noeud que l'on veut balancer
-     */
-    void DicoSynonymes::_balancerUnNoeud(NoeudDicoSynonymes*& noeud)
+     /**
+      * \brief Choisit le sens du radical dont la signature partage le plus de bits avec celle du contexte
+      * \return la position du sens, ou -1 si le radical n'existe pas ou n'a aucun sens
+      */
+    int DicoSynonymes::choisirSens(const std::string& radical, const std::vector<std::string>& contexte) const
     {
-        if (noeud == nullptr) return;
-        if (_debalancementAGauche(noeud))
+        _lireSynonymesALaDemande();
+        const NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
+        if (noeud == nullptr || noeud->appSynonymes.empty()) return -1;
+        Signature signatureContexte{};
+        for (const auto& mot : contexte) _marquerSignature(signatureContexte, mot);
+        std::lock_guard<std::mutex> garde(verrouSignatures);
+        if (!signaturesAJour) _calculerSignatures();
+        int choisi = 0, meilleurScore = -1;
+        for (std::size_t position = 0; position < noeud->appSynonymes.size(); position++)
         {
-            if (_sousArbrePencheADroite(noeud->gauche)) // gauche -> droite = zig zag gauche
+            int numGroupe = noeud->appSynonymes[position];
+            if (numGroupe < 0 || numGroupe >= int(signaturesGroupes.size())) continue;
+            const Signature& signature = signaturesGroupes[numGroupe];
+            int score = 0;
+            for (std::size_t i = 0; i < signature.size(); i++) // 8 popcnt, sans branchement
             {
-                _zigZagGauche(noeud);
+                score += __builtin_popcountll(signature[i] & signatureContexte[i]);
             }
-            else // gauche -> gauche = zig zig gauche
+            if (score > meilleurScore)
             {
-                _zigZigGauche(noeud);
+                meilleurScore = score;
+                choisi = int(position);
             }
         }
-        else if (_debalancementADroite(noeud))
-        {
-            if (_sousArbrePencheAGauche(noeud->droit)) // droite -> gauche = zig zag droit
-            {
-                _zigZagDroite(noeud);
-            }
-            else // droite -> droite = zig zig droit
-            {
-                _zigZigDroite(noeud);
-            }
-       }
+        return choisi;
     }
 
-    /**
-     * \brief donne la hauteur d'un noeud de l'abre
-     * \param[in] noeud le noeud dont on cherche la hauteur
-     * \return int la hauteur du noeud
-     */
-    int DicoSynonymes::_hauteur(NoeudDicoSynonymes* noeud) const
+     /**
+      * \brief Comme getSens, sans exception
+      * \return le premier synonyme du sens, ou std::nullopt si le radical, la position ou le groupe n'est pas valide
+      */
+    std::optional<std::string> DicoSynonymes::essayerSens(const std::string& radical, int position) const
     {
-        if (noeud == nullptr) return -1; // si l'arbre est vide, on met -1 comme valeur de hauteur par défaut
-        return noeud->hauteur;
+        _lireSynonymesALaDemande();
+        const std::pmr::vector<std::uint32_t>* groupeSyn = _groupeDuSens(_trouverNoeud(radical), position);
+        if (groupeSyn == nullptr || groupeSyn->empty()) return std::nullopt;
+        return std::string(groupesSynonymes.mot(groupeSyn->front()));
     }
 
-    /**
-     * \brief vérifie si l'arbre est débalancer vers la gauche
-     * \param[in] Arbre l'arbre dont on veut avoir le status de stabilité
-     * \return bool true si l'arbre est débalancer vers la gauche, false sinon
-     */
-    bool DicoSynonymes::_debalancementAGauche(NoeudDicoSynonymes * & Arbre) const
+     /**
+      * \brief Comme getSynonymes, sans exception
+      * \return les synonymes du sens, ou std::nullopt si le radical, la position ou le groupe n'est pas valide
+      */
+    std::optional<std::vector<std::string> > DicoSynonymes::essayerSynonymes(const std::string& radical, int position) const
     {
-        if (Arbre == nullptr) return false;
-        return (_hauteur(Arbre->gauche) - _hauteur(Arbre->droit)) >= 2;
+        _lireSynonymesALaDemande();
+        const std::pmr::vector<std::uint32_t>* groupeSyn = _groupeDuSens(_trouverNoeud(radical), position);
+        if (groupeSyn == nullptr) return std::nullopt;
+        std::vector<std::string> synonymes;
+        synonymes.reserve(groupeSyn->size());
+        for (const auto synonyme : *groupeSyn)
+        {
+            synonymes.emplace_back(groupesSynonymes.mot(synonyme));
+        }
+        return synonymes;
     }
 
-    /**
-     * \brief vérifie si l'arbre est débalancer vers la droite
-     * \param[in] Arbre l'arbre dont on veut avoir le status de stabilité
-     * \return bool true si l'arbre est débalancer vers la droite, false sinon
-     */
-    bool DicoSynonymes::_debalancementADroite(NoeudDicoSynonymes * & Arbre) const
+     /**
+      * \brief Comme getFlexions, sans exception
+      * \return les flexions, ou std::nullopt si le radical n'existe pas
+      */
+    std::optional<std::vector<std::string> > DicoSynonymes::essayerFlexions(const std::string& radical) const
     {
-        if (Arbre == nullptr) return false;
-        return (_hauteur(Arbre->droit) - _hauteur(Arbre->gauche)) >= 2;
+        const NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
+        if (noeud == nullptr) return std::nullopt;
+        std::vector<std::string> flexions(noeud->flexions.size());
+        for (std::size_t i = 0; i < flexions.size(); i++) noeud->flexions.forme(i, flexions[i]);
+        return flexions;
     }
 
-    /**
-     * \brief vérifie si un sous arbre penche vers la gauche
-     * \param[in] sousArbre le sous arbre que l'on veut vérifier
-     * \return bool true si le sous arbre penche vers la gauche, false sinon
-     */
-    bool DicoSynonymes::_sousArbrePencheAGauche(NoeudDicoSynonymes * & sousArbre) const
+     /**
+      * \brief Donne l'expansion d'une flexion : son radical et les formes qui peuvent la remplacer, par sens
+      *
+      * \post La table des expansions est construite au premier appel, puis seules les entrées touchées
+      *       par les modifications depuis l'appel précédent sont recalculées.
+      *
+      * \return l'expansion, valide jusqu'à la prochaine modification du dictionnaire,
+      *         ou nullptr si mot n'est la flexion d'aucun radical
+      */
+    const DicoSynonymes::Expansion* DicoSynonymes::expansion(const std::string& mot) const
     {
-        if (sousArbre == nullptr) return false;
-        return (_hauteur(sousArbre->gauche) > _hauteur(sousArbre->droit));
+        _lireSynonymesALaDemande();
+        std::lock_guard<std::mutex> garde(verrouExpansions);
+        if (!expansionsAJour) _reconstruireExpansions();
+        else if (!flexionsSales.empty() || !radicauxSales.empty()) _mettreAJourExpansions();
+        auto itr = expansionsParFlexion.find(mot);
+        return itr == expansionsParFlexion.end() ? nullptr : itr->second;
+    }
+
+     /**
+      * \brief Lit le numéro du radical d'une flexion dans le transducteur, en le construisant s'il n'est pas à jour
+      * \return le numéro du radical, ou -1 si mot n'est la flexion d'aucun radical
+      */
+    int DicoSynonymes::numeroRadical(std::string_view mot) const
+    {
+        std::lock_guard<std::mutex> garde(verrouTransducteur);
+        if (!transducteurAJour)
+        {
+            transducteurFlexions.construire(_meilleursRadicaux(parcourArbre()));
+            transducteurAJour = true;
+        }
+        std::uint32_t numero = transducteurFlexions.trouver(mot);
+        return numero == TransducteurFlexions::AUCUN ? -1 : int(numero);
+    }
+
+     /**
+      * \brief Découpe un texte en segments : d'abord les expressions de plusieurs mots, puis les mots seuls
+      */
+    std::vector<DicoSynonymes::Segment> DicoSynonymes::decouper(const std::string& texte) const
+    {
+        std::vector<Jeton> jetons = tokeniser(texte);
+        std::vector<std::string> mots;
+        mots.reserve(jetons.size());
+        for (const Jeton& jeton : jetons)
+        {
+            mots.emplace_back(texte, jeton.debut, jeton.longueur);
+            normaliser(mots.back());
+        }
+        std::vector<AutomatePhrases::Correspondance> phrases;
+        {
+            std::lock_guard<std::mutex> garde(verrouPhrases);
+            if (!phrasesAJour)
+            {
+                automatePhrases.vider();
+                for (const NoeudDicoSynonymes* noeud : parcourArbre())
+                {
+                    for (const auto& flexion : noeud->flexions)
+                    {
+                        if (flexion.find('_') != std::pmr::string::npos) automatePhrases.ajouter(std::string(flexion));
+                    }
+                }
+                automatePhrases.construire();
+                phrasesAJour = true;
+            }
+            automatePhrases.rechercher(mots, phrases);
+        }
+        std::vector<Segment> segments;
+        segments.reserve(mots.size());
+        auto phrase = phrases.begin();
+        for (std::size_t i = 0; i < mots.size(); )
+        {
+            if (phrase == phrases.end() || phrase->premier != i)
+            {
+                segments.push_back(Segment{jetons[i].debut, jetons[i].longueur, std::move(mots[i])});
+                i++;
+                continue;
+            }
+            std::size_t dernier = i + phrase->nbMots - 1;
+            Segment segment{jetons[i].debut, jetons[dernier].debut + jetons[dernier].longueur - jetons[i].debut, std::move(mots[i])};
+            for (std::size_t j = i + 1; j <= dernier; j++)
+            {
+                segment.cle += '_';
+                segment.cle += mots[j];
+            }
+            segments.push_back(std::move(segment));
+            i = dernier + 1;
+            ++phrase;
+        }
+        return segments;
+    }
+
+     /**
+      * \brief Remplace chaque mot ou expression connus du texte par une forme du sens choisi d'après ses voisins
+      */
+    std::string DicoSynonymes::transformer(const std::string& texte) const
+    {
+        const std::size_t VOISINS = 5; // Mots du contexte de chaque côté.
+        std::string resultat;
+        resultat.reserve(texte.size());
+        std::size_t finPrecedent = 0;
+        std::vector<Segment> segments = decouper(texte);
+        std::vector<std::string> contexte;
+        for (std::size_t i = 0; i < segments.size(); i++)
+        {
+            const Segment& segment = segments[i];
+            resultat.append(texte, finPrecedent, segment.debut - finPrecedent);
+            finPrecedent = segment.debut + segment.longueur;
+            const Expansion* expansion = this->expansion(segment.cle);
+            if (expansion == nullptr || expansion->sens.empty())
+            {
+                resultat.append(texte, segment.debut, segment.longueur);
+                continue;
+            }
+            std::size_t sens = 0;
+            if (expansion->sens.size() > 1)
+            {
+                contexte.clear();
+                for (std::size_t j = i >= VOISINS ? i - VOISINS : 0; j < std::min(segments.size(), i + VOISINS + 1); j++)
+                {
+                    if (j != i) contexte.push_back(segments[j].cle);
+                }
+                int choix = choisirSens(expansion->radical, contexte);
+                if (choix > 0 && expansion->debutSens[choix] != expansion->debutSens[choix + 1]) sens = choix;
+            }
+            if (expansion->debutSens[sens] == expansion->debutSens[sens + 1])
+            {
+                resultat.append(texte, segment.debut, segment.longueur);
+                continue;
+            }
+            Traits traits = getTraits(expansion->radical, segment.cle);
+            const Candidat* choisi = &expansion->candidats[expansion->debutSens[sens]];
+            for (unsigned int k = expansion->debutSens[sens]; traits != 0 && k < expansion->debutSens[sens + 1]; k++)
+            {
+                if (expansion->candidats[k].traits == traits)
+                {
+                    choisi = &expansion->candidats[k];
+                    break;
+                }
+            }
+            std::size_t debutForme = resultat.size();
+            resultat += choisi->forme;
+            std::replace(resultat.begin() + debutForme, resultat.end(), '_', ' '); // une expression s'écrit avec des espaces
+        }
+        resultat.append(texte, finPrecedent, std::string::npos);
+        return resultat;
+    }
+
+     /**
+      * \brief Donne les traits d'une flexion d'un radical
+      *
+      * \return les traits, 0 si la flexion n'est pas étiquetée
+      * \exception logic_error si le radical ou la flexion n'existe pas
+      */
+    DicoSynonymes::Traits DicoSynonymes::getTraits(const std::string& radical, const std::string& flexion) const
+    {
+        const NoeudDicoSynonymes* noeud = _trouverNoeud(radical);
+        if (noeud == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
+        auto traits = noeud->traits.find(std::pmr::string(flexion));
+        if (traits != noeud->traits.end()) return traits->second;
+        if (noeud->flexions.trouver(std::string_view(flexion)) == noeud->flexions.end())
+            throw std::logic_error("La flexion n'existe pas");
+        return 0;
+    }
+
+     /**
+      * \brief Donne la flexion de synonyme qui a les mêmes traits que flexion
+      *
+      * \return la flexion correspondante, ou std::nullopt si flexion est inconnue ou non étiquetée,
+      *         si synonyme n'est pas un radical, ou s'il n'a pas de flexion avec ces traits
+      */
+    std::optional<std::string> DicoSynonymes::flexionCorrespondante(const std::string& flexion, const std::string& synonyme) const
+    {
+        std::string radical;
+        if (racine == nullptr || !_resoudreRadical(flexion, radical)) return std::nullopt;
+        const NoeudDicoSynonymes* source = _noeudDuRadical(radical);
+        auto traits = source->traits.find(std::pmr::string(flexion));
+        if (traits == source->traits.end()) return std::nullopt;
+        const NoeudDicoSynonymes* cible = _noeudDuRadical(synonyme);
+        if (cible == nullptr) return std::nullopt;
+        auto forme = cible->formeParTraits.find(traits->second);
+        if (forme == cible->formeParTraits.end()) return std::nullopt;
+        return std::string(forme->second);
+    }
+
+     /**
+      * \brief Donne les mots à au plus profondeur groupes de synonymes de mot (synonymes de synonymes, etc.)
+      *
+      * \post Le graphe des synonymes est construit au premier appel, puis tenu à jour.
+      * \return les mots, du plus proche au plus éloigné, sans mot lui-même; vide si mot n'a pas de synonyme
+      */
+    std::vector<std::string> DicoSynonymes::synonymesProches(const std::string& mot, int profondeur) const
+    {
+        _lireSynonymesALaDemande();
+        std::lock_guard<std::mutex> garde(verrouGraphe);
+        return _graphe().voisinage(mot, profondeur);
+    }
+
+     /**
+      * \brief Donne le numéro de la composante connexe du graphe des synonymes qui contient mot
+      *
+      * \return le numéro, ou -1 si mot n'est dans aucun groupe de synonymes
+      */
+    int DicoSynonymes::composanteSynonymes(const std::string& mot) const
+    {
+        _lireSynonymesALaDemande();
+        std::lock_guard<std::mutex> garde(verrouGraphe);
+        return _graphe().composante(mot);
+    }
+
+     /**
+      * \brief Donne le nombre de composantes connexes du graphe des synonymes
+      */
+    int DicoSynonymes::nombreComposantesSynonymes() const
+    {
+        _lireSynonymesALaDemande();
+        std::lock_guard<std::mutex> garde(verrouGraphe);
+        return _graphe().nombreComposantes();
+    }
+
+     /**
+      * \brief Donne les k mots qui ont le plus de synonymes directs, avec leur nombre de synonymes
+      */
+    std::vector<std::pair<std::string, int> > DicoSynonymes::plusConnectes(int k) const
+    {
+        _lireSynonymesALaDemande();
+        std::lock_guard<std::mutex> garde(verrouGraphe);
+        return _graphe().plusConnectes(k);
+    }
+
+     /**
+      * \brief Donne les k radicaux les plus semblables à mot, au sens de similitude()
+      *
+      * \return au plus k paires (radical, similitude), de la plus grande similitude à la plus petite
+      */
+    std::vector<std::pair<std::string, float> > DicoSynonymes::plusSimilaires(const std::string& mot, std::size_t k) const
+    {
+        std::vector<std::pair<std::string, int> > proches;
+        {
+            std::lock_guard<std::mutex> garde(verrouSimilitude);
+            if (!similitudeAJour)
+            {
+                std::vector<std::string> radicaux; // parcours en ordre : triés, comme l'exige l'index
+                radicaux.reserve(nbRadicaux);
+                for (const NoeudDicoSynonymes* noeud : parcourArbre()) radicaux.emplace_back(noeud->radical);
+                indexSimilitude.construire(radicaux);
+                similitudeAJour = true;
+            }
+            proches = indexSimilitude.plusProches(mot, k);
+        }
+        std::vector<std::pair<std::string, float> > resultat;
+        resultat.reserve(proches.size());
+        for (auto& proche : proches)
+        {
+            resultat.emplace_back(std::move(proche.first), float((100 - (5 * proche.second))) / 100); // même formule que similitude
+        }
+        return resultat;
+    }
+
+     /**
+	  * \brief Indique si l'arbre est équilibré selon le facteur HB(1)
+	  *
+	  * \post L'arbre est inchangé
+	  * \return bool indiquant si l'arbre est AVL
+      *
+	  */
+    bool DicoSynonymes::estArbreAVL() const{
+         if (this->estVide()) return true;
+         std::queue<NoeudDicoSynonymes*> file;
+         NoeudDicoSynonymes * Noeud;
+         file.push(racine);
+         while (!file.empty())
+         {
+             Noeud = file.front();
+             if (_amplitudeDuDebalancement(Noeud) > 1) // si l'arbre n'est pas équilibré
+             {
+                 return false;
+             }
+             file.pop();
+             if (Noeud->gauche != nullptr) // si il  y a un autre noeud à gauche
+             {
+                 file.push(Noeud->gauche);
+             }
+             if (Noeud->droit != nullptr) // si il y a un autre noeud à droite
+             {
+                 file.push(Noeud->droit);
+             }
+         }
+         return true;
+     }
+
+     /**
+      * \brief Ajoute au dictionnaire tous les radicaux, flexions et groupes de synonymes d'un autre dictionnaire
+      *
+      * \post Les radicaux de autre absents du dictionnaire y sont ajoutés, ceux déjà présents
+      *       reçoivent les flexions et les sens de autre qui leur manquent.
+      * \post Les groupes de synonymes de autre sont ajoutés à la fin de groupesSynonymes.
+      * \post autre reste inchangé; fusionner le dictionnaire avec lui-même ne fait rien.
+      *
+      * \exception bad_alloc s'il n'y a pas assez de mémoire
+      */
+    void DicoSynonymes::fusionner(const DicoSynonymes& autre)
+    {
+        if (&autre == this) return; // il a déjà tous ses radicaux et tous ses sens
+        _lireSynonymesALaDemande();
+        autre._lireSynonymesALaDemande();
+        int decalage = groupesSynonymes.nombreGroupes(); // les groupes de autre sont placés après les nôtres
+        int nbGroupesAutre = autre.groupesSynonymes.nombreGroupes();
+        NoeudDicoSynonymes* copie = _copierArbre(autre.racine, decalage);
+        int nbCopies = autre.nbRadicaux;
+        std::vector<NoeudDicoSynonymes*> nouveaux; // les noeuds copiés qui survivront à l'union
+        _parcourirArbre(copie, nouveaux);
+        nouveaux.erase(std::remove_if(nouveaux.begin(), nouveaux.end(), [this](NoeudDicoSynonymes* noeud) {
+            return _noeudDuRadical(noeud->radical) != nullptr;
+        }), nouveaux.end());
+        for (int i = 0; i < nbGroupesAutre; i++)
+        {
+            std::vector<std::string> groupe; // copie : si autre est *this, ses groupes bougent pendant l'ajout
+            for (const auto synonyme : autre.groupesSynonymes.membres(i))
+            {
+                groupe.emplace_back(autre.groupesSynonymes.mot(synonyme));
+            }
+            int numGroupe = groupesSynonymes.creerGroupe();
+            for (const auto& synonyme : groupe)
+            {
+                groupesSynonymes.ajouter(numGroupe, synonyme);
+            }
+        }
+        int nbDoublons = 0;
+        racine = _union(racine, copie, 0, nbDoublons);
+        nbRadicaux += nbCopies - nbDoublons;
+        for (NoeudDicoSynonymes* noeud : nouveaux)
+        {
+            indexRadicaux.inserer(noeud->radical, noeud);
+        }
+        cacheRadicaux.vider();
+        _invaliderExpansions();
+        _invaliderGraphe();
+        _invaliderSimilitude();
+        arbreLecture.clear();
+        if (journal) compacterJournal(); // une fusion ne se journalise pas opération par opération
+    }
+
+     /**
+      * \brief Retire du dictionnaire tous les radicaux présents dans un autre dictionnaire
+      *
+      * \post Les radicaux de autre sont enlevés du dictionnaire, qui reste équilibré.
+      * \post autre reste inchangé; retirer le dictionnaire de lui-même le vide, groupes compris.
+      */
+    void DicoSynonymes::retirer(const DicoSynonymes& autre)
+    {
+        if (&autre == this) // on retire tout : plus aucun radical ne désigne les groupes
+        {
+            _vider();
+            if (journal) compacterJournal();
+            return;
+        }
+        _lireSynonymesALaDemande();
+        autre._lireSynonymesALaDemande();
+        int nbRetires = 0;
+        racine = _difference(racine, autre.racine, 0, nbRetires);
+        nbRadicaux -= nbRetires;
+        for (NoeudDicoSynonymes* noeud : autre.parcourArbre())
+        {
+            indexRadicaux.effacer(noeud->radical);
+        }
+        cacheRadicaux.vider();
+        _invaliderExpansions();
+        _invaliderGraphe();
+        _invaliderSimilitude();
+        arbreLecture.clear();
+        if (journal) compacterJournal();
+    }
+
+     /**
+      * \brief Active ou désactive le comptage des accès; activer remet les compteurs à 0
+      */
+    void DicoSynonymes::activerProfilage(bool activer)
+    {
+        if (activer)
+        {
+            for (NoeudDicoSynonymes* noeud : parcourArbre()) noeud->acces.store(0, std::memory_order_relaxed);
+        }
+        profilage = activer;
+    }
+
+     /**
+      * \brief Construit l'arbre de lecture pondéré par les accès comptés
+      *
+      * \post L'arbre AVL et son contenu sont inchangés.
+      */
+    void DicoSynonymes::reorganiser()
+    {
+        arbreLecture.clear();
+        if constexpr (Index::actif) return; // les radicaux sont déjà trouvés sans descente
+        std::vector<NoeudDicoSynonymes*> noeuds = parcourArbre();
+        std::vector<std::uint64_t> poidsCumules(noeuds.size() + 1, 0);
+        for (std::size_t i = 0; i < noeuds.size(); i++)
+        {
+            poidsCumules[i + 1] = poidsCumules[i] + noeuds[i]->acces.load(std::memory_order_relaxed) + 1;
+        }
+        arbreLecture.reserve(noeuds.size());
+        _construireArbreLecture(noeuds, poidsCumules, 0, noeuds.size());
+    }
+
+     /**
+      * \brief Ajoute à arbreLecture, en préordre, l'arbre presque optimal des noeuds [debut, fin)
+      * \param[in] poidsCumules poidsCumules[i] est la somme des poids des i premiers noeuds
+      * \return la position de la racine de ce sous-arbre, -1 s'il est vide
+      */
+    std::int32_t DicoSynonymes::_construireArbreLecture(const std::vector<NoeudDicoSynonymes*>& noeuds,
+                                                        const std::vector<std::uint64_t>& poidsCumules, std::size_t debut, std::size_t fin)
+    {
+        if (debut >= fin) return -1;
+        // la racine est le noeud dont l'intervalle de poids contient le milieu du poids de [debut, fin)
+        std::uint64_t milieu = poidsCumules[debut] + (poidsCumules[fin] - poidsCumules[debut]) / 2;
+        std::size_t choisi = std::upper_bound(poidsCumules.begin() + debut + 1, poidsCumules.begin() + fin, milieu)
+                             - poidsCumules.begin() - 1;
+        std::int32_t position = std::int32_t(arbreLecture.size());
+        arbreLecture.push_back(NoeudLecture{noeuds[choisi]->radical, noeuds[choisi], -1, -1});
+        std::int32_t gauche = _construireArbreLecture(noeuds, poidsCumules, debut, choisi);
+        std::int32_t droit = _construireArbreLecture(noeuds, poidsCumules, choisi + 1, fin);
+        arbreLecture[position].gauche = gauche;
+        arbreLecture[position].droit = droit;
+        return position;
+    }
+
+     /**
+      * \brief Trouve le noeud d'un radical exactement dans l'arbre de lecture
+      * \pre arbreLecture n'est pas vide
+      * \return le noeud du radical, ou nullptr
+      */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_chercherArbreLecture(std::string_view radical) const
+    {
+        std::int32_t position = 0;
+        while (position >= 0)
+        {
+            const NoeudLecture& noeud = arbreLecture[position];
+            int comparaison = Ordre::comparer(radical, noeud.radical);
+            if (comparaison == 0) return noeud.noeud;
+            position = comparaison < 0 ? noeud.gauche : noeud.droit;
+        }
+        return nullptr;
+    }
+
+     /**
+      * \brief Écrit le dictionnaire dans un fichier d'index trié, lisible par DicoSynonymesDisque
+      *
+      * \post Le dictionnaire reste inchangé.
+      * \post Pour chaque flexion, l'index retient le radical que retournerait rechercherRadical.
+      *
+      * \exception runtime_error si le fichier ne peut pas être écrit
+      */
+    void DicoSynonymes::sauvegarderIndex(const std::string& chemin) const
+    {
+        _lireSynonymesALaDemande();
+        _ecrireIndex(chemin, 0);
+    }
+
+     /**
+      * \brief Remplace le contenu du dictionnaire par celui d'un fichier d'index
+      *
+      * \pre chemin a été produit par sauvegarderIndex ou par compacterJournal
+      *
+      * \post Le dictionnaire contient exactement les radicaux, flexions et groupes de l'index,
+      *       dans un arbre parfaitement équilibré construit en O(n).
+      *
+      * \exception runtime_error si le fichier ne peut pas être lu
+      * \exception logic_error si le fichier n'est pas un index valide
+      */
+    void DicoSynonymes::chargerIndex(const std::string& chemin)
+    {
+        DicoSynonymesDisque index(chemin, 0);
+        std::vector<std::string> radicaux = index.radicaux();
+        std::vector<NoeudDicoSynonymes*> noeuds;
+        noeuds.reserve(radicaux.size());
+        try
+        {
+            for (const auto& radical : radicaux)
+            {
+                noeuds.push_back(_nouveauNoeud(radical));
+                std::vector<std::string> flexions = index.getFlexions(radical);
+                std::vector<std::uint32_t> traits = index.getTraitsFlexions(radical);
+                noeuds.back()->flexions.assign(flexions.begin(), flexions.end());
+                for (std::size_t i = 0; i < flexions.size(); i++)
+                {
+                    if (traits[i] != 0) _etiqueter(noeuds.back(), flexions[i], traits[i]);
+                }
+                std::vector<int> groupes = index.groupes(radical);
+                noeuds.back()->appSynonymes.assign(groupes.begin(), groupes.end());
+            }
+        }
+        catch (...)
+        {
+            for (NoeudDicoSynonymes* noeud : noeuds) _detruireNoeud(noeud);
+            throw;
+        }
+        _vider();
+        racine = _construireEquilibre(noeuds, 0, noeuds.size());
+        for (NoeudDicoSynonymes* noeud : noeuds)
+        {
+            indexRadicaux.inserer(noeud->radical, noeud);
+        }
+        nbRadicaux = noeuds.size();
+        for (int i = 0; i < index.nombreGroupes(); i++)
+        {
+            int numGroupe = groupesSynonymes.creerGroupe();
+            for (const auto& synonyme : index.membresGroupe(i))
+            {
+                groupesSynonymes.ajouter(numGroupe, synonyme);
+            }
+        }
+    }
+
+     /**
+      * \brief Active la journalisation des modifications du dictionnaire
+      *
+      * \post Chaque modification réussie est journalisée.
+      *
+      * \exception runtime_error si le journal ne peut pas être ouvert
+      */
+    void DicoSynonymes::activerJournal(const std::string& cheminJournal, const std::string& cheminInstantane, std::size_t tailleLot)
+    {
+        _lireSynonymesALaDemande();
+        desactiverJournal();
+        journal = std::make_shared<JournalDicoSynonymes>(cheminJournal, tailleLot);
+        this->cheminInstantane = cheminInstantane;
+    }
+
+     /**
+      * \brief Synchronise puis ferme le journal; les modifications suivantes ne sont plus journalisées
+      */
+    void DicoSynonymes::desactiverJournal()
+    {
+        _attendreCompaction();
+        if (journal) journal->synchroniser();
+        journal.reset();
+    }
+
+     /**
+      * \brief Écrit sur disque les modifications journalisées en attente
+      *
+      * \exception logic_error si le journal n'est pas activé
+      */
+    void DicoSynonymes::synchroniserJournal()
+    {
+        if (!journal) throw std::logic_error("DicoSynonymes::synchroniserJournal: le journal n'est pas activé");
+        journal->synchroniser();
+    }
+
+     /**
+      * \brief Écrit un instantané du dictionnaire puis retire du journal les modifications qu'il contient
+      *
+      * \post Le dictionnaire est copié immédiatement; l'écriture de l'instantané et la troncature
+      *       du journal se font en arrière-plan.
+      *
+      * \exception logic_error si le journal n'est pas activé
+      */
+    void DicoSynonymes::compacterJournal()
+    {
+        _lireSynonymesALaDemande();
+        if (!journal) throw std::logic_error("DicoSynonymes::compacterJournal: le journal n'est pas activé");
+        _attendreCompaction(); // une seule compaction à la fois
+        std::uint64_t dernier = journal->dernierNumero();
+        std::shared_ptr<DicoSynonymes> copie = std::make_shared<DicoSynonymes>();
+        copie->fusionner(*this); // la copie n'a pas de journal, elle ne relance donc pas de compaction
+        std::shared_ptr<JournalDicoSynonymes> journalCourant = journal;
+        std::string chemin = cheminInstantane;
+        compaction = std::async(std::launch::async, [copie, journalCourant, chemin, dernier]() {
+            journalCourant->synchroniser(); // l'instantané ne doit pas précéder sur disque ce qu'il remplace
+            std::string temporaire = chemin + ".tmp";
+            copie->_ecrireIndex(temporaire, dernier);
+            int fd = ::open(temporaire.c_str(), O_RDONLY);
+            if (fd < 0 || ::fsync(fd) != 0 || std::rename(temporaire.c_str(), chemin.c_str()) != 0)
+            {
+                if (fd >= 0) ::close(fd);
+                throw std::runtime_error("DicoSynonymes::compacterJournal: impossible d'écrire " + chemin);
+            }
+            ::close(fd);
+            journalCourant->tronquerJusqua(dernier);
+        });
+    }
+
+     /**
+      * \brief Reconstruit le dictionnaire à partir du dernier instantané et du journal
+      *
+      * \post Le dictionnaire contient l'instantané (s'il existe) auquel on a appliqué, dans l'ordre,
+      *       les modifications du journal qui lui sont postérieures.
+      *
+      * \exception logic_error si l'instantané n'est pas valide ou si une modification ne peut être rejouée
+      */
+    void DicoSynonymes::recuperer(const std::string& cheminInstantane, const std::string& cheminJournal)
+    {
+        std::shared_ptr<JournalDicoSynonymes> journalActif = journal;
+        journal.reset(); // on ne journalise pas ce qu'on rejoue
+        std::uint64_t dejaInclus = 0;
+        if (std::ifstream(cheminInstantane).good())
+        {
+            chargerIndex(cheminInstantane);
+            dejaInclus = DicoSynonymesDisque(cheminInstantane, 0).dernierEnregistrement();
+        }
+        else
+        {
+            _vider();
+        }
+        try
+        {
+            for (auto& enregistrement : JournalDicoSynonymes::lire(cheminJournal))
+            {
+                if (enregistrement.numero <= dejaInclus) continue;
+                switch (enregistrement.operation)
+                {
+                case JournalDicoSynonymes::AJOUTER_RADICAL:
+                    ajouterRadical(enregistrement.mot1);
+                    break;
+                case JournalDicoSynonymes::AJOUTER_FLEXION:
+                    ajouterFlexion(enregistrement.mot1, enregistrement.mot2, Traits(enregistrement.numGroupe));
+                    break;
+                case JournalDicoSynonymes::AJOUTER_SYNONYME:
+                    ajouterSynonyme(enregistrement.mot1, enregistrement.mot2, enregistrement.numGroupe);
+                    break;
+                case JournalDicoSynonymes::SUPPRIMER_RADICAL:
+                    supprimerRadical(enregistrement.mot1);
+                    break;
+                case JournalDicoSynonymes::SUPPRIMER_FLEXION:
+                    supprimerFlexion(enregistrement.mot1, enregistrement.mot2);
+                    break;
+                case JournalDicoSynonymes::SUPPRIMER_SYNONYME:
+                    supprimerSynonyme(enregistrement.mot1, enregistrement.mot2, enregistrement.numGroupe);
+                    break;
+                default:
+                    throw std::logic_error("DicoSynonymes::recuperer: opération de journal inconnue");
+                }
+            }
+        }
+        catch (...)
+        {
+            journal = journalActif;
+            throw;
+        }
+        journal = journalActif;
+    }
+
+    /**
+     * \brief Écrit le fichier d'index du dictionnaire
+     * \param[in] chemin le fichier à écrire
+     * \param[in] dernierEnregistrement le dernier enregistrement du journal que contient l'index
+     * \exception runtime_error si le fichier ne peut pas être écrit
+     */
+    void DicoSynonymes::_ecrireIndex(const std::string& chemin, std::uint64_t dernierEnregistrement) const
+    {
+        std::vector<NoeudDicoSynonymes*> noeuds = parcourArbre(); // parcours en ordre, donc déjà trié
+        std::string chaines;
+        auto ajouterChaine = [&chaines](std::string_view mot) {
+            FormatIndex::Chaine c = { (std::uint32_t) chaines.size(), (std::uint32_t) mot.size() };
+            chaines += mot;
+            return c;
+        };
+
+        std::vector<std::pair<std::string, std::uint32_t> > meilleurs = _meilleursRadicaux(noeuds);
+
+        std::vector<std::uint32_t> enregistrements; // enregistrements des radicaux puis des groupes
+        std::vector<std::uint64_t> debutRadicaux, debutGroupes; // positions relatives dans enregistrements
+        for (NoeudDicoSynonymes* noeud : noeuds)
+        {
+            debutRadicaux.push_back(enregistrements.size());
+            enregistrements.push_back(noeud->flexions.size());
+            for (const auto& flexion : noeud->flexions)
+            {
+                FormatIndex::Chaine c = ajouterChaine(flexion);
+                enregistrements.push_back(c.debut);
+                enregistrements.push_back(c.longueur);
+            }
+            for (const auto& flexion : noeud->flexions)
+            {
+                auto traits = noeud->traits.find(flexion);
+                enregistrements.push_back(traits == noeud->traits.end() ? 0 : traits->second); // flexion est déjà une std::pmr::string
+            }
+            enregistrements.push_back(noeud->appSynonymes.size());
+            enregistrements.insert(enregistrements.end(), noeud->appSynonymes.begin(), noeud->appSynonymes.end());
+        }
+        for (int g = 0; g < groupesSynonymes.nombreGroupes(); g++)
+        {
+            const auto& groupe = groupesSynonymes.membres(g);
+            debutGroupes.push_back(enregistrements.size());
+            enregistrements.push_back(groupe.size());
+            for (const auto synonyme : groupe)
+            {
+                FormatIndex::Chaine c = ajouterChaine(groupesSynonymes.mot(synonyme));
+                enregistrements.push_back(c.debut);
+                enregistrements.push_back(c.longueur);
+            }
+        }
+
+        FormatIndex::Entete entete = {};
+        std::memcpy(entete.magie, FormatIndex::MAGIE, 4);
+        entete.version = FormatIndex::VERSION;
+        entete.nbRadicaux = noeuds.size();
+        entete.nbFlexions = meilleurs.size();
+        entete.nbGroupes = groupesSynonymes.nombreGroupes();
+        entete.debutRadicaux = sizeof(FormatIndex::Entete);
+        entete.debutFlexions = entete.debutRadicaux + noeuds.size() * sizeof(FormatIndex::Radical);
+        entete.debutGroupes = entete.debutFlexions + meilleurs.size() * sizeof(FormatIndex::Flexion);
+        std::uint64_t debutEnregistrements = entete.debutGroupes + groupesSynonymes.nombreGroupes() * sizeof(std::uint64_t);
+        entete.debutChaines = debutEnregistrements + enregistrements.size() * sizeof(std::uint32_t);
+
+        std::vector<FormatIndex::Radical> tableRadicaux;
+        for (std::uint32_t i = 0; i < noeuds.size(); i++)
+        {
+            FormatIndex::Radical r = { ajouterChaine(noeuds[i]->radical), debutEnregistrements + 4 * debutRadicaux[i] };
+            tableRadicaux.push_back(r);
+        }
+        std::vector<FormatIndex::Flexion> tableFlexions;
+        for (const auto& meilleur : meilleurs) // déjà triées
+        {
+            FormatIndex::Flexion f = { ajouterChaine(meilleur.first), meilleur.second, 0 };
+            tableFlexions.push_back(f);
+        }
+        for (auto& debut : debutGroupes)
+        {
+            debut = debutEnregistrements + 4 * debut;
+        }
+        entete.taille = entete.debutChaines + chaines.size();
+        entete.dernierEnregistrement = dernierEnregistrement;
+
+        std::ofstream fichier(chemin, std::ios::binary | std::ios::trunc);
+        if (!fichier.is_open()) throw std::runtime_error("DicoSynonymes::_ecrireIndex: impossible d'ouvrir " + chemin);
+        fichier.write(reinterpret_cast<const char*>(&entete), sizeof(entete));
+        fichier.write(reinterpret_cast<const char*>(tableRadicaux.data()), tableRadicaux.size() * sizeof(FormatIndex::Radical));
+        fichier.write(reinterpret_cast<const char*>(tableFlexions.data()), tableFlexions.size() * sizeof(FormatIndex::Flexion));
+        fichier.write(reinterpret_cast<const char*>(debutGroupes.data()), debutGroupes.size() * sizeof(std::uint64_t));
+        fichier.write(reinterpret_cast<const char*>(enregistrements.data()), enregistrements.size() * sizeof(std::uint32_t));
+        fichier.write(chaines.data(), chaines.size());
+        if (!fichier) throw std::runtime_error("DicoSynonymes::_ecrireIndex: erreur d'écriture dans " + chemin);
+    }
+
+	// Mettez l'implantation des autres méthodes (surtout privées) ici.
+
+    /**
+     * \brief Insère un radical dans l'arbre
+     * \param[in] noeud le noeud où l'on veut insérer
+     * \param[in] Radical le radical que l'on veut insérer
+     */
+    void DicoSynonymes::_insererAVL(NoeudDicoSynonymes*& noeud, const std::string& Radical)
+    {
+        // si le radical existe déja on sort; l'arbre ne change pas pendant la descente, un test à la racine suffit
+        if (&noeud == &racine && _rechercherRadical(racine,Radical) != nullptr) return;
+        if (noeud == nullptr)
+        {
+            noeud = _nouveauNoeud(Radical);
+            indexRadicaux.inserer(Radical, noeud);
+            nbRadicaux++;
+            _invaliderSimilitude();
+            _invaliderTransducteur(); // les numéros des radicaux suivants changent
+            arbreLecture.clear();
+            return;
+        }
+        else if (_inferieur(Radical, noeud->radical)) // plus petit donc insertion à gauche
+        {
+            _insererAVL(noeud->gauche, Radical);
+        }
+        else // plus grand donc on insert à droite
+        {
+            _insererAVL(noeud->droit, Radical);
+        }
+        _miseAJourHauteurNoeud(noeud);
+        _balancerUnNoeud(noeud); // on garde les hauteurs et l'arbre balancé
+    }
+
+    /**
+     * \brief Met à jour la hauteur et la taille d'un noeud pour que celles-ci soient toujours valides
+     * \param[in] noeud le noeud dont on veut mettre à jour la hauteur
+     */
+    void DicoSynonymes::_miseAJourHauteurNoeud(NoeudDicoSynonymes*& noeud)
+    {
+        if (noeud != nullptr) {
+            noeud->hauteur = 1 + std::max(_hauteur(noeud->droit), _hauteur(noeud->gauche));
+            noeud->taille = 1 + _taille(noeud->gauche) + _taille(noeud->droit);
+        }
+    }
+
+    /**
+     * \brief Effectue les balancement nécéssaire d'un noeud pour que l'arbre reste équilibré
+     * \param[in] noeud le noeud que l'on veut balancer
+     */
+    void DicoSynonymes::_balancerUnNoeud(NoeudDicoSynonymes*& noeud)
+    {
+        if (noeud == nullptr) return;
+        if (_debalancementAGauche(noeud))
+        {
+            if (_sousArbrePencheADroite(noeud->gauche)) // gauche -> droite = zig zag gauche
+            {
+                _zigZagGauche(noeud);
+            }
+            else // gauche -> gauche = zig zig gauche
+            {
+                _zigZigGauche(noeud);
+            }
+        }
+        else if (_debalancementADroite(noeud))
+        {
+            if (_sousArbrePencheAGauche(noeud->droit)) // droite -> gauche = zig zag droit
+            {
+                _zigZagDroite(noeud);
+            }
+            else // droite -> droite = zig zig droit
+            {
+                _zigZigDroite(noeud);
+            }
+       }
+    }
+
+    /**
+     * \brief donne la hauteur d'un noeud de l'abre
+     * \param[in] noeud le noeud dont on cherche la hauteur
+     * \return int la hauteur du noeud
+     */
+    int DicoSynonymes::_hauteur(NoeudDicoSynonymes* noeud) const
+    {
+        if (noeud == nullptr) return -1; // si l'arbre est vide, on met -1 comme valeur de hauteur par défaut
+        return noeud->hauteur;
+    }
+
+    /**
+     * \brief donne le nombre de noeuds d'un sous-arbre
+     * \param[in] noeud la racine du sous-arbre
+     * \return int la taille du sous-arbre, 0 s'il est vide
+     */
+    int DicoSynonymes::_taille(const NoeudDicoSynonymes* noeud) const
+    {
+        return noeud == nullptr ? 0 : noeud->taille;
+    }
+
+    /**
+     * \brief vérifie si l'arbre est débalancer vers la gauche
+     * \param[in] Arbre l'arbre dont on veut avoir le status de stabilité
+     * \return bool true si l'arbre est débalancer vers la gauche, false sinon
+     */
+    bool DicoSynonymes::_debalancementAGauche(NoeudDicoSynonymes * & Arbre) const
+    {
+        if (Arbre == nullptr) return false;
+        return (_hauteur(Arbre->gauche) - _hauteur(Arbre->droit)) >= 2;
+    }
+
+    /**
+     * \brief vérifie si l'arbre est débalancer vers la droite
+     * \param[in] Arbre l'arbre dont on veut avoir le status de stabilité
+     * \return bool true si l'arbre est débalancer vers la droite, false sinon
+     */
+    bool DicoSynonymes::_debalancementADroite(NoeudDicoSynonymes * & Arbre) const
+    {
+        if (Arbre == nullptr) return false;
+        return (_hauteur(Arbre->droit) - _hauteur(Arbre->gauche)) >= 2;
+    }
+
+    /**
+     * \brief vérifie si un sous arbre penche vers la gauche
+     * \param[in] sousArbre le sous arbre que l'on veut vérifier
+     * \return bool true si le sous arbre penche vers la gauche, false sinon
+     */
+    bool DicoSynonymes::_sousArbrePencheAGauche(NoeudDicoSynonymes * & sousArbre) const
+    {
+        if (sousArbre == nullptr) return false;
+        return (_hauteur(sousArbre->gauche) > _hauteur(sousArbre->droit));
+    }
+
+    /**
+     * \brief vérifie si un sous arbre penche vers la droite
+     * \param[in] sousArbre le sous arbre que l'on veut vérifier
+     * \return bool true si le sous arbre penche vers la droite, false sinon
+     */
+    bool DicoSynonymes::_sousArbrePencheADroite(NoeudDicoSynonymes * & sousArbre) const
+    {
+        if (sousArbre == nullptr) return false;
+        return (_hauteur(sousArbre->droit) > _hauteur(sousArbre->gauche));
+    }
+
+    /**
+     * \brief Effectue un mouvement de balancement zig zig gauche
+     * \param[in] NoeudCritique le noeud critique du balancement
+     */
+    void DicoSynonymes::_zigZigGauche(NoeudDicoSynonymes * & NoeudCritique)
+    {
+        NoeudDicoSynonymes * noeudSousCritique = NoeudCritique->gauche;
+        NoeudCritique->gauche = noeudSousCritique->droit;
+        noeudSousCritique->droit = NoeudCritique;
+        _miseAJourHauteurNoeud(NoeudCritique);
+        _miseAJourHauteurNoeud(noeudSousCritique);
+        NoeudCritique = noeudSousCritique;
+    }
+
+    /**
+     * \brief Effectue un mouvement de balancement zig zag gauche
+     * \param[in] NoeudCritique le noeud critique du balancement
+     */
+    void DicoSynonymes::_zigZagGauche(NoeudDicoSynonymes * & NoeudCritique)
+    {
+        _zigZigDroite(NoeudCritique->gauche);
+        _zigZigGauche(NoeudCritique);
+    }
+
+    /**
+     * \brief Effectue un mouvement de balancement zig zig droit
+     * \param[in] NoeudCritique le noeud critique du balancement
+     */
+    void DicoSynonymes::_zigZigDroite(NoeudDicoSynonymes * & NoeudCritique)
+    {
+        NoeudDicoSynonymes * noeudSousCritique = NoeudCritique->droit;
+        NoeudCritique->droit = noeudSousCritique->gauche;
+        noeudSousCritique->gauche = NoeudCritique;
+        _miseAJourHauteurNoeud(NoeudCritique);
+        _miseAJourHauteurNoeud(noeudSousCritique);
+        NoeudCritique = noeudSousCritique;
+    }
+
+    /**
+     * \brief Effectue un mouvement de balancement zig zag droite
+     * \param[in] NoeudCritique le noeud critique du balancement
+     */
+    void DicoSynonymes::_zigZagDroite(NoeudDicoSynonymes * & NoeudCritique)
+    {
+        _zigZigGauche(NoeudCritique->droit);
+        _zigZigDroite(NoeudCritique);
+    }
+
+    /**
+     * \brief trouve le noeud qui contient le mot recherché
+     * \param[in] noeud le noeud qu'on vérifie s'il contient le mot recherché
+     * \param[in] mot le mot qu'on cherche
+     * \return le noeud qui contient le mot recherché s'il existe, sinon nullptr
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_rechercherRadical(NoeudDicoSynonymes* noeud, const std::string& mot) const
+    {
+        if (noeud != nullptr)
+        {
+            auto itr = noeud->flexions.trouver(std::string_view(mot));
+            if (_egal(mot, noeud->radical) || itr != noeud->flexions.end())
+            {
+                return noeud;
+            }
+            else if (_inferieur(mot, noeud->radical)) // si le mot est plus petit on doit chercher à gauche
+            {
+                return _rechercherRadical(noeud->gauche, mot);
+            }
+            else // si le mot est plus grand on doit chercher à droite
+            {
+                return _rechercherRadical(noeud->droit, mot);
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * \brief trouve le noeud d'un radical, en O(1) par l'index de hachage ou, sans index, par l'arbre de lecture
+     *        s'il est construit; compte l'accès si le profilage est actif
+     * \param[in] mot le radical cherché
+     * \param[in] compterAcces false : l'accès n'est pas compté, même si le profilage est actif
+     * \return le noeud du radical; sinon, comme _rechercherRadical, le premier noeud rencontré
+     *         en descendant l'arbre dont mot est une flexion, ou nullptr
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_trouverNoeud(const std::string& mot, bool compterAcces) const
+    {
+        NoeudDicoSynonymes* noeud = indexRadicaux.trouver(mot);
+        if (noeud == nullptr && !arbreLecture.empty()) noeud = _chercherArbreLecture(mot);
+        if (noeud == nullptr) noeud = _rechercherRadical(racine, mot);
+        if (noeud != nullptr && profilage && compterAcces) noeud->acces.fetch_add(1, std::memory_order_relaxed);
+        return noeud;
+    }
+
+    /**
+     * \brief trouve le noeud d'un radical exactement, par l'index de hachage s'il est compilé, sinon
+     *        par l'arbre de lecture s'il est construit (reorganiser), ou dans l'arbre AVL
+     * \return le noeud du radical, ou nullptr (les flexions ne sont pas considérées)
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_noeudDuRadical(std::string_view radical) const
+    {
+        if constexpr (Index::actif) return indexRadicaux.trouver(radical);
+        if (!arbreLecture.empty()) return _chercherArbreLecture(radical);
+        NoeudDicoSynonymes* noeud = racine;
+        while (noeud != nullptr)
+        {
+            int comparaison = Ordre::comparer(radical, noeud->radical);
+            if (comparaison == 0) return noeud;
+            noeud = comparaison < 0 ? noeud->gauche : noeud->droit;
+        }
+        return nullptr;
+    }
+
+    /**
+     * \brief Compare deux radicaux selon la politique d'ordre du dictionnaire
+     */
+    bool DicoSynonymes::_inferieur(std::string_view a, std::string_view b)
+    {
+        return Ordre::comparer(a, b) < 0;
+    }
+
+    bool DicoSynonymes::_egal(std::string_view a, std::string_view b)
+    {
+        return Ordre::comparer(a, b) == 0;
+    }
+
+    /**
+     * \brief Résout mot en radical, en passant par le cache
+     * \pre L'arbre n'est pas vide
+     * \param[out] radical le radical trouvé, inchangé sinon
+     * \return false si mot n'est la flexion d'aucun radical
+     */
+    bool DicoSynonymes::_resoudreRadical(const std::string& mot, std::string& radical) const
+    {
+        bool existe;
+        if (cacheRadicaux.trouver(mot, radical, existe)) return existe;
+        float similitudeMax = 0;
+        const NoeudDicoSynonymes* choisi = nullptr;
+        _meilleurRadical(racine, mot, similitudeMax, choisi);
+        if (choisi == nullptr)
+        {
+            cacheRadicaux.inserer(mot, "", false);
+            return false;
+        }
+        radical = choisi->radical;
+        cacheRadicaux.inserer(mot, radical, true);
+        return true;
+    }
+
+    /**
+     * \brief Parcourt le sous-arbre en ordre et retient le premier radical de plus grande similitude
+     *        (strictement positive) parmi ceux dont mot est une flexion
+     */
+    void DicoSynonymes::_meilleurRadical(const NoeudDicoSynonymes* noeud, const std::string& mot,
+                                         float& similitudeMax, const NoeudDicoSynonymes*& choisi) const
+    {
+        if (noeud == nullptr) return;
+        _meilleurRadical(noeud->gauche, mot, similitudeMax, choisi);
+        if (noeud->flexions.trouver(mot) != noeud->flexions.end()) // si mot est une flexion du radical
+        {
+            float similitudeTemp = similitude(std::string(noeud->radical), mot);
+            if (similitudeTemp > similitudeMax)
+            {
+                similitudeMax = similitudeTemp;
+                choisi = noeud;
+            }
+        }
+        _meilleurRadical(noeud->droit, mot, similitudeMax, choisi);
+    }
+
+    /**
+     * \brief Donne, pour chaque flexion, le radical le plus semblable avec la même règle que rechercherRadical
+     * \param[in] noeuds les noeuds de l'arbre en ordre (parcourArbre)
+     * \return les paires (flexion, position du radical dans noeuds), triées par flexion
+     */
+    std::vector<std::pair<std::string, std::uint32_t> > DicoSynonymes::_meilleursRadicaux(const std::vector<NoeudDicoSynonymes*>& noeuds) const
+    {
+        std::unordered_map<std::string, std::pair<float, std::uint32_t> > meilleurs;
+        for (std::uint32_t numero = 0; numero < noeuds.size(); numero++)
+        {
+            std::string radical(noeuds[numero]->radical);
+            for (const auto& forme : noeuds[numero]->flexions)
+            {
+                std::string flexion(forme);
+                float similitudeTemp = similitude(radical, flexion);
+                auto itr = meilleurs.find(flexion);
+                if (similitudeTemp > 0 && (itr == meilleurs.end() || similitudeTemp > itr->second.first))
+                    meilleurs[flexion] = std::make_pair(similitudeTemp, numero);
+            }
+        }
+        std::vector<std::pair<std::string, std::uint32_t> > paires;
+        paires.reserve(meilleurs.size());
+        for (auto& meilleur : meilleurs) paires.emplace_back(meilleur.first, meilleur.second.second);
+        std::sort(paires.begin(), paires.end());
+        return paires;
+    }
+
+    /**
+     * \brief Donne le groupe de synonymes du sens numéro position du noeud
+     * \return nullptr si le noeud est nul ou si la position ou le numéro de groupe n'est pas valide
+     */
+    const std::pmr::vector<std::uint32_t>* DicoSynonymes::_groupeDuSens(const NoeudDicoSynonymes* noeud, int position) const
+    {
+        if (noeud == nullptr || position < 0 || position >= int(noeud->appSynonymes.size())) return nullptr;
+        int numGroupe = noeud->appSynonymes[position];
+        if (numGroupe < 0 || numGroupe >= groupesSynonymes.nombreGroupes()) return nullptr;
+        return &groupesSynonymes.membres(numGroupe);
+    }
+
+    /**
+     * \brief Calcule l'expansion d'un radical et enregistre les groupes et synonymes dont elle dépend
+     * \pre verrouExpansions est tenu
+     */
+    void DicoSynonymes::_construireExpansion(const NoeudDicoSynonymes* noeud, Expansion& expansion) const
+    {
+        expansion.radical = noeud->radical;
+        expansion.sens.clear();
+        expansion.debutSens.clear();
+        expansion.candidats.clear();
+        for (int numGroupe : noeud->appSynonymes)
+        {
+            expansion.debutSens.push_back(expansion.candidats.size());
+            if (numGroupe < 0 || numGroupe >= groupesSynonymes.nombreGroupes())
+            {
+                expansion.sens.push_back("");
+                continue;
+            }
+            radicauxParGroupe[numGroupe].emplace(noeud->radical);
+            const auto& groupeSyn = groupesSynonymes.membres(numGroupe);
+            expansion.sens.emplace_back(groupeSyn.empty() ? std::string_view() : groupesSynonymes.mot(groupeSyn.front()));
+            for (const auto id : groupeSyn)
+            {
+                std::string synonyme(groupesSynonymes.mot(id));
+                radicauxParSynonyme[synonyme].emplace(noeud->radical);
+                const NoeudDicoSynonymes* noeudSynonyme = _noeudDuRadical(synonyme);
+                if (noeudSynonyme == nullptr) continue; // un synonyme sans radical n'a pas de forme à proposer
+                for (const auto& forme : noeudSynonyme->flexions)
+                {
+                    auto traits = noeudSynonyme->traits.find(forme);
+                    expansion.candidats.push_back(Candidat{synonyme, std::string(forme),
+                                                           traits == noeudSynonyme->traits.end() ? 0 : traits->second});
+                }
+            }
+        }
+        expansion.debutSens.push_back(expansion.candidats.size());
+    }
+
+    /**
+     * \brief Reconstruit toute la table des expansions
+     * \pre verrouExpansions est tenu
+     */
+    void DicoSynonymes::_reconstruireExpansions() const
+    {
+        expansionsParRadical.clear();
+        expansionsParFlexion.clear();
+        radicauxParSynonyme.clear();
+        radicauxParGroupe.clear();
+        flexionsSales.clear();
+        radicauxSales.clear();
+        std::vector<NoeudDicoSynonymes*> noeuds = parcourArbre();
+        std::vector<const Expansion*> expansions;
+        expansions.reserve(noeuds.size());
+        for (NoeudDicoSynonymes* noeud : noeuds)
+        {
+            Expansion& expansion = expansionsParRadical[std::string(noeud->radical)];
+            _construireExpansion(noeud, expansion);
+            expansions.push_back(&expansion);
+        }
+        std::vector<std::pair<std::string, std::uint32_t> > meilleurs = _meilleursRadicaux(noeuds);
+        expansionsParFlexion.reserve(meilleurs.size());
+        for (auto& meilleur : meilleurs)
+        {
+            expansionsParFlexion.emplace(std::move(meilleur.first), expansions[meilleur.second]);
+        }
+        expansionsAJour = true;
+    }
+
+    /**
+     * \brief Recalcule les expansions des radicaux marqués, puis la résolution des flexions marquées
+     * \pre verrouExpansions est tenu et la table a déjà été construite
+     */
+    void DicoSynonymes::_mettreAJourExpansions() const
+    {
+        for (const auto& radical : radicauxSales)
+        {
+            const NoeudDicoSynonymes* noeud = _noeudDuRadical(radical);
+            if (noeud != nullptr) _construireExpansion(noeud, expansionsParRadical[radical]); // sur place : les pointeurs restent valides
+            else expansionsParRadical.erase(radical); // ses flexions ont été marquées avec lui
+        }
+        for (const auto& flexion : flexionsSales)
+        {
+            std::string radical;
+            if (racine == nullptr || !_resoudreRadical(flexion, radical))
+            {
+                expansionsParFlexion.erase(flexion);
+                continue;
+            }
+            auto itr = expansionsParRadical.find(radical);
+            if (itr == expansionsParRadical.end()) // radical ajouté depuis la dernière construction
+            {
+                itr = expansionsParRadical.emplace(radical, Expansion()).first;
+                _construireExpansion(_noeudDuRadical(radical), itr->second);
+            }
+            expansionsParFlexion[flexion] = &itr->second;
+        }
+        radicauxSales.clear();
+        flexionsSales.clear();
+    }
+
+    /**
+     * \brief Marque les entrées de la table des expansions touchées par une modification de radical
+     *
+     * \param[in] radical le radical modifié : son expansion, et celles qui lisent ses flexions, sont à refaire
+     * \param[in] flexion la flexion ajoutée ou retirée, dont la résolution est à refaire (vide s'il n'y en a pas)
+     * \param[in] numGroupe le groupe modifié, dont les lecteurs sont à refaire (-1 s'il n'y en a pas)
+     */
+    void DicoSynonymes::_marquerExpansions(const std::string& radical, const std::string& flexion, int numGroupe)
+    {
+        if (flexion.find('_') != std::string::npos) _invaliderPhrases();
+        _invaliderSignatures();
+        if (numGroupe < 0) _invaliderTransducteur(); // un radical ou une flexion change
+        std::lock_guard<std::mutex> garde(verrouExpansions);
+        if (!expansionsAJour) return; // la prochaine construction sera complète
+        radicauxSales.insert(radical);
+        auto lecteurs = radicauxParSynonyme.find(radical);
+        if (lecteurs != radicauxParSynonyme.end()) radicauxSales.insert(lecteurs->second.begin(), lecteurs->second.end());
+        if (!flexion.empty()) flexionsSales.insert(flexion);
+        auto lecteursGroupe = radicauxParGroupe.find(numGroupe);
+        if (lecteursGroupe != radicauxParGroupe.end()) radicauxSales.insert(lecteursGroupe->second.begin(), lecteursGroupe->second.end());
+    }
+
+    /**
+     * \brief Demande la reconstruction complète de la table des expansions au prochain appel d'expansion
+     */
+    void DicoSynonymes::_invaliderExpansions()
+    {
+        {
+            std::lock_guard<std::mutex> garde(verrouExpansions);
+            expansionsAJour = false;
+        }
+        _invaliderPhrases();
+        _invaliderSignatures();
+        _invaliderTransducteur();
+    }
+
+    /**
+     * \brief Demande la reconstruction du transducteur des flexions au prochain appel de numeroRadical
+     */
+    void DicoSynonymes::_invaliderTransducteur()
+    {
+        std::lock_guard<std::mutex> garde(verrouTransducteur);
+        transducteurAJour = false;
+    }
+
+    /**
+     * \brief Demande la reconstruction de l'automate des expressions au prochain appel de decouper
+     */
+    void DicoSynonymes::_invaliderPhrases()
+    {
+        std::lock_guard<std::mutex> garde(verrouPhrases);
+        phrasesAJour = false;
+    }
+
+    /**
+     * \brief Demande le recalcul des signatures des groupes au prochain appel de choisirSens
+     */
+    void DicoSynonymes::_invaliderSignatures()
+    {
+        std::lock_guard<std::mutex> garde(verrouSignatures);
+        signaturesAJour = false;
+    }
+
+    /**
+     * \brief Met à 1 le bit de mot dans une signature
+     */
+    void DicoSynonymes::_marquerSignature(Signature& signature, std::string_view mot)
+    {
+        std::size_t bit = Ordre::hacher(mot) & 511;
+        signature[bit >> 6] |= std::uint64_t(1) << (bit & 63);
+    }
+
+    /**
+     * \brief Recalcule la signature de chaque groupe : ses synonymes, les radicaux qui ont ce sens, et leurs flexions
+     * \pre verrouSignatures est tenu
+     */
+    void DicoSynonymes::_calculerSignatures() const
+    {
+        signaturesGroupes.assign(groupesSynonymes.nombreGroupes(), Signature{});
+        auto marquerMot = [this](Signature& signature, std::string_view mot) {
+            _marquerSignature(signature, mot);
+            const NoeudDicoSynonymes* noeud = _noeudDuRadical(mot);
+            if (noeud == nullptr) return;
+            for (const auto& flexion : noeud->flexions) _marquerSignature(signature, flexion);
+        };
+        for (std::size_t g = 0; g < signaturesGroupes.size(); g++)
+        {
+            for (const auto synonyme : groupesSynonymes.membres(g)) marquerMot(signaturesGroupes[g], groupesSynonymes.mot(synonyme));
+        }
+        for (const NoeudDicoSynonymes* noeud : parcourArbre())
+        {
+            for (int numGroupe : noeud->appSynonymes)
+            {
+                if (numGroupe >= 0 && numGroupe < int(signaturesGroupes.size())) marquerMot(signaturesGroupes[numGroupe], noeud->radical);
+            }
+        }
+        signaturesAJour = true;
     }
 
     /**
-     * \brief vérifie si un sous arbre penche vers la droite
-     * \param[in] sousArbre le sous arbre que l'on veut vérifier
-     * \return bool true si le sous arbre penche vers la droite, false sinon
+     * \brief Donne le graphe des synonymes, en le construisant s'il n'est pas à jour
+     * \pre verrouGraphe est tenu
      */
-    bool DicoSynonymes::_sousArbrePencheADroite(NoeudDicoSynonymes * & sousArbre) const
+    GrapheSynonymes& DicoSynonymes::_graphe() const
     {
-        if (sousArbre == nullptr) return false;
-        return (_hauteur(sousArbre->droit) > _hauteur(sousArbre->gauche));
+        if (grapheAJour) return graphe;
+        std::vector<std::vector<std::string> > membres(groupesSynonymes.nombreGroupes());
+        for (std::size_t g = 0; g < membres.size(); g++)
+        {
+            for (const auto synonyme : groupesSynonymes.membres(g)) membres[g].emplace_back(groupesSynonymes.mot(synonyme));
+        }
+        for (const NoeudDicoSynonymes* noeud : parcourArbre()) // un radical est membre des groupes de ses sens
+        {
+            for (int numGroupe : noeud->appSynonymes)
+            {
+                if (numGroupe >= 0 && numGroupe < int(membres.size())) membres[numGroupe].emplace_back(noeud->radical);
+            }
+        }
+        graphe.construire(membres);
+        grapheAJour = true;
+        return graphe;
     }
 
     /**
-     * \brief Effectue un mouvement de balancement zig zig gauche
-     * \param[in] NoeudCritique le noeud critique du balancement
+     * \brief Ajoute mot au groupe numGroupe du graphe des synonymes, ou l'en retire, si le graphe est construit
      */
-    void DicoSynonymes::_zigZigGauche(NoeudDicoSynonymes * & NoeudCritique)
+    void DicoSynonymes::_modifierGraphe(int numGroupe, const std::string& mot, bool ajout)
     {
-        NoeudDicoSynonymes * noeudSousCritique = NoeudCritique->gauche;
-        NoeudCritique->gauche = noeudSousCritique->droit;
-        noeudSousCritique->droit = NoeudCritique;
-        _miseAJourHauteurNoeud(NoeudCritique);
-        _miseAJourHauteurNoeud(noeudSousCritique);
-        NoeudCritique = noeudSousCritique;
+        std::lock_guard<std::mutex> garde(verrouGraphe);
+        if (!grapheAJour) return; // la prochaine construction partira des groupes
+        if (ajout) graphe.ajouterAuGroupe(numGroupe, mot);
+        else graphe.retirerDuGroupe(numGroupe, mot);
     }
 
     /**
-     * \brief Effectue un mouvement de balancement zig zag gauche
-     * \param[in] NoeudCritique le noeud critique du balancement
+     * \brief Demande la reconstruction du graphe des synonymes au prochain appel qui s'en sert
      */
-    void DicoSynonymes::_zigZagGauche(NoeudDicoSynonymes * & NoeudCritique)
+    void DicoSynonymes::_invaliderGraphe()
     {
-        _zigZigDroite(NoeudCritique->gauche);
-        _zigZigGauche(NoeudCritique);
+        std::lock_guard<std::mutex> garde(verrouGraphe);
+        grapheAJour = false;
     }
 
     /**
-     * \brief Effectue un mouvement de balancement zig zig droit
-     * \param[in] NoeudCritique le noeud critique du balancement
+     * \brief Demande la reconstruction de l'index de plusSimilaires au prochain appel
      */
-    void DicoSynonymes::_zigZigDroite(NoeudDicoSynonymes * & NoeudCritique)
+    void DicoSynonymes::_invaliderSimilitude()
     {
-        NoeudDicoSynonymes * noeudSousCritique = NoeudCritique->droit;
-        NoeudCritique->droit = noeudSousCritique->gauche;
-        noeudSousCritique->gauche = NoeudCritique;
-        _miseAJourHauteurNoeud(NoeudCritique);
-        _miseAJourHauteurNoeud(noeudSousCritique);
-        NoeudCritique = noeudSousCritique;
+        std::lock_guard<std::mutex> garde(verrouSimilitude);
+        similitudeAJour = false;
     }
 
     /**
-     * \brief Effectue un mouvement de balancement zig zag droite
-     * \param[in] NoeudCritique le noeud critique du balancement
+     * \brief Sépare un jeton du fichier de dictionnaire en flexion et traits
+     *
+     * \param[in] jeton la flexion, suivie ou non de ':' et des codes de ses traits (ex. grands:mp, poursuivrons:1pF)
+     * \param[out] forme la flexion
+     * \param[out] traits les traits, 0 s'il n'y en a pas
+     * \exception logic_error si un code de trait est inconnu
      */
-    void DicoSynonymes::_zigZagDroite(NoeudDicoSynonymes * & NoeudCritique)
+    void DicoSynonymes::_analyserFlexion(const std::string& jeton, std::string& forme, Traits& traits)
     {
-        _zigZigGauche(NoeudCritique->droit);
-        _zigZigDroite(NoeudCritique);
+        std::size_t separateur = jeton.find(':');
+        forme = jeton.substr(0, separateur);
+        traits = 0;
+        if (separateur == std::string::npos) return;
+        for (std::size_t i = separateur + 1; i < jeton.size(); i++)
+        {
+            switch (jeton[i])
+            {
+            case 'm': traits |= MASCULIN; break;
+            case 'f': traits |= FEMININ; break;
+            case 's': traits |= SINGULIER; break;
+            case 'p': traits |= PLURIEL; break;
+            case '1': traits |= PREMIERE_PERSONNE; break;
+            case '2': traits |= DEUXIEME_PERSONNE; break;
+            case '3': traits |= TROISIEME_PERSONNE; break;
+            case 'N': traits |= INFINITIF; break;
+            case 'P': traits |= PRESENT; break;
+            case 'I': traits |= IMPARFAIT; break;
+            case 'S': traits |= PASSE_SIMPLE; break;
+            case 'F': traits |= FUTUR; break;
+            case 'C': traits |= CONDITIONNEL; break;
+            case 'J': traits |= SUBJONCTIF; break;
+            case 'R': traits |= PARTICIPE; break;
+            default:
+                throw std::logic_error("DicoSynonymes::chargerDicoSynonyme: trait inconnu dans " + jeton);
+            }
+        }
     }
 
     /**
-     * \brief trouve le noeud qui contient le mot recherché
-     * \param[in] noeud le noeud qu'on vérifie s'il contient le mot recherché
-     * \param[in] mot le mot qu'on cherche
-     * \return le noeud qui contient le mot recherché s'il existe, sinon nullptr
+     * \brief Ajoute les synonymes d'une ligne de la section $ : le radical, puis les mots d'un même nouveau sens
      */
-    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_rechercherRadical(NoeudDicoSynonymes* noeud, const std::string& mot) const
+    void DicoSynonymes::_chargerSynonymes(const std::string& ligne)
     {
-        if (noeud != nullptr)
+        std::stringstream ss(ligne);
+        std::string radical, synonyme;
+        if (!(ss >> radical >> synonyme)) return; // ligne vide ou sans synonyme
+        int position = -1;
+        _ajouterSynonyme(radical, synonyme, position);
+        while (ss >> synonyme)
+            _ajouterSynonyme(radical, synonyme, position);
+    }
+
+    /**
+     * \brief Vérifie une section de synonymes gardée pour plus tard, puis en ajoute les mots qui ne sont pas des radicaux
+     *
+     * Les vérifications sont celles que _chargerSynonymes ferait ligne par ligne : chaque ligne
+     * commence par un radical (ou une flexion, comme _trouverNoeud), et un radical ne reçoit pas
+     * deux fois le même synonyme, en comptant ses sens déjà présents.
+     *
+     * \exception logic_error sinon; le dictionnaire est alors inchangé
+     */
+    void DicoSynonymes::_prelireSynonymes(std::string_view section)
+    {
+        auto mots = [](std::string_view ligne, std::vector<std::string_view>& resultat) {
+            resultat.clear();
+            for (std::size_t debut = ligne.find_first_not_of(" \t\r"); debut != std::string_view::npos;
+                 debut = ligne.find_first_not_of(" \t\r", debut))
+            {
+                std::size_t fin = std::min(ligne.find_first_of(" \t\r", debut), ligne.size());
+                resultat.push_back(ligne.substr(debut, fin - debut));
+                debut = fin;
+            }
+        };
+        std::vector<std::string_view> lignes;
+        for (std::size_t debut = 0; debut < section.size(); )
+        {
+            std::size_t fin = std::min(section.find('\n', debut), section.size());
+            lignes.push_back(section.substr(debut, fin - debut));
+            debut = fin + 1;
+        }
+
+        // Les mots qui deviendront des radicaux, dans l'ordre où ajouterSynonyme les insérerait, et
+        // les lignes de chaque radical (désigné par son texte, dans son noeud ou dans section)
+        std::unordered_set<std::string_view> nouveaux;
+        std::vector<std::string_view> aInserer;
+        std::unordered_map<std::string_view, std::vector<std::size_t> > lignesDuRadical;
+        std::vector<std::string_view> motsLigne;
+        for (std::size_t i = 0; i < lignes.size(); i++)
         {
-            auto itr = std::find(noeud->flexions.begin(), noeud->flexions.end(), mot);
-            if (mot == noeud->radical || itr != noeud->flexions.end())
+            mots(lignes[i], motsLigne);
+            if (motsLigne.size() < 2) continue; // ligne vide ou sans synonyme
+            std::string_view radical = motsLigne[0];
+            if (nouveaux.count(radical) == 0)
             {
-                return noeud;
+                const NoeudDicoSynonymes* noeud = _trouverNoeud(std::string(radical), false);
+                if (noeud == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
+                radical = noeud->radical;
             }
-            else if (mot < noeud->radical) // si le mot est plus petit on doit chercher à gauche
+            lignesDuRadical[radical].push_back(i);
+            for (std::size_t j = 1; j < motsLigne.size(); j++)
             {
-                return _rechercherRadical(noeud->gauche, mot);
+                if (_noeudDuRadical(motsLigne[j]) == nullptr && nouveaux.insert(motsLigne[j]).second) aInserer.push_back(motsLigne[j]);
             }
-            else // si le mot est plus grand on doit chercher à droite
+        }
+        for (const auto& lignesRadical : lignesDuRadical)
+        {
+            std::unordered_set<std::string_view> synonymes;
+            if (const NoeudDicoSynonymes* noeud = _noeudDuRadical(lignesRadical.first))
             {
-                return _rechercherRadical(noeud->droit, mot);
+                for (int numGroupe : noeud->appSynonymes)
+                {
+                    for (const auto id : groupesSynonymes.membres(numGroupe)) synonymes.insert(groupesSynonymes.mot(id));
+                }
+            }
+            for (std::size_t i : lignesRadical.second)
+            {
+                mots(lignes[i], motsLigne);
+                for (std::size_t j = 1; j < motsLigne.size(); j++)
+                {
+                    if (!synonymes.insert(motsLigne[j]).second) throw std::logic_error("Le synonyme existe déjà dans ce groupe");
+                }
+            }
+        }
+        for (std::string_view mot : aInserer) _insererAVL(racine, std::string(mot));
+    }
+
+    /**
+     * \brief Construit les groupes de la section des synonymes gardée au chargement, au premier appel
+     *
+     * Les mots de la section sont déjà des radicaux et les modifications construisent d'abord les
+     * groupes : la section est relue sur l'arbre où elle a été vérifiée, qui ne change pas. Seuls les
+     * groupes, les sens des noeuds et les tables qui en dépendent (chacune sous son verrou) sont
+     * écrits, sous le verrou de la section; les méthodes qui les lisent passent toutes par ici et
+     * attendent la fin de la construction, les autres (radicaux, flexions) n'en lisent rien. Si la
+     * construction échoue, rien n'en reste et le prochain appel recommence.
+     */
+    void DicoSynonymes::_lireSynonymesALaDemande() const
+    {
+        SynonymesALaDemande* section = synonymesALaDemande.get();
+        if (section == nullptr || section->lue.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> garde(section->verrou);
+        if (!section->lue.load(std::memory_order_relaxed)) _construireSynonymesALaDemande(*section);
+    }
+
+    /**
+     * \brief Relit la section et en construit les groupes
+     * \pre le verrou de section est tenu
+     * \exception runtime_error si la section ne peut pas être relue
+     * \exception bad_alloc s'il n'y a pas assez de mémoire; les groupes déjà construits sont alors retirés
+     */
+    void DicoSynonymes::_construireSynonymesALaDemande(SynonymesALaDemande& section) const
+    {
+        std::string texte;
+        if (section.chemin.empty()) texte = section.texte; // gardé jusqu'au succès, pour recommencer
+        else
+        {
+            std::ifstream fichier(section.chemin, std::ios::binary);
+            struct stat etat;
+            if (!fichier || stat(section.chemin.c_str(), &etat) != 0 || std::uint64_t(etat.st_size) != section.tailleFichier)
+                throw std::runtime_error("DicoSynonymes: " + section.chemin + " a changé depuis son chargement");
+            fichier.seekg(std::streamoff(section.debut));
+            texte.assign(std::istreambuf_iterator<char>(fichier), std::istreambuf_iterator<char>());
+            if (fichier.bad() || texte.size() != section.tailleFichier - section.debut)
+                throw std::runtime_error("DicoSynonymes: erreur de lecture de " + section.chemin);
+        }
+        // les groupes font partie de l'état du dictionnaire, comme s'ils avaient été lus au chargement
+        DicoSynonymes* dico = const_cast<DicoSynonymes*>(this);
+        int groupesAvant = groupesSynonymes.nombreGroupes(); // la section ne fait que créer des groupes
+        try
+        {
+            std::string ligne;
+            for (std::size_t debut = 0; debut < texte.size(); )
+            {
+                std::size_t fin = std::min(texte.find('\n', debut), texte.size());
+                ligne.assign(texte, debut, fin - debut);
+                dico->_chargerSynonymes(ligne);
+                debut = fin + 1;
+            }
+        }
+        catch (...)
+        {
+            // les sens ajoutés aux noeuds sont les derniers de chacun
+            for (NoeudDicoSynonymes* noeud : parcourArbre())
+            {
+                while (!noeud->appSynonymes.empty() && noeud->appSynonymes.back() >= groupesAvant) noeud->appSynonymes.pop_back();
+            }
+            dico->groupesSynonymes.tronquer(groupesAvant);
+            dico->_invaliderExpansions();
+            dico->_invaliderGraphe();
+            throw;
+        }
+        section.texte = std::string();
+        section.lue.store(true, std::memory_order_release);
+    }
+
+    /**
+     * \brief Construit les groupes d'une section gardée avant un nouveau chargement; une section qui
+     *        ne peut plus être relue est abandonnée, ses groupes ne seront jamais construits
+     */
+    void DicoSynonymes::_terminerSynonymesALaDemande()
+    {
+        try
+        {
+            _lireSynonymesALaDemande();
+        }
+        catch (const std::runtime_error&)
+        {
+            synonymesALaDemande.reset(); // le fichier a changé : le nouveau chargement la remplace
+        }
+        catch (const std::logic_error&)
+        {
+            synonymesALaDemande.reset();
+        }
+    }
+
+    /**
+     * \brief Crée les noeuds d'une tranche de la section des radicaux, triés par radical
+     * \param[in] texte le fichier entier
+     * \param[in] lignes le début de chaque ligne de la section, suivi de la position qui suit sa dernière ligne
+     * \param[in] premiere le rang de la première ligne de radical de la tranche
+     * \param[in] derniere le rang qui suit la dernière ligne de la tranche
+     * \exception logic_error si une flexion est répétée ou porte un trait inconnu; aucun noeud ne reste alors alloué
+     *
+     * N'utilise que texte et la ressource : peut être appelée par plusieurs fils à la fois.
+     */
+    std::vector<DicoSynonymes::NoeudDicoSynonymes*> DicoSynonymes::_analyserRadicaux(const std::string& texte,
+        const std::vector<std::size_t>& lignes, std::size_t premiere, std::size_t derniere) const
+    {
+        auto ligne = [&](std::size_t i) {
+            return std::string_view(texte).substr(lignes[i], lignes[i + 1] - 1 - lignes[i]); // sans le '\n'
+        };
+        std::vector<NoeudDicoSynonymes*> noeuds;
+        noeuds.reserve((derniere - premiere + 1) / 2);
+        try
+        {
+            std::string jeton;
+            std::vector<std::string> formes; // les flexions du radical, rangées en un seul paradigme
+            for (std::size_t i = premiere; i < derniere; i += 2)
+            {
+                noeuds.push_back(_nouveauNoeud(ligne(i)));
+                if (i + 1 == derniere) break; // dernier radical, sans ligne de flexions
+                std::string_view flexions = ligne(i + 1);
+                NoeudDicoSynonymes* noeud = noeuds.back();
+                formes.clear();
+                for (std::size_t debut = 0; debut < flexions.size(); )
+                {
+                    debut = flexions.find_first_not_of(" \t\r", debut);
+                    if (debut == std::string_view::npos) break;
+                    std::size_t fin = std::min(flexions.find_first_of(" \t\r", debut), flexions.size());
+                    jeton.assign(flexions.substr(debut, fin - debut));
+                    debut = fin;
+                    Traits traits;
+                    std::string forme;
+                    _analyserFlexion(jeton, forme, traits);
+                    if (std::find(formes.begin(), formes.end(), forme) != formes.end())
+                        throw std::logic_error("On ne peut pas avoir 2 fois la même flexion");
+                    if (traits != 0) _etiqueter(noeud, forme, traits);
+                    formes.push_back(std::move(forme));
+                }
+                noeud->flexions.assign(formes.begin(), formes.end());
+            }
+        }
+        catch (...)
+        {
+            for (NoeudDicoSynonymes* noeud : noeuds) _detruireNoeud(noeud);
+            throw;
+        }
+        std::sort(noeuds.begin(), noeuds.end(), [](const NoeudDicoSynonymes* a, const NoeudDicoSynonymes* b) {
+            return _inferieur(a->radical, b->radical);
+        });
+        return noeuds;
+    }
+
+    /**
+     * \brief Donne des traits à une flexion du noeud et l'ajoute à l'index des formes par traits
+     */
+    void DicoSynonymes::_etiqueter(NoeudDicoSynonymes* noeud, std::string_view flexion, Traits traits)
+    {
+        noeud->traits.insert_or_assign(std::pmr::string(flexion), traits); // la clé est recopiée dans la ressource du noeud
+        noeud->formeParTraits.emplace(traits, flexion); // la première flexion qui a ces traits est gardée
+    }
+
+    /**
+     * \brief Retire les traits d'une flexion du noeud; une autre flexion qui a les mêmes traits prend sa place dans l'index
+     */
+    void DicoSynonymes::_retirerEtiquette(NoeudDicoSynonymes* noeud, std::string_view flexion)
+    {
+        auto traits = noeud->traits.find(std::pmr::string(flexion));
+        if (traits == noeud->traits.end()) return;
+        Traits valeur = traits->second;
+        noeud->traits.erase(traits);
+        auto forme = noeud->formeParTraits.find(valeur);
+        if (forme == noeud->formeParTraits.end() || std::string_view(forme->second) != flexion) return;
+        noeud->formeParTraits.erase(forme);
+        for (const auto& autre : noeud->flexions) // dans l'ordre d'ajout, comme _etiqueter
+        {
+            auto traitsAutre = noeud->traits.find(autre);
+            if (traitsAutre != noeud->traits.end() && traitsAutre->second == valeur)
+            {
+                noeud->formeParTraits.emplace(valeur, autre);
+                break;
             }
         }
-        return nullptr;
     }
 
     /**
@@ -734,6 +2528,35 @@ namespace TP3
         }
     }
 
+    /**
+     * \brief Crée un noeud dans la ressource du dictionnaire
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_nouveauNoeud(std::string_view radical) const
+    {
+        std::pmr::polymorphic_allocator<NoeudDicoSynonymes> allocateur(ressource);
+        NoeudDicoSynonymes* noeud = allocateur.allocate(1);
+        try
+        {
+            new (noeud) NoeudDicoSynonymes(radical, paradigmes, ressource);
+        }
+        catch (...)
+        {
+            allocateur.deallocate(noeud, 1);
+            throw;
+        }
+        return noeud;
+    }
+
+    /**
+     * \brief Détruit un noeud créé par _nouveauNoeud et rend sa mémoire à la ressource
+     */
+    void DicoSynonymes::_detruireNoeud(NoeudDicoSynonymes* noeud) const
+    {
+        std::pmr::polymorphic_allocator<NoeudDicoSynonymes> allocateur(ressource);
+        noeud->~NoeudDicoSynonymes();
+        allocateur.deallocate(noeud, 1);
+    }
+
     /**
      * \brief détruit chaque noeud de l'arbre
      * \param[in] noeud le noeud à détruire
@@ -744,7 +2567,7 @@ namespace TP3
         {
             _auxDetruire(noeud->gauche); // appel récursif pour noeud gauche
             _auxDetruire(noeud->droit); // appel récursif pour noeud droite
-            delete noeud; // on détruit le noeud courant
+            _detruireNoeud(noeud); // on détruit le noeud courant
             noeud = nullptr;
         }
     }
@@ -755,14 +2578,14 @@ namespace TP3
      * \param[in] Radical le radical que l'on veut supprimer
      * \exception logic_error si le noeud qu'on veut supprimer n'existe pas
      */
-    void DicoSynonymes::_auxSupprimerAVL(NoeudDicoSynonymes*& noeud, const std::string& Radical)
+    void DicoSynonymes::_auxSupprimerAVL(NoeudDicoSynonymes*& noeud, std::string_view Radical)
     {
         if (noeud == nullptr) throw std::logic_error("Ce noeud n'existe pas");
-        if (Radical < noeud->radical) // si radical plus petit on continue à gauche
+        if (_inferieur(Radical, noeud->radical)) // si radical plus petit on continue à gauche
         {
             _auxSupprimerAVL(noeud->gauche, Radical);
         }
-        else if (noeud->radical < Radical) // si radical plus grand on continue à droite
+        else if (_inferieur(noeud->radical, Radical)) // si radical plus grand on continue à droite
         {
             _auxSupprimerAVL(noeud->droit, Radical);
         }
@@ -777,10 +2600,12 @@ namespace TP3
                 NoeudDicoSynonymes* ancienNoeud = noeud;
                 if (noeud->gauche != nullptr) {noeud = noeud->gauche;}
                 else {noeud = noeud->droit;}
-                delete ancienNoeud;
+                indexRadicaux.effacer(ancienNoeud->radical);
+                _detruireNoeud(ancienNoeud);
                 --nbRadicaux;
             }
         }
+        _miseAJourHauteurNoeud(noeud); // hauteur et taille du chemin de la suppression
         _balancerUnNoeud(noeud); // on garde l'arbre balancé
     }
      /**
@@ -790,23 +2615,20 @@ namespace TP3
     void DicoSynonymes::_enleverSuccMinDroite(NoeudDicoSynonymes* noeud)
     {
         NoeudDicoSynonymes* enfant = noeud->droit;
-        NoeudDicoSynonymes* parent = noeud;
         while (enfant->gauche != nullptr) // on continue jusqu'à ce qu'on trouve le plus petit enfant
         {
-            parent = enfant;
             enfant = enfant->gauche;
         }
+        std::string ancienRadical(noeud->radical);
         noeud->radical = enfant->radical;
         noeud->flexions = enfant->flexions;
+        noeud->traits = enfant->traits;
+        noeud->formeParTraits = enfant->formeParTraits;
         noeud->appSynonymes = enfant->appSynonymes;
-        if (parent->gauche == enfant)
-        {
-            _auxSupprimerAVL(parent->gauche, enfant->radical);
-        }
-        else
-        {
-            _auxSupprimerAVL(parent->droit, enfant->radical);
-        }
+        noeud->acces.store(enfant->acces.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _auxSupprimerAVL(noeud->droit, noeud->radical); // depuis noeud->droit : tout le chemin jusqu'au successeur est remis à jour
+        indexRadicaux.effacer(ancienRadical); // le successeur vit maintenant dans noeud
+        indexRadicaux.inserer(noeud->radical, noeud);
     }
 
     /**
@@ -830,4 +2652,304 @@ namespace TP3
         return vec;
     }
 
-}//Fin du namespace
\ No newline at end of file
+    /**
+     * \brief Copie en profondeur un arbre de radicaux
+     * \param[in] noeud la racine de l'arbre à copier
+     * \param[in] decalageGroupes la valeur ajoutée à chaque numéro de groupe de appSynonymes
+     * \return la racine de la copie
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_copierArbre(const NoeudDicoSynonymes* noeud, int decalageGroupes) const
+    {
+        if (noeud == nullptr) return nullptr;
+        NoeudDicoSynonymes* copie = _nouveauNoeud(noeud->radical);
+        copie->flexions = noeud->flexions;
+        copie->traits = noeud->traits;
+        copie->formeParTraits = noeud->formeParTraits;
+        for (int groupe : noeud->appSynonymes)
+        {
+            copie->appSynonymes.push_back(groupe + decalageGroupes);
+        }
+        copie->hauteur = noeud->hauteur;
+        copie->taille = noeud->taille;
+        copie->gauche = _copierArbre(noeud->gauche, decalageGroupes);
+        copie->droit = _copierArbre(noeud->droit, decalageGroupes);
+        return copie;
+    }
+
+    /**
+     * \brief Joint deux arbres AVL autour d'un noeud milieu
+     * \pre tous les radicaux de gauche < milieu->radical < tous les radicaux de droite
+     * \param[in] gauche l'arbre de gauche
+     * \param[in] milieu le noeud qui sépare les deux arbres
+     * \param[in] droite l'arbre de droite
+     * \return la racine de l'arbre AVL obtenu, en O(|hauteur(gauche) - hauteur(droite)|)
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_joindre(NoeudDicoSynonymes* gauche, NoeudDicoSynonymes* milieu,
+                                                             NoeudDicoSynonymes* droite)
+    {
+        if (_hauteur(gauche) > _hauteur(droite) + 1) // on descend le long de la branche droite de gauche
+        {
+            gauche->droit = _joindre(gauche->droit, milieu, droite);
+            _miseAJourHauteurNoeud(gauche);
+            _balancerUnNoeud(gauche);
+            return gauche;
+        }
+        if (_hauteur(droite) > _hauteur(gauche) + 1) // on descend le long de la branche gauche de droite
+        {
+            droite->gauche = _joindre(gauche, milieu, droite->gauche);
+            _miseAJourHauteurNoeud(droite);
+            _balancerUnNoeud(droite);
+            return droite;
+        }
+        milieu->gauche = gauche;
+        milieu->droit = droite;
+        _miseAJourHauteurNoeud(milieu);
+        return milieu;
+    }
+
+    /**
+     * \brief Joint deux arbres AVL sans noeud milieu
+     * \pre tous les radicaux de gauche < tous les radicaux de droite
+     * \return la racine de l'arbre AVL obtenu
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_joindre(NoeudDicoSynonymes* gauche, NoeudDicoSynonymes* droite)
+    {
+        if (gauche == nullptr) return droite;
+        if (droite == nullptr) return gauche;
+        NoeudDicoSynonymes* min = nullptr;
+        droite = _extraireMin(droite, min);
+        return _joindre(gauche, min, droite);
+    }
+
+    /**
+     * \brief Détache le plus petit noeud d'un arbre AVL en gardant celui-ci balancé
+     * \param[in] noeud la racine de l'arbre
+     * \param[out] min le noeud détaché
+     * \return la nouvelle racine de l'arbre
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_extraireMin(NoeudDicoSynonymes* noeud, NoeudDicoSynonymes*& min)
+    {
+        if (noeud->gauche == nullptr)
+        {
+            min = noeud;
+            NoeudDicoSynonymes* reste = noeud->droit;
+            noeud->droit = nullptr;
+            return reste;
+        }
+        noeud->gauche = _extraireMin(noeud->gauche, min);
+        _miseAJourHauteurNoeud(noeud);
+        _balancerUnNoeud(noeud);
+        return noeud;
+    }
+
+    /**
+     * \brief Scinde un arbre AVL selon une clé, en O(log n)
+     * \param[in] arbre l'arbre à scinder, qui est consommé
+     * \param[in] cle le radical selon lequel on scinde
+     * \param[out] gauche l'arbre AVL des radicaux plus petits que cle
+     * \param[out] egal le noeud dont le radical vaut cle, ou nullptr
+     * \param[out] droite l'arbre AVL des radicaux plus grands que cle
+     */
+    void DicoSynonymes::_scinder(NoeudDicoSynonymes* arbre, std::string_view cle, NoeudDicoSynonymes*& gauche,
+                                 NoeudDicoSynonymes*& egal, NoeudDicoSynonymes*& droite)
+    {
+        if (arbre == nullptr)
+        {
+            gauche = egal = droite = nullptr;
+            return;
+        }
+        NoeudDicoSynonymes* sousGauche = arbre->gauche;
+        NoeudDicoSynonymes* sousDroit = arbre->droit;
+        if (_inferieur(cle, arbre->radical))
+        {
+            NoeudDicoSynonymes* reste = nullptr;
+            _scinder(sousGauche, cle, gauche, egal, reste);
+            droite = _joindre(reste, arbre, sousDroit);
+        }
+        else if (_inferieur(arbre->radical, cle))
+        {
+            NoeudDicoSynonymes* reste = nullptr;
+            _scinder(sousDroit, cle, reste, egal, droite);
+            gauche = _joindre(sousGauche, arbre, reste);
+        }
+        else
+        {
+            arbre->gauche = arbre->droit = nullptr;
+            arbre->hauteur = 0;
+            arbre->taille = 1;
+            gauche = sousGauche;
+            egal = arbre;
+            droite = sousDroit;
+        }
+    }
+
+    /**
+     * \brief Union de deux arbres AVL par scission/jonction
+     * \param[in] arbre1 le premier arbre, consommé, dont les noeuds sont conservés en cas de doublon
+     * \param[in] arbre2 le second arbre, consommé
+     * \param[in] profondeur la profondeur de récursion, qui limite le nombre de tâches parallèles
+     * \param[out] nbDoublons le nombre de radicaux présents dans les deux arbres
+     * \return la racine de l'union
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_union(NoeudDicoSynonymes* arbre1, NoeudDicoSynonymes* arbre2,
+                                                           int profondeur, int& nbDoublons)
+    {
+        if (arbre1 == nullptr) return arbre2;
+        if (arbre2 == nullptr) return arbre1;
+        NoeudDicoSynonymes *gauche1, *egal, *droite1;
+        _scinder(arbre1, arbre2->radical, gauche1, egal, droite1);
+        NoeudDicoSynonymes* gauche2 = arbre2->gauche;
+        NoeudDicoSynonymes* droite2 = arbre2->droit;
+        NoeudDicoSynonymes *gauche, *droite;
+        int doublonsGauche = 0, doublonsDroite = 0;
+        if (_paralleliser(profondeur, arbre2))
+        {
+            auto tache = std::async(std::launch::async, [&]() {
+                return _union(gauche1, gauche2, profondeur + 1, doublonsGauche);
+            });
+            droite = _union(droite1, droite2, profondeur + 1, doublonsDroite);
+            gauche = tache.get();
+        }
+        else
+        {
+            gauche = _union(gauche1, gauche2, profondeur + 1, doublonsGauche);
+            droite = _union(droite1, droite2, profondeur + 1, doublonsDroite);
+        }
+        nbDoublons += doublonsGauche + doublonsDroite;
+        NoeudDicoSynonymes* milieu = arbre2;
+        if (egal != nullptr) // le radical est dans les deux arbres: on garde le noeud de arbre1 en le complétant
+        {
+            for (const auto& flexion : arbre2->flexions)
+            {
+                if (egal->flexions.trouver(flexion) == egal->flexions.end())
+                {
+                    egal->flexions.push_back(flexion);
+                    auto traits = arbre2->traits.find(flexion);
+                    if (traits != arbre2->traits.end()) _etiqueter(egal, flexion, traits->second);
+                }
+            }
+            for (int groupe : arbre2->appSynonymes)
+            {
+                if (std::find(egal->appSynonymes.begin(), egal->appSynonymes.end(), groupe) == egal->appSynonymes.end())
+                    egal->appSynonymes.push_back(groupe);
+            }
+            _detruireNoeud(arbre2);
+            milieu = egal;
+            nbDoublons++;
+        }
+        return _joindre(gauche, milieu, droite);
+    }
+
+    /**
+     * \brief Différence de deux arbres AVL par scission/jonction
+     * \param[in] arbre1 l'arbre duquel on retire les radicaux, consommé
+     * \param[in] arbre2 l'arbre des radicaux à retirer, inchangé
+     * \param[in] profondeur la profondeur de récursion, qui limite le nombre de tâches parallèles
+     * \param[out] nbRetires le nombre de noeuds de arbre1 détruits
+     * \return la racine de la différence
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_difference(NoeudDicoSynonymes* arbre1, const NoeudDicoSynonymes* arbre2,
+                                                                int profondeur, int& nbRetires)
+    {
+        if (arbre1 == nullptr) return nullptr;
+        if (arbre2 == nullptr) return arbre1;
+        NoeudDicoSynonymes *gauche1, *egal, *droite1;
+        _scinder(arbre1, arbre2->radical, gauche1, egal, droite1);
+        NoeudDicoSynonymes *gauche, *droite;
+        int retiresGauche = 0, retiresDroite = 0;
+        if (_paralleliser(profondeur, arbre2))
+        {
+            auto tache = std::async(std::launch::async, [&]() {
+                return _difference(gauche1, arbre2->gauche, profondeur + 1, retiresGauche);
+            });
+            droite = _difference(droite1, arbre2->droit, profondeur + 1, retiresDroite);
+            gauche = tache.get();
+        }
+        else
+        {
+            gauche = _difference(gauche1, arbre2->gauche, profondeur + 1, retiresGauche);
+            droite = _difference(droite1, arbre2->droit, profondeur + 1, retiresDroite);
+        }
+        nbRetires += retiresGauche + retiresDroite;
+        if (egal != nullptr)
+        {
+            _detruireNoeud(egal);
+            nbRetires++;
+        }
+        return _joindre(gauche, droite);
+    }
+
+    /**
+     * \brief Indique si les deux sous-problèmes d'une union ou d'une différence valent une tâche parallèle
+     * \param[in] profondeur la profondeur de récursion courante
+     * \param[in] noeud la racine du sous-arbre qui guide la récursion
+     * \return true s'il reste des coeurs à occuper, que le sous-arbre est assez gros et que
+     *         les noeuds viennent de new/delete (une autre ressource n'est en général pas synchronisée)
+     */
+    bool DicoSynonymes::_paralleliser(int profondeur, const NoeudDicoSynonymes* noeud) const
+    {
+        if (ressource != std::pmr::new_delete_resource()) return false;
+        static const int profondeurMax = [] {
+            unsigned int coeurs = std::thread::hardware_concurrency();
+            int p = 0;
+            while ((1u << p) < coeurs) p++;
+            return p; // 2^p tâches suffisent à occuper tous les coeurs
+        }();
+        const int hauteurMin = 10; // environ un millier de noeuds, sous quoi une tâche coûte plus qu'elle ne rapporte
+        return profondeur < profondeurMax && noeud->hauteur >= hauteurMin;
+    }
+
+    /**
+     * \brief Construit un arbre parfaitement équilibré à partir de noeuds triés
+     * \param[in] noeuds les noeuds triés par radical
+     * \param[in] debut le premier noeud du sous-arbre
+     * \param[in] fin la position qui suit le dernier noeud du sous-arbre
+     * \return la racine du sous-arbre, dont les hauteurs et les tailles sont à jour
+     */
+    DicoSynonymes::NoeudDicoSynonymes* DicoSynonymes::_construireEquilibre(std::vector<NoeudDicoSynonymes*>& noeuds, int debut, int fin)
+    {
+        if (debut >= fin) return nullptr;
+        int milieu = debut + (fin - debut) / 2;
+        NoeudDicoSynonymes* noeud = noeuds[milieu];
+        noeud->gauche = _construireEquilibre(noeuds, debut, milieu);
+        noeud->droit = _construireEquilibre(noeuds, milieu + 1, fin);
+        _miseAJourHauteurNoeud(noeud);
+        return noeud;
+    }
+
+    /**
+     * \brief Détruit tous les radicaux et groupes de synonymes
+     */
+    void DicoSynonymes::_vider()
+    {
+        _auxDetruire(racine); // chaque noeud rend la référence de son paradigme
+        indexRadicaux.vider();
+        cacheRadicaux.vider();
+        _invaliderExpansions();
+        _invaliderGraphe();
+        _invaliderSimilitude();
+        arbreLecture.clear();
+        nbRadicaux = 0;
+        groupesSynonymes.vider();
+        synonymesALaDemande.reset(); // ses groupes ne sont plus voulus
+    }
+
+    /**
+     * \brief Ajoute une modification au journal, s'il est activé
+     */
+    void DicoSynonymes::_journaliser(JournalDicoSynonymes::Operation operation, const std::string& mot1,
+                                     const std::string& mot2, int numGroupe)
+    {
+        if (journal) journal->ajouter(operation, mot1, mot2, numGroupe);
+    }
+
+    /**
+     * \brief Attend la fin de la compaction en cours, s'il y en a une
+     * \exception runtime_error si la compaction a échoué
+     */
+    void DicoSynonymes::_attendreCompaction()
+    {
+        if (compaction.valid()) compaction.get();
+    }
+
+}//Fin du namespace
@@ -17,11 +17,34 @@
 #include <vector>
 #include <list>
 #include <queue>
+#include <memory>
+#include <array>
+#include <atomic>
+#include <memory_resource>
+#include <string_view>
+#include <future>
+#include <cstdint>
+#include <optional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "JournalDicoSynonymes.h"
+#include "PolitiquesDico.h"
+#include "IndexRadicaux.h"
+#include "CacheRadicaux.h"
+#include "GrapheSynonymes.h"
+#include "GroupesSynonymes.h"
+#include "IndexSimilitude.h"
+#include "AutomatePhrases.h"
+#include "TransducteurFlexions.h"
+#include "ParadigmesFlexions.h"
 
 #ifndef _DICOSYNONYMES__H
 #define _DICOSYNONYMES__H
 
 namespace TP3
+{
+inline namespace DICO_POLITIQUES // Voir PolitiquesDico.h.
 {
 
    /**
@@ -29,11 +52,48 @@ namespace TP3
    *
    * \brief classe représentant un dictionnaire des synonymes
    *
+   * Compilé avec DICO_SANS_CASSE, le dictionnaire ignore la casse ASCII des radicaux; avec
+   * DICO_SANS_INDEX_HACHAGE, il n'a pas d'index de hachage et cherche ses radicaux dans l'arbre.
+   * Toutes les unités d'un programme doivent utiliser les mêmes macros; sinon l'édition des
+   * liens échoue (voir DICO_POLITIQUES).
+   *
+   * Ces politiques sont des interrupteurs de compilation, pas des paramètres de modèle : un
+   * programme n'a qu'un seul DicoSynonymes, l'ordre se limite à OrdreBinaire et OrdreSansCasse
+   * (pas de comparateur fourni par l'appelant) et la mémoire se choisit à l'exécution par la
+   * memory_resource du constructeur, pas par un type d'allocateur.
+   *
    */
    class DicoSynonymes
    {
    public:
 
+      /**
+      * \brief Traits grammaticaux d'une flexion, une combinaison de bits de TraitFlexion (0 : non étiquetée)
+      */
+      typedef std::uint32_t Traits;
+
+      /**
+      * \brief Les traits possibles et leur code dans le fichier de dictionnaire (flexion:codes, ex. grands:mp)
+      */
+      enum TraitFlexion : Traits
+      {
+         MASCULIN = 1u << 0,            // m
+         FEMININ = 1u << 1,             // f
+         SINGULIER = 1u << 2,           // s
+         PLURIEL = 1u << 3,             // p
+         PREMIERE_PERSONNE = 1u << 4,   // 1
+         DEUXIEME_PERSONNE = 1u << 5,   // 2
+         TROISIEME_PERSONNE = 1u << 6,  // 3
+         INFINITIF = 1u << 7,           // N
+         PRESENT = 1u << 8,             // P
+         IMPARFAIT = 1u << 9,           // I
+         PASSE_SIMPLE = 1u << 10,       // S
+         FUTUR = 1u << 11,              // F
+         CONDITIONNEL = 1u << 12,       // C
+         SUBJONCTIF = 1u << 13,         // J
+         PARTICIPE = 1u << 14           // R
+      };
+
       /*
       *\brief     Constructeur
       *
@@ -56,6 +116,20 @@ namespace TP3
       */
       DicoSynonymes(std::ifstream &fichier);
 
+      /*
+      *\brief  Constructeur d'un dictionnaire vide dont la mémoire vient de ressource
+      *
+      *\pre    ressource survit au dictionnaire
+      *
+      *\post   Les noeuds, leurs chaînes, leurs listes de flexions et les groupes de synonymes
+      *        sont alloués dans ressource (par exemple un std::pmr::monotonic_buffer_resource
+      *        pour un dictionnaire de la durée d'une requête).
+      *\post   Si abandonnerNoeuds, le destructeur ne détruit pas les noeuds un à un : leur mémoire
+      *        est rendue d'un coup avec celle de ressource. À n'utiliser qu'avec une ressource
+      *        qui libère tout à sa destruction (monotonic_buffer_resource, pools).
+      */
+      explicit DicoSynonymes(std::pmr::memory_resource* ressource, bool abandonnerNoeuds = false);
+
 
       /*
       *\brief     Destructeur.
@@ -85,10 +159,12 @@ namespace TP3
       *
       *\post   La flexion est ajoutée au dictionnaire des synonymes.
       *
+      *\post   Si traits n'est pas 0, la flexion est étiquetée avec ces traits.
+      *
       *\exception bad_alloc si il n'y a pas suffisament de mémoire.
       *\exception logic_error si motFlexion existe déjà ou motRadical n'existe pas.
       */
-      void ajouterFlexion(const std::string& motRadical, const std::string& motFlexion);
+      void ajouterFlexion(const std::string& motRadical, const std::string& motFlexion, Traits traits = 0);
 
       /*
       *\brief  Ajouter un synonyme (motSynonyme) d'un radical (motRadical)
@@ -100,6 +176,8 @@ namespace TP3
       *\post   Le synonyme est ajouté au dictionnaire des synonymes
       *\       Si numGroupe vaut –1, le synonyme est ajouté dans un nouveau groupe de synonymes
       *\       et retourne le numéro de ce nouveau groupe dans numgroupe par référence.
+      *\       Si un autre radical a déjà mis motSynonyme dans ce groupe, le groupe, qui ne garde
+      *\       qu'une fois chaque mot, est inchangé; le radical en prend tout de même le sens.
       *
       *\exception bad_alloc si il n'y a pas suffisament de mémoire
       *\exception logic_error si motSynonyme est déjà dans la liste des synonymes du motRadical
@@ -164,6 +242,33 @@ namespace TP3
       */
       int nombreRadicaux() const;
 
+      /**
+      * \brief Donne le nombre de radicaux plus petits que mot, soit la position de mot dans l'ordre
+      *        alphabétique s'il est un radical du dictionnaire, en O(log n)
+      *
+      * \post Le dictionnaire reste inchangé.
+      */
+      int rang(const std::string& mot) const;
+
+      /**
+      * \brief Donne le radical de position k dans l'ordre alphabétique (le premier est en position 0), en O(log n)
+      *
+      * \pre 0 <= k < nombreRadicaux()
+      * \post Le dictionnaire reste inchangé.
+      * \exception logic_error si la position n'existe pas
+      */
+      std::string kieme(int k) const;
+
+      /**
+      * \brief Donne au plus nombre radicaux consécutifs, dans l'ordre alphabétique, à partir de la position debut,
+      *        en O(log n + nombre) sans parcourir tout l'arbre
+      *
+      * \post Le dictionnaire reste inchangé.
+      * \return les radicaux des positions [debut, debut + nombre) qui existent, aucun si debut >= nombreRadicaux()
+      * \exception logic_error si debut ou nombre est négatif
+      */
+      std::vector<std::string> page(int debut, int nombre) const;
+
       /**
       * \brief Affiche à l'écran l'arbre niveau par niveau de façon à voir si l'arbre
       * est bien balancé.
@@ -218,11 +323,53 @@ namespace TP3
       * \pre p_fichier est ouvert
       *
       * \post Le dictionnaire est initialisé.
+      * \post Une flexion écrite flexion:codes (ex. grands:mp) est étiquetée avec les traits de ses codes,
+      *       voir TraitFlexion.
       *
       * \exception invalid_argument si p_fichier n'est pas ouvert
       *
+      * Avec synonymesALaDemande, la section des synonymes est gardée telle quelle et ses groupes ne
+      * sont construits qu'à la première méthode qui en a besoin, comme avec chargerEnParallele; le
+      * flux ne pouvant pas être relu, le texte de la section reste en mémoire jusque-là.
+      */
+      void chargerDicoSynonyme(std::ifstream & p_fichier, bool synonymesALaDemande = false);
+
+      /**
+      * \brief Charge un fichier de dictionnaire en analysant ses radicaux sur plusieurs fils
+      *
+      * \param[in] chemin le fichier, au format de chargerDicoSynonyme
+      * \param[in] nbFils le nombre de fils d'analyse, 0 pour un par coeur
+      *
+      * \post Les radicaux et flexions du fichier sont ajoutés au dictionnaire, puis ses synonymes.
+      *       Dans un dictionnaire vide, le résultat est celui de chargerDicoSynonyme; sinon les
+      *       radicaux déjà présents reçoivent les flexions qui leur manquent, comme avec fusionner.
+      *
+      * \exception runtime_error si le fichier ne peut pas être lu
+      * \exception logic_error si le fichier contient deux fois un radical ou une flexion d'un radical,
+      *            ou un trait inconnu; le dictionnaire est alors inchangé
+      *
+      * Le fichier est lu d'un bloc et sa section de radicaux (paires ligne de radical, ligne de
+      * flexions, jusqu'à la ligne $) est découpée en tranches d'un nombre pair de lignes. Chaque
+      * fil en fait une suite de noeuds triée; les suites sont fusionnées puis assemblées en un
+      * arbre parfaitement équilibré en O(n). Les synonymes, qui renvoient aux radicaux, sont
+      * ajoutés ensuite, ligne par ligne.
+      *
+      * Avec synonymesALaDemande, seuls les mots de la section des synonymes sont lus au chargement
+      * (ceux qui ne sont pas des radicaux le deviennent, comme avec ajouterSynonyme) : les groupes
+      * et les sens des radicaux ne sont construits, en relisant la section dans le fichier, qu'à la
+      * première méthode qui en a besoin (getNombreSens, getSens, getSynonymes, expansion, etc.),
+      * une seule fois même si plusieurs fils l'appellent ensemble. La section est vérifiée au
+      * chargement (logic_error, le dictionnaire gardant alors ses radicaux) : le mode à la demande
+      * refuse les mêmes fichiers que le chargement complet. Les modifications construisent d'abord
+      * les groupes, pour que la section soit relue sur les radicaux où elle a été vérifiée. Si le
+      * fichier a changé entre-temps, la méthode lance runtime_error; une construction qui échoue ne
+      * laisse aucun groupe et la méthode suivante réessaie. Un nouveau chargement abandonne une
+      * section qui ne peut plus être relue. Fils d'exécution : les méthodes const peuvent être
+      * appelées ensemble comme sans ce mode; celle qui construit les groupes le fait sous un verrou
+      * que toutes les méthodes qui lisent les groupes attendent, et ne change ni l'arbre ni les
+      * flexions. Sans effet si le journal est activé.
       */
-      void chargerDicoSynonyme(std::ifstream & p_fichier);
+      void chargerEnParallele(const std::string& chemin, unsigned int nbFils = 0, bool synonymesALaDemande = false);
 
       /**
       * \brief Retourne le radical du mot entré en paramètre
@@ -231,6 +378,8 @@ namespace TP3
       *
       * \post Le dictionnaire reste inchangé.
       * \post Le radical est retournée.
+      * \post La réponse, positive ou négative, est retenue dans un cache borné jusqu'à ce qu'une
+      *       modification des flexions de mot ou des radicaux la rende périmée.
       *
       * \exception logic_error si l'arbre est vide
       * \exception logic_error si la flexion n'est pas dans la liste de flexions du radical
@@ -269,6 +418,23 @@ namespace TP3
       */
       std::string getSens(std::string radical, int position) const;
 
+      /**
+      * \brief Choisit, sans demander à l'utilisateur, le sens du radical qui convient le mieux aux mots qui l'entourent
+      *
+      * Chaque groupe de synonymes a une signature de 512 bits : un bit par mot du groupe (ses
+      * synonymes, les radicaux qui ont ce sens et leurs flexions), choisi par hachage. Le score
+      * d'un sens est le nombre de bits communs à sa signature et à celle du contexte (ET puis
+      * popcount sur 8 mots de 64 bits).
+      *
+      * \param[in] radical le radical dont on choisit le sens
+      * \param[in] contexte les mots voisins, normalisés comme le dictionnaire (voir decouper)
+      * \post Les signatures (64 octets par groupe) sont calculées au premier appel, puis après
+      *       chaque modification du dictionnaire.
+      * \return la position du sens de plus grand score, le premier en cas d'égalité (0 si aucun
+      *         mot du contexte n'est reconnu), ou -1 si le radical n'existe pas ou n'a aucun sens
+      */
+      int choisirSens(const std::string& radical, const std::vector<std::string>& contexte) const;
+
 
       /**
       * \brief Donne tous les synonymes du mot entré en paramètre du groupeSynonyme du parametre position
@@ -288,6 +454,181 @@ namespace TP3
       */
       std::vector<std::string> getFlexions(std::string radical) const;
 
+      /**
+      * \brief Comme rechercherRadical, sans exception : donne le radical de mot, s'il en a un
+      *
+      * \post Le dictionnaire reste inchangé.
+      * \post Un mot absent déjà vu ne coûte ni exception ni allocation (voir le cache de rechercherRadical).
+      *
+      * \return le radical, ou std::nullopt si l'arbre est vide ou si mot n'est la flexion d'aucun radical
+      */
+      std::optional<std::string> essayerRechercherRadical(const std::string& mot) const;
+
+      /**
+      * \brief Comme getNombreSens, sans exception
+      * \return le nombre de sens, ou std::nullopt si le radical n'existe pas
+      */
+      std::optional<int> essayerNombreSens(const std::string& radical) const;
+
+      /**
+      * \brief Comme getSens, sans exception
+      * \return le premier synonyme du sens, ou std::nullopt si le radical, la position ou le groupe n'est pas valide
+      */
+      std::optional<std::string> essayerSens(const std::string& radical, int position) const;
+
+      /**
+      * \brief Comme getSynonymes, sans exception
+      * \return les synonymes du sens, ou std::nullopt si le radical, la position ou le groupe n'est pas valide
+      */
+      std::optional<std::vector<std::string> > essayerSynonymes(const std::string& radical, int position) const;
+
+      /**
+      * \brief Comme getFlexions, sans exception
+      * \return les flexions, ou std::nullopt si le radical n'existe pas
+      */
+      std::optional<std::vector<std::string> > essayerFlexions(const std::string& radical) const;
+
+      /**
+      * \brief Une forme de remplacement : une flexion d'un synonyme
+      */
+      struct Candidat
+      {
+         std::string synonyme;
+         std::string forme;
+         Traits traits;
+      };
+
+      /**
+      * \brief Tout ce qu'il faut pour réécrire une flexion, d'un seul bloc
+      *
+      * Les candidats sont rangés sens après sens : ceux du sens i sont
+      * candidats[debutSens[i], debutSens[i + 1]), et sens[i] est ce que donnerait getSens(radical, i).
+      */
+      struct Expansion
+      {
+         std::string radical;
+         std::vector<std::string> sens;
+         std::vector<std::uint32_t> debutSens;   // nombre de sens + 1 bornes
+         std::vector<Candidat> candidats;
+      };
+
+      /**
+      * \brief Donne l'expansion d'une flexion : son radical et les formes qui peuvent la remplacer, par sens
+      *
+      * \post La table des expansions est construite au premier appel, puis seules les entrées touchées
+      *       par les modifications depuis l'appel précédent sont recalculées.
+      *
+      * \return l'expansion, valide jusqu'à la prochaine modification du dictionnaire,
+      *         ou nullptr si mot n'est la flexion d'aucun radical
+      */
+      const Expansion* expansion(const std::string& mot) const;
+
+      /**
+      * \brief Donne le numéro du radical d'une flexion, lu dans le transducteur figé des flexions
+      *
+      * Le numéro est la position du radical dans l'ordre alphabétique : kieme(numero) redonne le radical.
+      * Le transducteur (voir TransducteurFlexions) associe chaque flexion au radical que retournerait
+      * rechercherRadical, et se lit octet par octet sans allocation.
+      *
+      * \post Le transducteur est construit au premier appel, puis après chaque ajout ou retrait de
+      *       radical ou de flexion.
+      * \return le numéro du radical, ou -1 si mot n'est la flexion d'aucun radical
+      */
+      int numeroRadical(std::string_view mot) const;
+
+      /**
+      * \brief Un morceau de texte à réécrire d'un bloc : un mot, ou une expression de plusieurs mots du dictionnaire
+      */
+      struct Segment
+      {
+         std::size_t debut;       // Position dans le texte.
+         std::size_t longueur;    // Nombre d'octets, espaces et ponctuation entre les mots d'une expression compris.
+         std::string cle;         // Forme normalisée, les mots d'une expression joints par '_', à donner à expansion().
+      };
+
+      /**
+      * \brief Découpe un texte en segments : d'abord les expressions de plusieurs mots, puis les mots seuls
+      *
+      * Une flexion qui contient '_' (pommes_de_terre) est une expression. Les mots du texte sont
+      * découpés par tokeniser et normalisés par normaliser; un automate d'Aho-Corasick sur ces mots
+      * trouve en une passe toutes les expressions, et à chaque position la plus longue est retenue
+      * si elle ne chevauche pas une expression déjà retenue plus à gauche. Les autres mots forment
+      * chacun un segment.
+      *
+      * \post L'automate est construit au premier appel, puis après chaque modification d'une flexion
+      *       qui contient '_'.
+      * \return les segments, dans l'ordre du texte
+      */
+      std::vector<Segment> decouper(const std::string& texte) const;
+
+      /**
+      * \brief Remplace chaque mot ou expression connus du texte par la première forme du sens que
+      *        choisirSens retient d'après les mots voisins, de mêmes traits que le mot s'il est étiqueté
+      *
+      * Les espaces et la ponctuation sont conservés; les mots inconnus, ou dont le sens retenu n'a
+      * aucune forme, restent tels quels.
+      *
+      * \return le texte transformé
+      */
+      std::string transformer(const std::string& texte) const;
+
+      /**
+      * \brief Donne les traits d'une flexion d'un radical
+      *
+      * \return les traits, 0 si la flexion n'est pas étiquetée
+      * \exception logic_error si le radical ou la flexion n'existe pas
+      */
+      Traits getTraits(const std::string& radical, const std::string& flexion) const;
+
+      /**
+      * \brief Donne la flexion de synonyme qui a les mêmes traits que flexion
+      *
+      * Le radical de flexion est celui que retourne rechercherRadical. Les traits doivent être
+      * identiques (même combinaison de bits); la recherche se fait en O(1).
+      *
+      * \return la flexion correspondante, ou std::nullopt si flexion est inconnue ou non étiquetée,
+      *         si synonyme n'est pas un radical, ou s'il n'a pas de flexion avec ces traits
+      */
+      std::optional<std::string> flexionCorrespondante(const std::string& flexion, const std::string& synonyme) const;
+
+      /**
+      * \brief Donne les mots à au plus profondeur groupes de synonymes de mot (synonymes de synonymes, etc.)
+      *
+      * Deux mots sont voisins s'ils sont dans un même groupe, le radical qui a ce sens compris.
+      *
+      * \post Le graphe des synonymes est construit au premier appel, puis tenu à jour par
+      *       ajouterSynonyme et supprimerSynonyme.
+      * \return les mots, du plus proche au plus éloigné, sans mot lui-même; vide si mot n'a pas de synonyme
+      */
+      std::vector<std::string> synonymesProches(const std::string& mot, int profondeur) const;
+
+      /**
+      * \brief Donne le numéro de la composante connexe du graphe des synonymes qui contient mot
+      *
+      * \return le numéro, ou -1 si mot n'est dans aucun groupe de synonymes
+      */
+      int composanteSynonymes(const std::string& mot) const;
+
+      /**
+      * \brief Donne le nombre de composantes connexes du graphe des synonymes
+      */
+      int nombreComposantesSynonymes() const;
+
+      /**
+      * \brief Donne les k mots qui ont le plus de synonymes directs, avec leur nombre de synonymes
+      */
+      std::vector<std::pair<std::string, int> > plusConnectes(int k) const;
+
+      /**
+      * \brief Donne les k radicaux les plus semblables à mot, au sens de similitude()
+      *
+      * \post L'index des radicaux par longueur est construit au premier appel, puis après
+      *       chaque ajout ou retrait de radical.
+      * \return au plus k paires (radical, similitude), de la plus grande similitude à la plus petite,
+      *         les égalités dans l'ordre alphabétique; mot lui-même en tête s'il est un radical
+      */
+      std::vector<std::pair<std::string, float> > plusSimilaires(const std::string& mot, std::size_t k) const;
+
 	  /**
 	  * \brief Indique si l'arbre est équilibré selon le facteur HB(1)
 	  *
@@ -297,6 +638,128 @@ namespace TP3
 	  */
 	  bool estArbreAVL() const;
 
+      /**
+      * \brief Ajoute au dictionnaire tous les radicaux, flexions et groupes de synonymes d'un autre dictionnaire
+      *
+      * \post Les radicaux de autre absents du dictionnaire y sont ajoutés, ceux déjà présents
+      *       reçoivent les flexions et les sens de autre qui leur manquent.
+      * \post Les groupes de synonymes de autre sont ajoutés à la fin de groupesSynonymes.
+      * \post autre reste inchangé; fusionner le dictionnaire avec lui-même ne fait rien.
+      *
+      * \exception bad_alloc s'il n'y a pas assez de mémoire
+      *
+      * L'union se fait par scission/jonction d'arbres AVL : O(m log(n/m + 1)), les deux
+      * sous-problèmes de chaque niveau étant traités en parallèle pour les grands arbres.
+      */
+      void fusionner(const DicoSynonymes& autre);
+
+      /**
+      * \brief Retire du dictionnaire tous les radicaux présents dans un autre dictionnaire
+      *
+      * \post Les radicaux de autre sont enlevés du dictionnaire, qui reste équilibré.
+      * \post autre reste inchangé; retirer le dictionnaire de lui-même le vide, groupes compris.
+      *
+      * La différence se fait par scission/jonction d'arbres AVL, comme fusionner.
+      */
+      void retirer(const DicoSynonymes& autre);
+
+      /**
+      * \brief Active ou désactive le comptage des accès à chaque radical
+      *
+      * \post activer : les compteurs repartent de 0, puis chaque radical trouvé par une requête
+      *       (getFlexions, getSens, getSynonymes, ...) compte un accès.
+      * \post désactiver : les compteurs gardent leur valeur, pour reorganiser.
+      */
+      void activerProfilage(bool activer);
+
+      /**
+      * \brief Construit, à partir des accès comptés, un arbre de lecture où les radicaux les plus
+      *        demandés sont près de la racine
+      *
+      * L'arbre est presque optimal (règle de Mehlhorn : la racine de chaque intervalle est le radical
+      * qui en coupe le poids en deux, le poids d'un radical étant ses accès + 1). Il est rangé dans
+      * un tableau, en préordre, et sert aux recherches exactes de radicaux tant que l'arbre AVL ne
+      * change pas de forme; un ajout ou un retrait de radical le défait.
+      *
+      * \post L'arbre AVL et son contenu sont inchangés.
+      * \post Avec l'index de hachage (par défaut), les radicaux sont déjà trouvés en O(1) sans descente :
+      *       l'arbre de lecture n'est construit que si le dictionnaire est compilé avec DICO_SANS_INDEX_HACHAGE.
+      */
+      void reorganiser();
+
+      /**
+      * \brief Écrit le dictionnaire dans un fichier d'index trié, lisible par DicoSynonymesDisque
+      *
+      * \post Le dictionnaire reste inchangé.
+      * \post Pour chaque flexion, l'index retient le radical que retournerait rechercherRadical.
+      *
+      * \exception runtime_error si le fichier ne peut pas être écrit
+      */
+      void sauvegarderIndex(const std::string& chemin) const;
+
+      /**
+      * \brief Remplace le contenu du dictionnaire par celui d'un fichier d'index
+      *
+      * \pre chemin a été produit par sauvegarderIndex ou par compacterJournal
+      *
+      * \post Le dictionnaire contient exactement les radicaux, flexions et groupes de l'index,
+      *       dans un arbre parfaitement équilibré construit en O(n).
+      *
+      * \exception runtime_error si le fichier ne peut pas être lu
+      * \exception logic_error si le fichier n'est pas un index valide
+      */
+      void chargerIndex(const std::string& chemin);
+
+      /**
+      * \brief Active la journalisation des modifications du dictionnaire
+      *
+      * \param[in] cheminJournal le fichier de journal, créé au besoin, où sont ajoutées les modifications
+      * \param[in] cheminInstantane le fichier d'index écrit par compacterJournal
+      * \param[in] tailleLot le nombre de modifications écrites par synchronisation sur disque
+      *
+      * \post Chaque modification réussie (ajouter/supprimer radical, flexion ou synonyme) est journalisée.
+      *       fusionner et retirer ne sont pas journalisées une à une : elles déclenchent compacterJournal.
+      * \post Une modification n'est durable qu'une fois son lot synchronisé (lot plein ou synchroniserJournal).
+      *
+      * \exception runtime_error si le journal ne peut pas être ouvert
+      */
+      void activerJournal(const std::string& cheminJournal, const std::string& cheminInstantane, std::size_t tailleLot = 64);
+
+      /**
+      * \brief Synchronise puis ferme le journal; les modifications suivantes ne sont plus journalisées
+      */
+      void desactiverJournal();
+
+      /**
+      * \brief Écrit sur disque les modifications journalisées en attente
+      *
+      * \pre Le journal est activé
+      * \exception logic_error si le journal n'est pas activé
+      */
+      void synchroniserJournal();
+
+      /**
+      * \brief Écrit un instantané du dictionnaire puis retire du journal les modifications qu'il contient
+      *
+      * \pre Le journal est activé
+      *
+      * \post Le dictionnaire est copié immédiatement; l'écriture de l'instantané et la troncature
+      *       du journal se font en arrière-plan, pendant que les modifications continuent d'être journalisées.
+      *
+      * \exception logic_error si le journal n'est pas activé
+      */
+      void compacterJournal();
+
+      /**
+      * \brief Reconstruit le dictionnaire à partir du dernier instantané et du journal
+      *
+      * \post Le dictionnaire contient l'instantané (s'il existe) auquel on a appliqué, dans l'ordre,
+      *       les modifications du journal qui lui sont postérieures.
+      *
+      * \exception logic_error si l'instantané n'est pas valide ou si une modification ne peut être rejouée
+      */
+      void recuperer(const std::string& cheminInstantane, const std::string& cheminJournal);
+
    private:
 
       /**
@@ -308,18 +771,97 @@ namespace TP3
       class NoeudDicoSynonymes
       {
       public:
-         std::string radical;             		// Un radical qui est un élément fondamental d'un mot, auquel s'ajoutent suffixes et préfixes.
-         std::list<std::string> flexions;   	// Une liste chaînée de chaîne de caractères représentant les flexions du radical.
-         std::vector<int> appSynonymes;   		// Un tableau contenant les indices (entiers) des groupes de synonymes auquel appartient le radical.
+         std::pmr::string radical;             	// Un radical qui est un élément fondamental d'un mot, auquel s'ajoutent suffixes et préfixes.
+         FlexionsRadical flexions;             	// Les flexions du radical : un paradigme partagé et les formes irrégulières.
+         std::pmr::vector<int> appSynonymes;   	// Un tableau contenant les indices (entiers) des groupes de synonymes auquel appartient le radical.
+         std::pmr::unordered_map<std::pmr::string, Traits> traits;         // Les traits des flexions étiquetées.
+         std::pmr::unordered_map<Traits, std::pmr::string> formeParTraits;  // Pour chaque combinaison de traits, une flexion qui l'a.
          int hauteur;                    		// La hauteur de ce noeud (afin de maintenir l'équilibre de l'arbre AVL).
+         int taille;                     		// Le nombre de noeuds du sous-arbre de ce noeud (pour rang, kieme et page).
+         std::atomic<std::uint32_t> acces;     	// Le nombre de fois que le radical a été trouvé depuis activerProfilage(true).
          NoeudDicoSynonymes *gauche, *droit;	// Les pointeurs sur les enfants du noeud.
-         NoeudDicoSynonymes(const std::string& m) : radical(m), hauteur(0), gauche(0), droit(0) { }
+         NoeudDicoSynonymes(std::string_view m, ParadigmesFlexions& paradigmes, std::pmr::memory_resource* ressource)
+            : radical(m, ressource), flexions(radical, paradigmes, ressource), appSynonymes(ressource), traits(ressource),
+              formeParTraits(ressource), hauteur(0), taille(1), acces(0), gauche(0), droit(0) { }
       };
 
+      // Politiques choisies à la compilation (voir PolitiquesDico.h).
+#if defined(DICO_SANS_CASSE)
+      typedef OrdreSansCasse Ordre;                          // Ordre des radicaux, dans l'arbre comme dans l'index.
+#else
+      typedef OrdreBinaire Ordre;
+#endif
+#if defined(DICO_SANS_INDEX_HACHAGE)
+      typedef SansIndex<NoeudDicoSynonymes> Index;          // Les radicaux sont cherchés dans l'arbre.
+#else
+      typedef IndexRadicaux<NoeudDicoSynonymes, Ordre> Index;
+#endif
+
+      std::pmr::memory_resource* ressource;                 // Mémoire des noeuds et des groupes.
+      bool abandonnerNoeuds;                                // true : le destructeur laisse les noeuds à ressource.
       NoeudDicoSynonymes *racine;                           // pointeur vers la racine de l'arbre des radicaux.
       int nbRadicaux;                                       // Nombre de noeuds dans l'arbre
-      std::vector< std::list<NoeudDicoSynonymes*> > groupesSynonymes;   // Tableau de groupes de synonymes dont chaque élément est une liste
-      	  	  	  	  	  	  	  	  	  	  	  	  	  	  	  	  	// de pointeurs sur des noeuds de l'arbre représentant les radicaux.
+      GroupesSynonymes groupesSynonymes;                    // Groupes de synonymes, chacun un tableau d'identifiants de mots.
+      mutable ParadigmesFlexions paradigmes;                // Paradigmes de flexion partagés par les radicaux, dans ressource.
+      Index indexRadicaux;                                  // Index de hachage radical -> noeud, pour les requêtes ponctuelles.
+      std::shared_ptr<JournalDicoSynonymes> journal;       // Journal des modifications, nul si la journalisation est désactivée.
+      std::string cheminInstantane;                         // Instantané écrit par compacterJournal.
+      std::future<void> compaction;                         // Compaction en arrière-plan, s'il y en a une.
+      mutable CacheRadicaux cacheRadicaux;                  // Résolutions récentes de rechercherRadical, y compris les échecs.
+
+      // Table des expansions, construite à la demande. Les modifications marquent les entrées à recalculer.
+      mutable std::mutex verrouExpansions;
+      mutable bool expansionsAJour;                                                           // false : tout reconstruire.
+      mutable std::unordered_map<std::string, Expansion> expansionsParRadical;
+      mutable std::unordered_map<std::string, const Expansion*> expansionsParFlexion;
+      mutable std::unordered_map<std::string, std::unordered_set<std::string> > radicauxParSynonyme; // Qui lit les flexions de ce mot.
+      mutable std::unordered_map<int, std::unordered_set<std::string> > radicauxParGroupe;          // Qui lit ce groupe.
+      mutable std::unordered_set<std::string> flexionsSales;                                  // Résolution à refaire.
+      mutable std::unordered_set<std::string> radicauxSales;                                  // Expansion à refaire.
+
+      mutable std::mutex verrouGraphe;
+      mutable GrapheSynonymes graphe;                       // Graphe des synonymes, construit à la demande.
+      mutable bool grapheAJour;                             // false : le reconstruire à partir des groupes.
+
+      mutable std::mutex verrouPhrases;
+      mutable AutomatePhrases automatePhrases;              // Flexions de plusieurs mots, pour decouper.
+      mutable bool phrasesAJour;                            // false : le reconstruire à partir de l'arbre.
+
+      typedef std::array<std::uint64_t, 8> Signature;      // 512 bits, un par mot haché.
+
+      mutable std::mutex verrouSignatures;
+      mutable std::vector<Signature> signaturesGroupes;     // Signature de chaque groupe de synonymes, pour choisirSens.
+      mutable bool signaturesAJour;                         // false : les recalculer à partir des groupes.
+
+      mutable std::mutex verrouTransducteur;
+      mutable TransducteurFlexions transducteurFlexions;    // Flexion -> numéro de son radical, pour numeroRadical.
+      mutable bool transducteurAJour;                       // false : le reconstruire à partir de l'arbre.
+
+      mutable std::mutex verrouSimilitude;
+      mutable IndexSimilitude indexSimilitude;              // Radicaux par longueur, pour plusSimilaires.
+      mutable bool similitudeAJour;                         // false : le reconstruire à partir de l'arbre.
+
+      // Arbre de lecture pondéré par les accès (voir reorganiser), vide s'il n'est pas à jour.
+      struct NoeudLecture
+      {
+         std::string_view radical;
+         NoeudDicoSynonymes* noeud;
+         std::int32_t gauche, droit;                        // Positions des enfants dans arbreLecture, -1 s'il n'y en a pas.
+      };
+      std::vector<NoeudLecture> arbreLecture;               // arbreLecture[0] est la racine.
+      bool profilage;                                       // true : _trouverNoeud compte les accès.
+
+      // Section des synonymes d'un fichier chargé avec synonymesALaDemande
+      struct SynonymesALaDemande
+      {
+         std::string chemin;                                // Vide : la section est dans texte (chargerDicoSynonyme).
+         std::uint64_t debut;                               // Position de la ligne qui suit $.
+         std::uint64_t tailleFichier;                       // Pour reconnaître un fichier modifié.
+         std::string texte;
+         std::mutex verrou;                                 // Tenu pendant la construction des groupes.
+         std::atomic<bool> lue{false};                      // Les groupes sont construits.
+      };
+      std::unique_ptr<SynonymesALaDemande> synonymesALaDemande; // Nul ou déjà lue : les groupes sont à jour.
 
     // Ajoutez vos méthodes privées ici !
 	// PS. Afin de faciliter la correction, il est important d'utiliser les même noms de méthodes privées du cours:
@@ -334,6 +876,13 @@ namespace TP3
 
        int _hauteur(NoeudDicoSynonymes* noeud) const;
 
+       int _taille(const NoeudDicoSynonymes* noeud) const;
+
+       std::int32_t _construireArbreLecture(const std::vector<NoeudDicoSynonymes*>& noeuds, const std::vector<std::uint64_t>& poidsCumules,
+                                            std::size_t debut, std::size_t fin);
+
+       NoeudDicoSynonymes* _chercherArbreLecture(std::string_view radical) const;
+
        bool _debalancementAGauche(NoeudDicoSynonymes * & Arbre) const;
 
        bool _debalancementADroite(NoeudDicoSynonymes * & Arbre) const;
@@ -352,19 +901,118 @@ namespace TP3
 
        NoeudDicoSynonymes* _rechercherRadical(NoeudDicoSynonymes* noeud, const std::string& mot) const;
 
+       NoeudDicoSynonymes* _trouverNoeud(const std::string& mot, bool compterAcces = true) const;
+
+       NoeudDicoSynonymes* _noeudDuRadical(std::string_view radical) const;
+
+       static bool _inferieur(std::string_view a, std::string_view b);
+
+       static bool _egal(std::string_view a, std::string_view b);
+
+       NoeudDicoSynonymes* _nouveauNoeud(std::string_view radical) const;
+
+       void _detruireNoeud(NoeudDicoSynonymes* noeud) const;
+
+       bool _resoudreRadical(const std::string& mot, std::string& radical) const;
+
+       void _meilleurRadical(const NoeudDicoSynonymes* noeud, const std::string& mot,
+                             float& similitudeMax, const NoeudDicoSynonymes*& choisi) const;
+
+       std::vector<std::pair<std::string, std::uint32_t> > _meilleursRadicaux(const std::vector<NoeudDicoSynonymes*>& noeuds) const;
+
+       const std::pmr::vector<std::uint32_t>* _groupeDuSens(const NoeudDicoSynonymes* noeud, int position) const;
+
+       void _construireExpansion(const NoeudDicoSynonymes* noeud, Expansion& expansion) const;
+
+       void _reconstruireExpansions() const;
+
+       void _mettreAJourExpansions() const;
+
+       void _marquerExpansions(const std::string& radical, const std::string& flexion = "", int numGroupe = -1);
+
+       void _invaliderExpansions();
+
+       GrapheSynonymes& _graphe() const;
+
+       void _modifierGraphe(int numGroupe, const std::string& mot, bool ajout);
+
+       void _invaliderGraphe();
+
+       void _invaliderSimilitude();
+
+       void _invaliderPhrases();
+
+       void _invaliderSignatures();
+
+       void _invaliderTransducteur();
+
+       void _calculerSignatures() const;
+
+       static void _marquerSignature(Signature& signature, std::string_view mot);
+
+       static void _analyserFlexion(const std::string& jeton, std::string& forme, Traits& traits);
+
+       void _chargerSynonymes(const std::string& ligne);
+
+       void _prelireSynonymes(std::string_view section);
+
+       void _lireSynonymesALaDemande() const;
+
+       void _construireSynonymesALaDemande(SynonymesALaDemande& section) const;
+
+       void _terminerSynonymesALaDemande();
+
+       void _ajouterSynonyme(const std::string& motRadical, const std::string& motSynonyme, int& numGroupe);
+
+       std::vector<NoeudDicoSynonymes*> _analyserRadicaux(const std::string& texte, const std::vector<std::size_t>& lignes,
+                                                          std::size_t premiere, std::size_t derniere) const;
+
+       static void _etiqueter(NoeudDicoSynonymes* noeud, std::string_view flexion, Traits traits);
+
+       static void _retirerEtiquette(NoeudDicoSynonymes* noeud, std::string_view flexion);
+
        void _parcourirArbre(NoeudDicoSynonymes* noeud, std::vector<NoeudDicoSynonymes*>& vec) const;
 
        void _auxDetruire(NoeudDicoSynonymes*& noeud);
 
-       void _auxSupprimerAVL(NoeudDicoSynonymes*& noeud, const std::string& Radical);
+       void _auxSupprimerAVL(NoeudDicoSynonymes*& noeud, std::string_view Radical);
 
        void _enleverSuccMinDroite(NoeudDicoSynonymes* noeud);
 
        int _amplitudeDuDebalancement(NoeudDicoSynonymes * Arbre) const;
 
        std::vector<NoeudDicoSynonymes*> parcourArbre() const ;
+
+       NoeudDicoSynonymes* _copierArbre(const NoeudDicoSynonymes* noeud, int decalageGroupes) const;
+
+       NoeudDicoSynonymes* _joindre(NoeudDicoSynonymes* gauche, NoeudDicoSynonymes* milieu, NoeudDicoSynonymes* droite);
+
+       NoeudDicoSynonymes* _joindre(NoeudDicoSynonymes* gauche, NoeudDicoSynonymes* droite);
+
+       NoeudDicoSynonymes* _extraireMin(NoeudDicoSynonymes* noeud, NoeudDicoSynonymes*& min);
+
+       void _scinder(NoeudDicoSynonymes* arbre, std::string_view cle, NoeudDicoSynonymes*& gauche,
+                     NoeudDicoSynonymes*& egal, NoeudDicoSynonymes*& droite);
+
+       NoeudDicoSynonymes* _union(NoeudDicoSynonymes* arbre1, NoeudDicoSynonymes* arbre2, int profondeur, int& nbDoublons);
+
+       NoeudDicoSynonymes* _difference(NoeudDicoSynonymes* arbre1, const NoeudDicoSynonymes* arbre2, int profondeur, int& nbRetires);
+
+       bool _paralleliser(int profondeur, const NoeudDicoSynonymes* noeud) const;
+
+       void _ecrireIndex(const std::string& chemin, std::uint64_t dernierEnregistrement) const;
+
+       NoeudDicoSynonymes* _construireEquilibre(std::vector<NoeudDicoSynonymes*>& noeuds, int debut, int fin);
+
+       void _vider();
+
+       void _journaliser(JournalDicoSynonymes::Operation operation, const std::string& mot1,
+                         const std::string& mot2 = "", int numGroupe = 0);
+
+       void _attendreCompaction();
    };
 
+}//Fin de l'espace des politiques
 }//Fin du namespace
 
 #endif
\ No newline at end of file
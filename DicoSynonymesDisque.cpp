@@ -0,0 +1,345 @@
+/**
+* \file DicoSynonymesDisque.cpp
+* \brief Le code du dictionnaire des synonymes adossé à un index projeté en mémoire.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "DicoSynonymesDisque.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TP3
+{
+      /**
+      * \brief Ouvre un fichier d'index produit par DicoSynonymes::sauvegarderIndex
+      *
+      * \param[in] chemin le chemin du fichier d'index
+      * \param[in] capaciteCache le nombre maximal de radicaux décodés gardés en mémoire
+      *
+      * \exception runtime_error si le fichier ne peut pas être ouvert ou projeté
+      * \exception logic_error si le fichier n'est pas un index valide
+      */
+    DicoSynonymesDisque::DicoSynonymesDisque(const std::string& chemin, std::size_t capaciteCache)
+        : fd(-1), base(nullptr), taille(0), capaciteCache(capaciteCache)
+    {
+        fd = ::open(chemin.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("DicoSynonymesDisque: impossible d'ouvrir " + chemin);
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(FormatIndex::Entete))
+        {
+            ::close(fd);
+            throw std::logic_error("DicoSynonymesDisque: le fichier n'est pas un index valide");
+        }
+        taille = info.st_size;
+        void* projection = ::mmap(nullptr, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (projection == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("DicoSynonymesDisque: impossible de projeter " + chemin);
+        }
+        base = static_cast<const char*>(projection);
+        ::madvise(projection, taille, MADV_RANDOM); // les recherches sautent d'une page à l'autre, pas de lecture anticipée
+
+        entete = reinterpret_cast<const FormatIndex::Entete*>(base);
+        if (std::memcmp(entete->magie, FormatIndex::MAGIE, 4) != 0 || (entete->version != 1 && entete->version != FormatIndex::VERSION)
+            || entete->taille != taille || entete->debutChaines > taille)
+        {
+            ::munmap(projection, taille);
+            ::close(fd);
+            throw std::logic_error("DicoSynonymesDisque: le fichier n'est pas un index valide");
+        }
+        tableRadicaux = reinterpret_cast<const FormatIndex::Radical*>(base + entete->debutRadicaux);
+        tableFlexions = reinterpret_cast<const FormatIndex::Flexion*>(base + entete->debutFlexions);
+        tableGroupes = reinterpret_cast<const std::uint64_t*>(base + entete->debutGroupes);
+        chaines = base + entete->debutChaines;
+    }
+
+      /**
+      * \brief Destructeur, libère la projection du fichier
+      */
+    DicoSynonymesDisque::~DicoSynonymesDisque()
+    {
+        ::munmap(const_cast<char*>(base), taille);
+        ::close(fd);
+    }
+
+      /**
+      * \brief Retourne le nombre de radicaux dans le dictionnaire
+      */
+    int DicoSynonymesDisque::nombreRadicaux() const
+    {
+        return entete->nbRadicaux;
+    }
+
+      /**
+      * \brief Retourne le radical du mot entré en paramètre, comme DicoSynonymes::rechercherRadical
+      *
+      * \exception logic_error si le dictionnaire est vide ou si mot n'est la flexion d'aucun radical
+      */
+    std::string DicoSynonymesDisque::rechercherRadical(const std::string& mot) const
+    {
+        if (entete->nbRadicaux == 0) throw std::logic_error("L'arbre est vide");
+        const FormatIndex::Flexion* fin = tableFlexions + entete->nbFlexions;
+        const FormatIndex::Flexion* itr = std::lower_bound(tableFlexions, fin, mot,
+                [this](const FormatIndex::Flexion& f, const std::string& m) { return _comparer(f.flexion, m) < 0; });
+        if (itr == fin || _comparer(itr->flexion, mot) != 0)
+            throw std::logic_error("La flexion n'existe pas pour ce radical");
+        return _chaine(tableRadicaux[itr->radical].radical);
+    }
+
+      /**
+      * \brief Donne le nombre de sens (groupes de synonymes) du radical
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+    int DicoSynonymesDisque::getNombreSens(const std::string& radical) const
+    {
+        return _enregistrement(radical).groupes.size();
+    }
+
+      /**
+      * \brief Donne le premier synonyme du groupe de synonymes à la position donnée du radical
+      *
+      * \exception logic_error si le radical ou la position n'existe pas, ou si le groupe est vide
+      */
+    std::string DicoSynonymesDisque::getSens(const std::string& radical, int position) const
+    {
+        std::vector<std::string> membres = getSynonymes(radical, position);
+        if (membres.empty()) throw std::logic_error("Le groupe de synonymes est vide");
+        return membres.front();
+    }
+
+      /**
+      * \brief Donne tous les synonymes du groupe de synonymes à la position donnée du radical
+      *
+      * \exception logic_error si le radical ou la position n'existe pas
+      */
+    std::vector<std::string> DicoSynonymesDisque::getSynonymes(const std::string& radical, int position) const
+    {
+        Enregistrement enregistrement = _enregistrement(radical);
+        if (position < 0 || position >= (int) enregistrement.groupes.size()) throw std::logic_error("La position n'existe pas");
+        std::uint32_t groupe = enregistrement.groupes[position];
+        if (groupe >= entete->nbGroupes) throw std::logic_error("Le numéro du groupe n'est pas correct");
+        return _membresGroupe(groupe);
+    }
+
+      /**
+      * \brief Donne toutes les flexions du radical
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+    std::vector<std::string> DicoSynonymesDisque::getFlexions(const std::string& radical) const
+    {
+        return _enregistrement(radical).flexions;
+    }
+
+      /**
+      * \brief Donne les traits de chaque flexion du radical, dans l'ordre de getFlexions (0 : non étiquetée)
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+    std::vector<std::uint32_t> DicoSynonymesDisque::getTraitsFlexions(const std::string& radical) const
+    {
+        return _enregistrement(radical).traits;
+    }
+
+      /**
+      * \brief Donne les numéros des groupes de synonymes (appSynonymes) du radical
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+    std::vector<int> DicoSynonymesDisque::groupes(const std::string& radical) const
+    {
+        std::vector<std::uint32_t> groupesRadical = _enregistrement(radical).groupes;
+        return std::vector<int>(groupesRadical.begin(), groupesRadical.end());
+    }
+
+      /**
+      * \brief Donne tous les radicaux, en ordre alphabétique
+      */
+    std::vector<std::string> DicoSynonymesDisque::radicaux() const
+    {
+        std::vector<std::string> resultat;
+        resultat.reserve(entete->nbRadicaux);
+        for (std::uint32_t i = 0; i < entete->nbRadicaux; i++)
+        {
+            resultat.push_back(_chaine(tableRadicaux[i].radical));
+        }
+        return resultat;
+    }
+
+      /**
+      * \brief Donne le nombre de groupes de synonymes
+      */
+    int DicoSynonymesDisque::nombreGroupes() const
+    {
+        return entete->nbGroupes;
+    }
+
+      /**
+      * \brief Donne les membres d'un groupe de synonymes
+      *
+      * \exception logic_error si le numéro de groupe n'est pas correct
+      */
+    std::vector<std::string> DicoSynonymesDisque::membresGroupe(int groupe) const
+    {
+        if (groupe < 0 || groupe >= (int) entete->nbGroupes) throw std::logic_error("Le numéro du groupe n'est pas correct");
+        return _membresGroupe(groupe);
+    }
+
+      /**
+      * \brief Donne le dernier enregistrement du journal contenu dans l'index, 0 s'il n'est pas un instantané
+      */
+    std::uint64_t DicoSynonymesDisque::dernierEnregistrement() const
+    {
+        return entete->dernierEnregistrement;
+    }
+
+      /**
+      * \brief Donne le nombre d'octets du fichier projeté présentement résidents en mémoire
+      *
+      * \post Le dictionnaire reste inchangé.
+      */
+    std::size_t DicoSynonymesDisque::octetsResidents() const
+    {
+        const std::size_t page = ::sysconf(_SC_PAGESIZE);
+        std::vector<unsigned char> residence((taille + page - 1) / page);
+        if (::mincore(const_cast<char*>(base), taille, residence.data()) != 0) return 0;
+        std::size_t nbPages = 0;
+        for (unsigned char p : residence)
+        {
+            nbPages += p & 1;
+        }
+        return nbPages * page;
+    }
+
+      /**
+      * \brief Donne la taille totale du fichier projeté, en octets
+      */
+    std::size_t DicoSynonymesDisque::tailleFichier() const
+    {
+        return taille;
+    }
+
+    /**
+     * \brief Copie une chaîne de la zone des chaînes
+     */
+    std::string DicoSynonymesDisque::_chaine(const FormatIndex::Chaine& c) const
+    {
+        return std::string(chaines + c.debut, c.longueur);
+    }
+
+    /**
+     * \brief Compare une chaîne de l'index à un mot sans la copier
+     * \return un entier négatif, nul ou positif selon que la chaîne précède, égale ou suit mot
+     */
+    int DicoSynonymesDisque::_comparer(const FormatIndex::Chaine& c, const std::string& mot) const
+    {
+        std::size_t n = std::min<std::size_t>(c.longueur, mot.size());
+        int resultat = std::memcmp(chaines + c.debut, mot.data(), n);
+        if (resultat != 0) return resultat;
+        if (c.longueur < mot.size()) return -1;
+        return c.longueur > mot.size() ? 1 : 0;
+    }
+
+    /**
+     * \brief Recherche dichotomique d'un radical dans la table triée des radicaux
+     * \return l'entrée du radical, ou nullptr s'il n'existe pas
+     */
+    const FormatIndex::Radical* DicoSynonymesDisque::_trouverRadical(const std::string& radical) const
+    {
+        const FormatIndex::Radical* fin = tableRadicaux + entete->nbRadicaux;
+        const FormatIndex::Radical* itr = std::lower_bound(tableRadicaux, fin, radical,
+                [this](const FormatIndex::Radical& r, const std::string& m) { return _comparer(r.radical, m) < 0; });
+        if (itr == fin || _comparer(itr->radical, radical) != 0) return nullptr;
+        return itr;
+    }
+
+    /**
+     * \brief Donne l'enregistrement décodé d'un radical, en passant par la cache LRU
+     * \exception logic_error si le radical n'existe pas
+     */
+    DicoSynonymesDisque::Enregistrement DicoSynonymesDisque::_enregistrement(const std::string& radical) const
+    {
+        {
+            std::lock_guard<std::mutex> verrou(verrouCache);
+            auto itr = indexCache.find(radical);
+            if (itr != indexCache.end()) // on ramène l'entrée en tête de la liste
+            {
+                lru.splice(lru.begin(), lru, itr->second);
+                return itr->second->second;
+            }
+        }
+        const FormatIndex::Radical* entree = _trouverRadical(radical);
+        if (entree == nullptr) throw std::logic_error("Le radical n'existe pas dans l'arbre");
+        Enregistrement enregistrement = _decoder(entree);
+        if (capaciteCache == 0) return enregistrement;
+
+        std::lock_guard<std::mutex> verrou(verrouCache);
+        if (indexCache.find(radical) == indexCache.end()) // un autre fil a pu l'ajouter entre-temps
+        {
+            lru.emplace_front(radical, enregistrement);
+            indexCache[radical] = lru.begin();
+            if (lru.size() > capaciteCache) // on évince le moins récemment utilisé
+            {
+                indexCache.erase(lru.back().first);
+                lru.pop_back();
+            }
+        }
+        return enregistrement;
+    }
+
+    /**
+     * \brief Décode l'enregistrement d'un radical directement de la projection
+     */
+    DicoSynonymesDisque::Enregistrement DicoSynonymesDisque::_decoder(const FormatIndex::Radical* entree) const
+    {
+        Enregistrement enregistrement;
+        const std::uint32_t* donnees = reinterpret_cast<const std::uint32_t*>(base + entree->enregistrement);
+        std::uint32_t nbFlexions = *donnees++;
+        const FormatIndex::Chaine* flexionsRadical = reinterpret_cast<const FormatIndex::Chaine*>(donnees);
+        for (std::uint32_t i = 0; i < nbFlexions; i++)
+        {
+            enregistrement.flexions.push_back(_chaine(flexionsRadical[i]));
+        }
+        donnees += 2 * nbFlexions;
+        if (entete->version >= 2)
+        {
+            enregistrement.traits.assign(donnees, donnees + nbFlexions);
+            donnees += nbFlexions;
+        }
+        else
+        {
+            enregistrement.traits.assign(nbFlexions, 0);
+        }
+        std::uint32_t nbSens = *donnees++;
+        enregistrement.groupes.assign(donnees, donnees + nbSens);
+        return enregistrement;
+    }
+
+    /**
+     * \brief Donne les membres d'un groupe de synonymes
+     */
+    std::vector<std::string> DicoSynonymesDisque::_membresGroupe(std::uint32_t groupe) const
+    {
+        const std::uint32_t* donnees = reinterpret_cast<const std::uint32_t*>(base + tableGroupes[groupe]);
+        std::uint32_t nbMembres = *donnees++;
+        const FormatIndex::Chaine* membres = reinterpret_cast<const FormatIndex::Chaine*>(donnees);
+        std::vector<std::string> resultat;
+        for (std::uint32_t i = 0; i < nbMembres; i++)
+        {
+            resultat.push_back(_chaine(membres[i]));
+        }
+        return resultat;
+    }
+
+}//Fin du namespace
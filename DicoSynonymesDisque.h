@@ -0,0 +1,244 @@
+/**
+* \file DicoSynonymesDisque.h
+* \brief Interface du type DicoSynonymesDisque, un dictionnaire des synonymes
+*        en lecture seule adossé à un index trié projeté en mémoire (mmap)
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+#ifndef _DICOSYNONYMESDISQUE__H
+#define _DICOSYNONYMESDISQUE__H
+
+namespace TP3
+{
+
+   /**
+   * \brief Structures du fichier d'index écrit par DicoSynonymes::sauvegarderIndex.
+   *
+   * Disposition du fichier (entiers dans l'ordre natif de la machine) :
+   *   Entete | Radical[nbRadicaux] (triés) | Flexion[nbFlexions] (triées)
+   *   | uint64 debutGroupe[nbGroupes] | enregistrements (uint32) | chaînes
+   *
+   * Enregistrement d'un radical : nbFlexions, Chaine[nbFlexions], traits[nbFlexions], nbSens, groupe[nbSens]
+   *                               (la version 1 n'a pas les traits)
+   * Enregistrement d'un groupe  : nbMembres, Chaine[nbMembres]
+   */
+   namespace FormatIndex
+   {
+      const char MAGIE[4] = {'D', 'S', 'Y', 'N'};
+      const std::uint32_t VERSION = 2;
+
+      struct Chaine
+      {
+         std::uint32_t debut;     // Position relative au début de la zone des chaînes.
+         std::uint32_t longueur;
+      };
+
+      struct Entete
+      {
+         char magie[4];
+         std::uint32_t version;
+         std::uint32_t nbRadicaux;
+         std::uint32_t nbFlexions;
+         std::uint32_t nbGroupes;
+         std::uint32_t reserve;
+         std::uint64_t debutRadicaux;
+         std::uint64_t debutFlexions;
+         std::uint64_t debutGroupes;
+         std::uint64_t debutChaines;
+         std::uint64_t taille;    // Taille totale du fichier, pour valider l'ouverture.
+         std::uint64_t dernierEnregistrement;   // Dernier enregistrement du journal inclus, pour un instantané.
+      };
+
+      struct Radical
+      {
+         Chaine radical;
+         std::uint64_t enregistrement;   // Position absolue de l'enregistrement dans le fichier.
+      };
+
+      struct Flexion
+      {
+         Chaine flexion;
+         std::uint32_t radical;          // Indice dans la table des radicaux du radical que retourne rechercherRadical.
+         std::uint32_t reserve;
+      };
+   }
+
+   /**
+   * \class DicoSynonymesDisque
+   *
+   * \brief Dictionnaire des synonymes en lecture seule dont le contenu reste sur disque.
+   *
+   * Le fichier d'index est projeté en mémoire : une requête ne fait charger que les pages
+   * qu'elle touche (recherche dichotomique dans les tables triées, puis l'enregistrement visé).
+   * Les enregistrements décodés des radicaux les plus récemment consultés sont gardés
+   * dans une cache LRU de taille bornée.
+   *
+   */
+   class DicoSynonymesDisque
+   {
+   public:
+
+      /**
+      * \brief Ouvre un fichier d'index produit par DicoSynonymes::sauvegarderIndex
+      *
+      * \param[in] chemin le chemin du fichier d'index
+      * \param[in] capaciteCache le nombre maximal de radicaux décodés gardés en mémoire
+      *
+      * \exception runtime_error si le fichier ne peut pas être ouvert ou projeté
+      * \exception logic_error si le fichier n'est pas un index valide
+      */
+      DicoSynonymesDisque(const std::string& chemin, std::size_t capaciteCache = 1024);
+
+      /**
+      * \brief Destructeur, libère la projection du fichier
+      */
+      ~DicoSynonymesDisque();
+
+      DicoSynonymesDisque(const DicoSynonymesDisque&) = delete;
+      DicoSynonymesDisque& operator=(const DicoSynonymesDisque&) = delete;
+
+      /**
+      * \brief Retourne le nombre de radicaux dans le dictionnaire
+      */
+      int nombreRadicaux() const;
+
+      /**
+      * \brief Retourne le radical du mot entré en paramètre, comme DicoSynonymes::rechercherRadical
+      *
+      * \exception logic_error si le dictionnaire est vide ou si mot n'est la flexion d'aucun radical
+      */
+      std::string rechercherRadical(const std::string& mot) const;
+
+      /**
+      * \brief Donne le nombre de sens (groupes de synonymes) du radical
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+      int getNombreSens(const std::string& radical) const;
+
+      /**
+      * \brief Donne le premier synonyme du groupe de synonymes à la position donnée du radical
+      *
+      * \exception logic_error si le radical ou la position n'existe pas, ou si le groupe est vide
+      */
+      std::string getSens(const std::string& radical, int position) const;
+
+      /**
+      * \brief Donne tous les synonymes du groupe de synonymes à la position donnée du radical
+      *
+      * \exception logic_error si le radical ou la position n'existe pas
+      */
+      std::vector<std::string> getSynonymes(const std::string& radical, int position) const;
+
+      /**
+      * \brief Donne toutes les flexions du radical
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+      std::vector<std::string> getFlexions(const std::string& radical) const;
+
+      /**
+      * \brief Donne les traits de chaque flexion du radical, dans l'ordre de getFlexions (0 : non étiquetée)
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+      std::vector<std::uint32_t> getTraitsFlexions(const std::string& radical) const;
+
+      /**
+      * \brief Donne les numéros des groupes de synonymes (appSynonymes) du radical
+      *
+      * \exception logic_error si le radical n'existe pas
+      */
+      std::vector<int> groupes(const std::string& radical) const;
+
+      /**
+      * \brief Donne tous les radicaux, en ordre alphabétique
+      */
+      std::vector<std::string> radicaux() const;
+
+      /**
+      * \brief Donne le nombre de groupes de synonymes
+      */
+      int nombreGroupes() const;
+
+      /**
+      * \brief Donne les membres d'un groupe de synonymes
+      *
+      * \exception logic_error si le numéro de groupe n'est pas correct
+      */
+      std::vector<std::string> membresGroupe(int groupe) const;
+
+      /**
+      * \brief Donne le dernier enregistrement du journal contenu dans l'index, 0 s'il n'est pas un instantané
+      */
+      std::uint64_t dernierEnregistrement() const;
+
+      /**
+      * \brief Donne le nombre d'octets du fichier projeté présentement résidents en mémoire
+      *
+      * \post Le dictionnaire reste inchangé.
+      */
+      std::size_t octetsResidents() const;
+
+      /**
+      * \brief Donne la taille totale du fichier projeté, en octets
+      */
+      std::size_t tailleFichier() const;
+
+   private:
+
+      /**
+      * \brief Contenu décodé de l'enregistrement d'un radical, tel que gardé dans la cache
+      */
+      struct Enregistrement
+      {
+         std::vector<std::string> flexions;
+         std::vector<std::uint32_t> traits;
+         std::vector<std::uint32_t> groupes;
+      };
+
+      int fd;                                   // Descripteur du fichier d'index.
+      const char* base;                         // Début de la projection.
+      std::size_t taille;                       // Taille de la projection.
+      const FormatIndex::Entete* entete;
+      const FormatIndex::Radical* tableRadicaux;
+      const FormatIndex::Flexion* tableFlexions;
+      const std::uint64_t* tableGroupes;
+      const char* chaines;
+
+      std::size_t capaciteCache;
+      mutable std::mutex verrouCache;
+      mutable std::list<std::pair<std::string, Enregistrement> > lru;   // Le plus récent en tête.
+      mutable std::unordered_map<std::string,
+            std::list<std::pair<std::string, Enregistrement> >::iterator> indexCache;
+
+      std::string _chaine(const FormatIndex::Chaine& c) const;
+
+      int _comparer(const FormatIndex::Chaine& c, const std::string& mot) const;
+
+      const FormatIndex::Radical* _trouverRadical(const std::string& radical) const;
+
+      Enregistrement _enregistrement(const std::string& radical) const;
+
+      Enregistrement _decoder(const FormatIndex::Radical* entree) const;
+
+      std::vector<std::string> _membresGroupe(std::uint32_t groupe) const;
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,335 @@
+/**
+* \file GrapheSynonymes.cpp
+* \brief Le code du graphe des synonymes en format CSR.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "GrapheSynonymes.h"
+#include <algorithm>
+#include <future>
+#include <queue>
+#include <thread>
+
+namespace TP3
+{
+    namespace
+    {
+        /**
+         * \brief Exécute f(debut, fin) sur des tranches de [0, n), une par coeur si n est assez grand
+         */
+        template <typename Fonction>
+        void enParallele(std::size_t n, std::size_t tailleMin, Fonction f)
+        {
+            std::size_t nbTranches = std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), n / tailleMin));
+            std::vector<std::future<void> > taches;
+            for (std::size_t t = 1; t < nbTranches; t++)
+            {
+                taches.push_back(std::async(std::launch::async, f, n * t / nbTranches, n * (t + 1) / nbTranches));
+            }
+            f(0, n / nbTranches);
+            for (auto& tache : taches) tache.get();
+        }
+    }
+
+    GrapheSynonymes::GrapheSynonymes() : debuts(1, 0), tailleDelta(0), derivesAJour(false), nbComposantes(0)
+    {
+    }
+
+    void GrapheSynonymes::construire(const std::vector<std::vector<std::string> >& groupes)
+    {
+        mots.clear();
+        ids.clear();
+        appartenances.clear();
+        membres.assign(groupes.size(), std::unordered_map<std::uint32_t, int>());
+        for (std::size_t g = 0; g < groupes.size(); g++)
+        {
+            for (const auto& mot : groupes[g])
+            {
+                std::uint32_t u = _identifiant(mot);
+                if (membres[g][u]++ == 0) appartenances[u]++;
+            }
+        }
+        _compacter();
+    }
+
+    void GrapheSynonymes::ajouterAuGroupe(int numGroupe, const std::string& mot)
+    {
+        if (numGroupe < 0) return;
+        if (numGroupe >= int(membres.size())) membres.resize(numGroupe + 1);
+        std::uint32_t u = _identifiant(mot);
+        auto& groupe = membres[numGroupe];
+        if (groupe[u]++ > 0) return; // déjà membre : les arêtes existent
+        appartenances[u]++;
+        for (const auto& membre : groupe)
+        {
+            if (membre.first != u) _changerPoids(u, membre.first, 1);
+        }
+        derivesAJour = false;
+        if (tailleDelta > std::max<std::size_t>(1024, voisins.size() / 8)) _compacter();
+    }
+
+    void GrapheSynonymes::retirerDuGroupe(int numGroupe, const std::string& mot)
+    {
+        if (numGroupe < 0 || numGroupe >= int(membres.size())) return;
+        auto id = ids.find(mot);
+        if (id == ids.end()) return;
+        auto& groupe = membres[numGroupe];
+        auto membre = groupe.find(id->second);
+        if (membre == groupe.end()) return;
+        if (--membre->second > 0) return; // encore membre une autre fois
+        groupe.erase(membre);
+        appartenances[id->second]--;
+        for (const auto& autre : groupe)
+        {
+            _changerPoids(id->second, autre.first, -1);
+        }
+        derivesAJour = false;
+        if (tailleDelta > std::max<std::size_t>(1024, voisins.size() / 8)) _compacter();
+    }
+
+    std::vector<std::string> GrapheSynonymes::voisinage(const std::string& mot, int profondeur)
+    {
+        std::vector<std::string> resultat;
+        auto id = ids.find(mot);
+        if (id == ids.end()) return resultat;
+        std::unordered_map<std::uint32_t, int> distances;
+        std::queue<std::uint32_t> file;
+        distances[id->second] = 0;
+        file.push(id->second);
+        while (!file.empty())
+        {
+            std::uint32_t u = file.front();
+            file.pop();
+            int distance = distances[u];
+            if (distance == profondeur) continue;
+            _pourChaqueVoisin(u, [&](std::uint32_t v) {
+                if (distances.emplace(v, distance + 1).second)
+                {
+                    resultat.push_back(mots[v]);
+                    file.push(v);
+                }
+            });
+        }
+        return resultat;
+    }
+
+    int GrapheSynonymes::composante(const std::string& mot)
+    {
+        auto id = ids.find(mot);
+        if (id == ids.end() || appartenances[id->second] == 0) return -1;
+        if (!derivesAJour) _calculerDerives();
+        return composantes[id->second];
+    }
+
+    int GrapheSynonymes::nombreComposantes()
+    {
+        if (!derivesAJour) _calculerDerives();
+        return nbComposantes;
+    }
+
+    std::vector<std::pair<std::string, int> > GrapheSynonymes::plusConnectes(int k)
+    {
+        if (!derivesAJour) _calculerDerives();
+        std::vector<std::uint32_t> ordre;
+        for (std::uint32_t u = 0; u < mots.size(); u++)
+        {
+            if (appartenances[u] > 0) ordre.push_back(u);
+        }
+        std::size_t n = std::min<std::size_t>(std::max(k, 0), ordre.size());
+        std::partial_sort(ordre.begin(), ordre.begin() + n, ordre.end(), [this](std::uint32_t a, std::uint32_t b) {
+            return degres[a] != degres[b] ? degres[a] > degres[b] : mots[a] < mots[b];
+        });
+        std::vector<std::pair<std::string, int> > resultat;
+        for (std::size_t i = 0; i < n; i++)
+        {
+            resultat.emplace_back(mots[ordre[i]], degres[ordre[i]]);
+        }
+        return resultat;
+    }
+
+    std::size_t GrapheSynonymes::nombreMots() const
+    {
+        return mots.size();
+    }
+
+    /**
+     * \brief Donne l'identifiant de mot, en lui en attribuant un s'il n'en a pas
+     */
+    std::uint32_t GrapheSynonymes::_identifiant(const std::string& mot)
+    {
+        auto id = ids.emplace(mot, mots.size());
+        if (id.second)
+        {
+            mots.push_back(mot);
+            appartenances.push_back(0);
+        }
+        return id.first->second;
+    }
+
+    /**
+     * \brief Ajoute variation au poids de l'arête {u, v} dans le delta
+     */
+    void GrapheSynonymes::_changerPoids(std::uint32_t u, std::uint32_t v, int variation)
+    {
+        for (int sens = 0; sens < 2; sens++, std::swap(u, v))
+        {
+            auto& ligne = delta[u];
+            auto itr = ligne.emplace(v, 0).first;
+            itr->second += variation;
+            if (itr->second == 0)
+            {
+                ligne.erase(itr);
+                tailleDelta--;
+            }
+            else if (itr->second == variation)
+            {
+                tailleDelta++;
+            }
+        }
+    }
+
+    /**
+     * \brief Appelle f(v) pour chaque voisin v de u dont le poids, CSR plus delta, est positif
+     */
+    template <typename Fonction>
+    void GrapheSynonymes::_pourChaqueVoisin(std::uint32_t u, Fonction f) const
+    {
+        auto ligneDelta = delta.find(u);
+        const std::unordered_map<std::uint32_t, int>* variations = ligneDelta == delta.end() ? nullptr : &ligneDelta->second;
+        std::uint32_t debut = 0, fin = 0;
+        if (u + 1 < debuts.size())
+        {
+            debut = debuts[u];
+            fin = debuts[u + 1];
+        }
+        for (std::uint32_t i = debut; i < fin; i++)
+        {
+            int p = poids[i];
+            if (variations != nullptr)
+            {
+                auto variation = variations->find(voisins[i]);
+                if (variation != variations->end()) p += variation->second;
+            }
+            if (p > 0) f(voisins[i]);
+        }
+        if (variations == nullptr) return;
+        for (const auto& variation : *variations) // arêtes absentes du CSR
+        {
+            if (variation.second > 0 && !std::binary_search(voisins.begin() + debut, voisins.begin() + fin, variation.first))
+                f(variation.first);
+        }
+    }
+
+    /**
+     * \brief Reconstruit le CSR à partir des membres des groupes et vide le delta
+     */
+    void GrapheSynonymes::_compacter()
+    {
+        std::uint32_t n = mots.size();
+        std::size_t nbTranches = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        // 1. Les arêtes de chaque tranche de groupes, dans les deux sens
+        std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t> > > aretes(nbTranches);
+        std::vector<std::future<void> > taches;
+        for (std::size_t t = 0; t < nbTranches; t++)
+        {
+            taches.push_back(std::async(std::launch::async, [this, t, nbTranches, &aretes]() {
+                std::vector<std::uint32_t> membresGroupe;
+                for (std::size_t g = membres.size() * t / nbTranches; g < membres.size() * (t + 1) / nbTranches; g++)
+                {
+                    membresGroupe.clear();
+                    for (const auto& membre : membres[g]) membresGroupe.push_back(membre.first);
+                    for (std::size_t i = 0; i < membresGroupe.size(); i++)
+                        for (std::size_t j = 0; j < membresGroupe.size(); j++)
+                            if (i != j) aretes[t].emplace_back(membresGroupe[i], membresGroupe[j]);
+                }
+            }));
+        }
+        for (auto& tache : taches) tache.get();
+
+        // 2. Répartition par mot (tri par dénombrement)
+        std::vector<std::uint32_t> positions(n + 1, 0);
+        for (const auto& tranche : aretes)
+            for (const auto& arete : tranche) positions[arete.first + 1]++;
+        for (std::uint32_t u = 0; u < n; u++) positions[u + 1] += positions[u];
+        std::vector<std::uint32_t> bruts(positions[n]);
+        std::vector<std::uint32_t> curseurs(positions.begin(), positions.end() - 1);
+        for (const auto& tranche : aretes)
+            for (const auto& arete : tranche) bruts[curseurs[arete.first]++] = arete.second;
+        aretes.clear();
+
+        // 3. Tri de chaque ligne; chaque groupe ne produit {u, v} qu'une fois, donc le nombre de répétitions est le poids
+        std::vector<std::uint32_t> repetitions(bruts.size());
+        std::vector<std::uint32_t> nbDistincts(n + 1, 0);
+        enParallele(n, 4096, [&](std::size_t debut, std::size_t fin) {
+            for (std::size_t u = debut; u < fin; u++)
+            {
+                std::uint32_t p = positions[u], k = 0;
+                std::sort(bruts.begin() + p, bruts.begin() + positions[u + 1]);
+                for (std::uint32_t i = p; i < positions[u + 1]; i++)
+                {
+                    if (k > 0 && bruts[p + k - 1] == bruts[i])
+                    {
+                        repetitions[p + k - 1]++;
+                        continue;
+                    }
+                    bruts[p + k] = bruts[i];
+                    repetitions[p + k] = 1;
+                    k++;
+                }
+                nbDistincts[u + 1] = k;
+            }
+        });
+        debuts.assign(n + 1, 0);
+        for (std::uint32_t u = 0; u < n; u++) debuts[u + 1] = debuts[u] + nbDistincts[u + 1];
+        voisins.assign(debuts[n], 0);
+        poids.assign(debuts[n], 0);
+        enParallele(n, 4096, [&](std::size_t debut, std::size_t fin) {
+            for (std::size_t u = debut; u < fin; u++)
+            {
+                std::copy(bruts.begin() + positions[u], bruts.begin() + positions[u] + nbDistincts[u + 1], voisins.begin() + debuts[u]);
+                std::copy(repetitions.begin() + positions[u], repetitions.begin() + positions[u] + nbDistincts[u + 1], poids.begin() + debuts[u]);
+            }
+        });
+        delta.clear();
+        tailleDelta = 0;
+        derivesAJour = false;
+    }
+
+    /**
+     * \brief Recalcule les composantes connexes (parcours en largeur) et le nombre de voisins de chaque mot
+     */
+    void GrapheSynonymes::_calculerDerives()
+    {
+        std::uint32_t n = mots.size();
+        composantes.assign(n, -1);
+        degres.assign(n, 0);
+        nbComposantes = 0;
+        std::vector<std::uint32_t> file;
+        for (std::uint32_t depart = 0; depart < n; depart++)
+        {
+            if (composantes[depart] != -1 || appartenances[depart] == 0) continue; // les mots retirés de tous leurs groupes n'en font plus partie
+            composantes[depart] = nbComposantes;
+            file.assign(1, depart);
+            for (std::size_t i = 0; i < file.size(); i++)
+            {
+                std::uint32_t u = file[i];
+                _pourChaqueVoisin(u, [&](std::uint32_t v) {
+                    degres[u]++;
+                    if (composantes[v] == -1)
+                    {
+                        composantes[v] = nbComposantes;
+                        file.push_back(v);
+                    }
+                });
+            }
+            nbComposantes++;
+        }
+        derivesAJour = true;
+    }
+
+}//Fin du namespace
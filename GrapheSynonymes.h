@@ -0,0 +1,125 @@
+/**
+* \file GrapheSynonymes.h
+* \brief Interface du graphe des synonymes en format CSR (compressed sparse row)
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _GRAPHESYNONYMES__H
+#define _GRAPHESYNONYMES__H
+
+namespace TP3
+{
+
+   /**
+   * \class GrapheSynonymes
+   *
+   * \brief Graphe non orienté des mots reliés par un groupe de synonymes.
+   *
+   * Deux mots sont voisins s'ils font partie d'un même groupe, en comptant comme membres
+   * d'un groupe ses synonymes et les radicaux qui y ont un sens. Le poids d'une arête est
+   * le nombre de groupes que les deux mots partagent.
+   *
+   * Les arêtes sont rangées en CSR : les voisins du mot u sont voisins[debuts[u], debuts[u + 1]),
+   * triés par identifiant. Les modifications de groupes s'accumulent dans un petit delta
+   * de poids par arête, fusionné à la lecture; quand il devient trop gros, le CSR est
+   * reconstruit à partir des groupes. Les composantes connexes et les degrés sont recalculés
+   * à la demande après une modification.
+   *
+   */
+   class GrapheSynonymes
+   {
+   public:
+
+      GrapheSynonymes();
+
+      /**
+      * \brief Reconstruit le graphe à partir des membres de chaque groupe
+      *
+      * \param[in] groupes pour chaque numéro de groupe, ses membres (synonymes et radicaux qui l'utilisent)
+      * \post Les arêtes sont produites en parallèle, un bloc de groupes par coeur.
+      */
+      void construire(const std::vector<std::vector<std::string> >& groupes);
+
+      /**
+      * \brief Ajoute mot aux membres du groupe numGroupe, avec ses arêtes vers les autres membres
+      */
+      void ajouterAuGroupe(int numGroupe, const std::string& mot);
+
+      /**
+      * \brief Retire mot des membres du groupe numGroupe, avec les arêtes qu'il ne doit qu'à ce groupe
+      */
+      void retirerDuGroupe(int numGroupe, const std::string& mot);
+
+      /**
+      * \brief Donne les mots à au plus profondeur arêtes de mot, sans mot lui-même
+      *
+      * \return les mots dans l'ordre du parcours en largeur, vide si mot n'est pas dans le graphe
+      */
+      std::vector<std::string> voisinage(const std::string& mot, int profondeur);
+
+      /**
+      * \brief Donne le numéro de la composante connexe de mot, ou -1 s'il n'est membre d'aucun groupe
+      */
+      int composante(const std::string& mot);
+
+      /**
+      * \brief Donne le nombre de composantes connexes
+      */
+      int nombreComposantes();
+
+      /**
+      * \brief Donne les k mots qui ont le plus de voisins, avec leur nombre de voisins, du plus connecté au moins connecté
+      */
+      std::vector<std::pair<std::string, int> > plusConnectes(int k);
+
+      /**
+      * \brief Donne le nombre de mots du graphe
+      */
+      std::size_t nombreMots() const;
+
+   private:
+
+      std::vector<std::string> mots;                          // Identifiant -> mot.
+      std::unordered_map<std::string, std::uint32_t> ids;     // Mot -> identifiant.
+      std::vector<std::unordered_map<std::uint32_t, int> > membres;   // Par groupe : identifiant -> multiplicité.
+      std::vector<int> appartenances;                          // Par mot : nombre de groupes dont il est membre.
+
+      std::vector<std::uint32_t> debuts;                      // nbMotsCSR + 1 bornes.
+      std::vector<std::uint32_t> voisins;
+      std::vector<std::uint32_t> poids;                       // Nombre de groupes partagés, parallèle à voisins.
+
+      std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t, int> > delta;   // Changements de poids depuis le CSR.
+      std::size_t tailleDelta;
+
+      bool derivesAJour;                                      // composantes et degres
+      std::vector<int> composantes;
+      int nbComposantes;
+      std::vector<int> degres;
+
+      std::uint32_t _identifiant(const std::string& mot);
+
+      void _changerPoids(std::uint32_t u, std::uint32_t v, int variation);
+
+      void _compacter();
+
+      void _calculerDerives();
+
+      template <typename Fonction>
+      void _pourChaqueVoisin(std::uint32_t u, Fonction f) const;
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,207 @@
+/**
+* \file GroupesSynonymes.cpp
+* \brief Le code des groupes de synonymes rangés en tableaux d'identifiants.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "GroupesSynonymes.h"
+#include <algorithm>
+
+namespace TP3
+{
+
+    GroupesSynonymes::GroupesSynonymes(std::pmr::memory_resource* ressource)
+        : mots(ressource), ids(ressource), groupes(ressource), appartenances(ressource), nbAppartenances(0)
+    {
+    }
+
+    int GroupesSynonymes::nombreGroupes() const
+    {
+        return groupes.size();
+    }
+
+    int GroupesSynonymes::creerGroupe()
+    {
+        groupes.emplace_back();
+        return groupes.size() - 1;
+    }
+
+    std::uint32_t GroupesSynonymes::identifiant(const std::string& mot)
+    {
+        auto id = ids.find(mot);
+        if (id != ids.end()) return id->second;
+        mots.emplace_back(std::string_view(mot)); // construit dans la ressource de mots
+        ids.emplace(mots.back(), mots.size() - 1);
+        return mots.size() - 1;
+    }
+
+    bool GroupesSynonymes::ajouter(int numGroupe, std::uint32_t id)
+    {
+        auto& groupe = groupes[numGroupe];
+        // la place est faite d'abord : rien ne peut échouer entre l'insertion de la clé et celle du membre
+        if (groupe.size() == groupe.capacity()) groupe.reserve(std::max<std::size_t>(4, 2 * groupe.capacity()));
+        if (!_insererCle(_cle(numGroupe, id))) return false;
+        groupe.push_back(id);
+        return true;
+    }
+
+    bool GroupesSynonymes::ajouter(int numGroupe, const std::string& mot)
+    {
+        return ajouter(numGroupe, identifiant(mot));
+    }
+
+    bool GroupesSynonymes::retirer(int numGroupe, const std::string& mot)
+    {
+        auto id = ids.find(mot);
+        if (id == ids.end() || !_effacerCle(_cle(numGroupe, id->second))) return false;
+        auto& groupe = groupes[numGroupe];
+        groupe.erase(std::find(groupe.begin(), groupe.end(), id->second));
+        return true;
+    }
+
+    bool GroupesSynonymes::contient(int numGroupe, std::uint32_t id) const
+    {
+        if (nbAppartenances == 0) return false;
+        std::uint64_t cle = _cle(numGroupe, id);
+        std::size_t masque = appartenances.size() - 1;
+        for (std::size_t i = _case(cle); appartenances[i] != VIDE; i = (i + 1) & masque)
+        {
+            if (appartenances[i] == cle) return true;
+        }
+        return false;
+    }
+
+    bool GroupesSynonymes::contient(int numGroupe, const std::string& mot) const
+    {
+        auto id = ids.find(mot);
+        return id != ids.end() && contient(numGroupe, id->second);
+    }
+
+    void GroupesSynonymes::effacerGroupe(int numGroupe)
+    {
+        groupes.erase(groupes.begin() + numGroupe);
+        // Les clés des groupes suivants changent : on reconstruit l'ensemble
+        std::fill(appartenances.begin(), appartenances.end(), VIDE);
+        nbAppartenances = 0;
+        for (std::size_t g = 0; g < groupes.size(); g++)
+        {
+            for (std::uint32_t id : groupes[g]) _insererCle(_cle(g, id));
+        }
+    }
+
+    void GroupesSynonymes::tronquer(int nombre)
+    {
+        for (int numGroupe = int(groupes.size()) - 1; numGroupe >= nombre; numGroupe--)
+        {
+            for (std::uint32_t id : groupes[numGroupe]) _effacerCle(_cle(numGroupe, id));
+            groupes.pop_back();
+        }
+    }
+
+    const std::pmr::vector<std::uint32_t>& GroupesSynonymes::membres(int numGroupe) const
+    {
+        return groupes[numGroupe];
+    }
+
+    std::string_view GroupesSynonymes::mot(std::uint32_t id) const
+    {
+        return mots[id];
+    }
+
+    void GroupesSynonymes::vider()
+    {
+        groupes.clear();
+        appartenances.clear();
+        nbAppartenances = 0;
+        ids.clear();
+        mots.clear();
+    }
+
+    /**
+     * \brief Clé de la paire (groupe, mot) dans appartenances
+     */
+    std::uint64_t GroupesSynonymes::_cle(int numGroupe, std::uint32_t id)
+    {
+        return (std::uint64_t(std::uint32_t(numGroupe)) << 32) | id;
+    }
+
+    /**
+     * \brief Case de départ de cle dans appartenances (hachage multiplicatif de Fibonacci)
+     * \pre appartenances n'est pas vide
+     */
+    std::size_t GroupesSynonymes::_case(std::uint64_t cle) const
+    {
+        return std::size_t((cle * 0x9E3779B97F4A7C15ull) >> 32) & (appartenances.size() - 1);
+    }
+
+    /**
+     * \brief Ajoute cle à appartenances, en doublant la table au-delà d'une charge de 1/2
+     * \return false si cle y était déjà
+     */
+    bool GroupesSynonymes::_insererCle(std::uint64_t cle)
+    {
+        if ((nbAppartenances + 1) * 2 > appartenances.size()) _redimensionner(std::max<std::size_t>(16, 2 * appartenances.size()));
+        std::size_t masque = appartenances.size() - 1;
+        std::size_t i = _case(cle);
+        for (; appartenances[i] != VIDE; i = (i + 1) & masque)
+        {
+            if (appartenances[i] == cle) return false;
+        }
+        appartenances[i] = cle;
+        nbAppartenances++;
+        return true;
+    }
+
+    /**
+     * \brief Retire cle de appartenances en reculant les clés suivantes de la même grappe
+     * \return false si cle n'y était pas
+     */
+    bool GroupesSynonymes::_effacerCle(std::uint64_t cle)
+    {
+        if (nbAppartenances == 0) return false;
+        std::size_t masque = appartenances.size() - 1;
+        std::size_t i = _case(cle);
+        for (; appartenances[i] != cle; i = (i + 1) & masque)
+        {
+            if (appartenances[i] == VIDE) return false;
+        }
+        // Pas de marque d'effacement : une clé suivante peut prendre le trou si sa case de départ
+        // n'est pas strictement entre le trou et elle.
+        for (std::size_t j = (i + 1) & masque; appartenances[j] != VIDE; j = (j + 1) & masque)
+        {
+            std::size_t depart = _case(appartenances[j]);
+            if (((j - depart) & masque) >= ((j - i) & masque))
+            {
+                appartenances[i] = appartenances[j];
+                i = j;
+            }
+        }
+        appartenances[i] = VIDE;
+        nbAppartenances--;
+        return true;
+    }
+
+    /**
+     * \brief Replace toutes les clés dans une table de nbCases cases
+     * \pre nbCases est une puissance de 2 plus grande que 2 * nbAppartenances
+     */
+    void GroupesSynonymes::_redimensionner(std::size_t nbCases)
+    {
+        std::pmr::vector<std::uint64_t> anciennes(nbCases, VIDE, appartenances.get_allocator());
+        anciennes.swap(appartenances);
+        std::size_t masque = nbCases - 1;
+        for (std::uint64_t cle : anciennes)
+        {
+            if (cle == VIDE) continue;
+            std::size_t i = _case(cle);
+            while (appartenances[i] != VIDE) i = (i + 1) & masque;
+            appartenances[i] = cle;
+        }
+    }
+
+}//Fin du namespace
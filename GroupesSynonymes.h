@@ -0,0 +1,148 @@
+/**
+* \file GroupesSynonymes.h
+* \brief Interface des groupes de synonymes rangés en tableaux contigus d'identifiants de mots
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _GROUPESSYNONYMES__H
+#define _GROUPESSYNONYMES__H
+
+namespace TP3
+{
+
+   /**
+   * \class GroupesSynonymes
+   *
+   * \brief Les groupes de synonymes d'un dictionnaire, numérotés à partir de 0.
+   *
+   * Chaque mot reçoit une seule fois un identifiant de 32 bits; un groupe est le tableau
+   * des identifiants de ses membres, dans leur ordre d'ajout (le premier donne le sens).
+   * Un ensemble de hachage des paires (groupe, mot), à adressage ouvert et sondage linéaire,
+   * répond en O(1) à la question « ce mot est-il déjà dans ce groupe? ». Les mots retirés
+   * de tous les groupes gardent leur identifiant jusqu'à vider().
+   *
+   * Toute la mémoire (mots, groupes, ensemble) vient de la ressource donnée au constructeur.
+   *
+   */
+   class GroupesSynonymes
+   {
+   public:
+
+      explicit GroupesSynonymes(std::pmr::memory_resource* ressource = std::pmr::get_default_resource());
+
+      GroupesSynonymes(const GroupesSynonymes&) = delete;
+      GroupesSynonymes& operator=(const GroupesSynonymes&) = delete;
+
+      /**
+      * \brief Donne le nombre de groupes
+      */
+      int nombreGroupes() const;
+
+      /**
+      * \brief Ajoute un groupe vide à la fin
+      * \return le numéro du nouveau groupe
+      */
+      int creerGroupe();
+
+      /**
+      * \brief Donne l'identifiant de mot, en lui en attribuant un s'il n'en a pas
+      */
+      std::uint32_t identifiant(const std::string& mot);
+
+      /**
+      * \brief Ajoute le mot id à la fin du groupe numGroupe
+      * \pre 0 <= numGroupe < nombreGroupes() et id vient de identifiant()
+      * \return false si le mot était déjà dans le groupe (il n'est alors pas ajouté)
+      */
+      bool ajouter(int numGroupe, std::uint32_t id);
+
+      /**
+      * \brief Ajoute mot à la fin du groupe numGroupe
+      * \pre 0 <= numGroupe < nombreGroupes()
+      * \return false si mot était déjà dans le groupe (il n'est alors pas ajouté)
+      */
+      bool ajouter(int numGroupe, const std::string& mot);
+
+      /**
+      * \brief Retire mot du groupe numGroupe, sans changer l'ordre des autres membres
+      * \pre 0 <= numGroupe < nombreGroupes()
+      * \return false si mot n'était pas dans le groupe
+      */
+      bool retirer(int numGroupe, const std::string& mot);
+
+      /**
+      * \brief Indique si le mot id est dans le groupe numGroupe
+      */
+      bool contient(int numGroupe, std::uint32_t id) const;
+
+      /**
+      * \brief Indique si mot est dans le groupe numGroupe
+      */
+      bool contient(int numGroupe, const std::string& mot) const;
+
+      /**
+      * \brief Supprime le groupe numGroupe; les groupes suivants reculent d'un numéro
+      * \pre 0 <= numGroupe < nombreGroupes()
+      */
+      void effacerGroupe(int numGroupe);
+
+      /**
+      * \brief Supprime les groupes de numéro nombre et plus, sans toucher aux autres
+      * \pre 0 <= nombre <= nombreGroupes()
+      */
+      void tronquer(int nombre);
+
+      /**
+      * \brief Donne les identifiants des membres du groupe numGroupe, dans leur ordre d'ajout
+      * \pre 0 <= numGroupe < nombreGroupes()
+      */
+      const std::pmr::vector<std::uint32_t>& membres(int numGroupe) const;
+
+      /**
+      * \brief Donne le mot qui a l'identifiant id
+      */
+      std::string_view mot(std::uint32_t id) const;
+
+      /**
+      * \brief Supprime tous les groupes et oublie tous les mots
+      */
+      void vider();
+
+   private:
+
+      std::pmr::deque<std::pmr::string> mots;                        // Identifiant -> mot (un ajout ne déplace pas les autres).
+      std::pmr::unordered_map<std::string_view, std::uint32_t> ids;  // Mot (vue sur mots) -> identifiant.
+      std::pmr::vector<std::pmr::vector<std::uint32_t> > groupes;    // Membres de chaque groupe.
+      std::pmr::vector<std::uint64_t> appartenances;                 // Clés _cle(groupe, identifiant) ou VIDE; taille puissance de 2.
+      std::size_t nbAppartenances;
+
+      static constexpr std::uint64_t VIDE = ~std::uint64_t(0);
+
+      static std::uint64_t _cle(int numGroupe, std::uint32_t id);
+
+      std::size_t _case(std::uint64_t cle) const;
+
+      bool _insererCle(std::uint64_t cle);
+
+      bool _effacerCle(std::uint64_t cle);
+
+      void _redimensionner(std::size_t nbCases);
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,234 @@
+/**
+* \file IndexRadicaux.h
+* \brief Table de hachage à adressage ouvert des radicaux vers les noeuds de l'arbre
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PolitiquesDico.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef _INDEXRADICAUX__H
+#define _INDEXRADICAUX__H
+
+namespace TP3
+{
+
+   /**
+   * \class IndexRadicaux
+   *
+   * \brief Table de hachage à adressage ouvert (à la « Swiss table ») d'un mot vers un T*.
+   *
+   * Les cases sont regroupées par 16. Chaque case a un octet de contrôle : VIDE, EFFACE,
+   * ou les 7 bits de poids faible du hachage (H2). Une recherche compare d'un coup les
+   * 16 octets de contrôle d'un groupe à H2 (SSE2, sinon une boucle), ne compare les clés que
+   * pour les cases candidates, et s'arrête au premier groupe qui contient une case VIDE.
+   * Les groupes sont visités en sondage quadratique à partir des bits de poids fort (H1).
+   * Le hachage et l'égalité des clés sont ceux de la politique d'ordre (voir PolitiquesDico.h).
+   *
+   */
+   template <typename T, typename Ordre = OrdreBinaire>
+   class IndexRadicaux
+   {
+   public:
+
+      static constexpr bool actif = true;
+
+      explicit IndexRadicaux(std::pmr::memory_resource* ressource = std::pmr::get_default_resource())
+         : controle(ressource), entrees(ressource), nbElements(0), nbEffaces(0) { }
+
+      /**
+      * \brief Donne la valeur associée à cle, ou nullptr si cle n'est pas dans l'index
+      */
+      T* trouver(std::string_view cle) const
+      {
+         if (nbElements == 0) return nullptr;
+         std::size_t hachage = Ordre::hacher(cle);
+         std::int8_t h2 = std::int8_t(hachage & 0x7f);
+         std::size_t masque = nbGroupes() - 1;
+         std::size_t groupe = (hachage >> 7) & masque;
+         for (std::size_t saut = 1; ; saut++)
+         {
+            const std::int8_t* c = &controle[groupe * LARGEUR];
+            for (unsigned int candidats = _egaux(c, h2); candidats != 0; candidats &= candidats - 1)
+            {
+               std::size_t i = groupe * LARGEUR + __builtin_ctz(candidats);
+               if (Ordre::comparer(entrees[i].cle, cle) == 0) return entrees[i].valeur;
+            }
+            if (_egaux(c, VIDE) != 0) return nullptr;
+            groupe = (groupe + saut) & masque;
+         }
+      }
+
+      /**
+      * \brief Associe valeur à cle, en remplaçant l'ancienne valeur s'il y en a une
+      */
+      void inserer(std::string_view cle, T* valeur)
+      {
+         if ((nbElements + nbEffaces + 1) * 8 > controle.size() * 7) // charge maximale de 7/8
+         {
+            _redimensionner(nbElements + 1 > controle.size() * 7 / 16 ? 2 * controle.size() : controle.size());
+         }
+         std::size_t hachage = Ordre::hacher(cle);
+         std::int8_t h2 = std::int8_t(hachage & 0x7f);
+         std::size_t masque = nbGroupes() - 1;
+         std::size_t groupe = (hachage >> 7) & masque;
+         std::size_t libre = controle.size(); // première case EFFACE ou VIDE rencontrée
+         for (std::size_t saut = 1; ; saut++)
+         {
+            const std::int8_t* c = &controle[groupe * LARGEUR];
+            for (unsigned int candidats = _egaux(c, h2); candidats != 0; candidats &= candidats - 1)
+            {
+               std::size_t i = groupe * LARGEUR + __builtin_ctz(candidats);
+               if (Ordre::comparer(entrees[i].cle, cle) == 0)
+               {
+                  entrees[i].valeur = valeur;
+                  return;
+               }
+            }
+            unsigned int effaces = _egaux(c, EFFACE);
+            if (libre == controle.size() && effaces != 0) libre = groupe * LARGEUR + __builtin_ctz(effaces);
+            unsigned int vides = _egaux(c, VIDE);
+            if (vides != 0)
+            {
+               if (libre == controle.size()) libre = groupe * LARGEUR + __builtin_ctz(vides);
+               break;
+            }
+            groupe = (groupe + saut) & masque;
+         }
+         if (controle[libre] == EFFACE) nbEffaces--;
+         controle[libre] = h2;
+         entrees[libre].cle = cle;
+         entrees[libre].valeur = valeur;
+         nbElements++;
+      }
+
+      /**
+      * \brief Retire cle de l'index
+      * \return false si cle n'y était pas
+      */
+      bool effacer(std::string_view cle)
+      {
+         if (nbElements == 0) return false;
+         std::size_t hachage = Ordre::hacher(cle);
+         std::int8_t h2 = std::int8_t(hachage & 0x7f);
+         std::size_t masque = nbGroupes() - 1;
+         std::size_t groupe = (hachage >> 7) & masque;
+         for (std::size_t saut = 1; ; saut++)
+         {
+            const std::int8_t* c = &controle[groupe * LARGEUR];
+            for (unsigned int candidats = _egaux(c, h2); candidats != 0; candidats &= candidats - 1)
+            {
+               std::size_t i = groupe * LARGEUR + __builtin_ctz(candidats);
+               if (Ordre::comparer(entrees[i].cle, cle) == 0)
+               {
+                  // Si le groupe a encore une case VIDE, aucune sonde n'a pu le traverser : la case redevient VIDE.
+                  controle[i] = _egaux(c, VIDE) != 0 ? VIDE : EFFACE;
+                  if (controle[i] == EFFACE) nbEffaces++;
+                  entrees[i].cle.clear();
+                  entrees[i].valeur = nullptr;
+                  nbElements--;
+                  return true;
+               }
+            }
+            if (_egaux(c, VIDE) != 0) return false;
+            groupe = (groupe + saut) & masque;
+         }
+      }
+
+      /**
+      * \brief Vide l'index
+      */
+      void vider()
+      {
+         controle.clear();
+         entrees.clear();
+         nbElements = nbEffaces = 0;
+      }
+
+      /**
+      * \brief Donne le nombre de clés dans l'index
+      */
+      std::size_t taille() const
+      {
+         return nbElements;
+      }
+
+   private:
+
+      static constexpr std::size_t LARGEUR = 16;    // Nombre de cases par groupe.
+      static constexpr std::int8_t VIDE = -128;     // 0x80
+      static constexpr std::int8_t EFFACE = -2;    // 0xFE
+
+      struct Entree
+      {
+         typedef std::pmr::polymorphic_allocator<char> allocator_type;   // La clé est rangée dans la ressource de l'index.
+
+         std::pmr::string cle;
+         T* valeur = nullptr;
+
+         explicit Entree(const allocator_type& allocateur = allocator_type()) : cle(allocateur) { }
+         Entree(const Entree& autre, const allocator_type& allocateur) : cle(autre.cle, allocateur), valeur(autre.valeur) { }
+      };
+
+      std::pmr::vector<std::int8_t> controle;    // Un octet de contrôle par case, capacité multiple de 16.
+      std::pmr::vector<Entree> entrees;
+      std::size_t nbElements;
+      std::size_t nbEffaces;
+
+      std::size_t nbGroupes() const
+      {
+         return controle.size() / LARGEUR;
+      }
+
+      /**
+      * \brief Masque des cases du groupe dont l'octet de contrôle vaut octet
+      */
+      static unsigned int _egaux(const std::int8_t* groupe, std::int8_t octet)
+      {
+#if defined(__SSE2__)
+         __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(groupe));
+         return _mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(octet)));
+#else
+         unsigned int masque = 0;
+         for (std::size_t i = 0; i < LARGEUR; i++)
+         {
+            masque |= unsigned(groupe[i] == octet) << i;
+         }
+         return masque;
+#endif
+      }
+
+      /**
+      * \brief Réinsère toutes les clés dans une table de la capacité donnée (puissance de 2, au moins 16)
+      */
+      void _redimensionner(std::size_t capacite)
+      {
+         if (capacite < LARGEUR) capacite = LARGEUR;
+         std::pmr::vector<std::int8_t> ancienControle(capacite, VIDE, controle.get_allocator());
+         std::pmr::vector<Entree> anciennesEntrees(capacite, entrees.get_allocator());
+         ancienControle.swap(controle);
+         anciennesEntrees.swap(entrees);
+         nbElements = nbEffaces = 0;
+         for (std::size_t i = 0; i < ancienControle.size(); i++)
+         {
+            if (ancienControle[i] >= 0) inserer(anciennesEntrees[i].cle, anciennesEntrees[i].valeur);
+         }
+      }
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,300 @@
+/**
+* \file IndexSimilitude.cpp
+* \brief Le code de la recherche des mots les plus semblables.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "IndexSimilitude.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <future>
+#include <queue>
+#include <thread>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TP3
+{
+    namespace
+    {
+        const std::size_t LARGEUR = IndexSimilitude::LARGEUR;
+
+#if defined(__AVX2__)
+        typedef __m256i Registre;
+
+        inline Registre repeter(unsigned char c) { return _mm256_set1_epi8(char(c)); }
+        inline Registre charger(const unsigned char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        inline void ranger(unsigned char* p, Registre r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r); }
+        inline Registre minimum(Registre a, Registre b) { return _mm256_min_epu8(a, b); }
+        inline Registre plus(Registre a, Registre b) { return _mm256_adds_epu8(a, b); } // saturé à 255
+        inline Registre differents(Registre a, Registre b) { return _mm256_andnot_si256(_mm256_cmpeq_epi8(a, b), repeter(1)); }
+#elif defined(__SSE2__)
+        typedef __m128i Registre;
+
+        inline Registre repeter(unsigned char c) { return _mm_set1_epi8(char(c)); }
+        inline Registre charger(const unsigned char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        inline void ranger(unsigned char* p, Registre r) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r); }
+        inline Registre minimum(Registre a, Registre b) { return _mm_min_epu8(a, b); }
+        inline Registre plus(Registre a, Registre b) { return _mm_adds_epu8(a, b); } // saturé à 255
+        inline Registre differents(Registre a, Registre b) { return _mm_andnot_si128(_mm_cmpeq_epi8(a, b), repeter(1)); }
+#else
+        struct Registre
+        {
+            unsigned char o[LARGEUR];
+        };
+
+        inline Registre repeter(unsigned char c) { Registre r; for (auto& x : r.o) x = c; return r; }
+        inline Registre charger(const unsigned char* p) { Registre r; for (std::size_t l = 0; l < LARGEUR; l++) r.o[l] = p[l]; return r; }
+        inline void ranger(unsigned char* p, Registre r) { for (std::size_t l = 0; l < LARGEUR; l++) p[l] = r.o[l]; }
+        inline Registre minimum(Registre a, Registre b) { for (std::size_t l = 0; l < LARGEUR; l++) a.o[l] = std::min(a.o[l], b.o[l]); return a; }
+        inline Registre plus(Registre a, Registre b) { for (std::size_t l = 0; l < LARGEUR; l++) a.o[l] = std::min(255, a.o[l] + b.o[l]); return a; }
+        inline Registre differents(Registre a, Registre b) { for (std::size_t l = 0; l < LARGEUR; l++) a.o[l] = a.o[l] != b.o[l]; return a; }
+#endif
+
+        /**
+         * \brief Bit de la signature qui représente le bigramme ab
+         */
+        inline unsigned bigramme(unsigned char a, unsigned char b)
+        {
+            return (((std::uint32_t(a) << 8) | b) * 2654435761u) >> 26;
+        }
+
+        std::uint64_t signature(const std::string& mot)
+        {
+            std::uint64_t s = 0;
+            for (std::size_t i = 0; i + 1 < mot.size(); i++)
+            {
+                s |= std::uint64_t(1) << bigramme(mot[i], mot[i + 1]);
+            }
+            return s;
+        }
+
+        /**
+         * \brief Distance de Levenshtein, un mot à la fois, pour les mots trop longs pour les blocs
+         */
+        int distanceEdition(const std::string& a, const std::string& b)
+        {
+            std::vector<int> ligne(b.size() + 1);
+            for (std::size_t j = 0; j <= b.size(); j++) ligne[j] = j;
+            for (std::size_t i = 1; i <= a.size(); i++)
+            {
+                int diagonale = ligne[0];
+                ligne[0] = i;
+                for (std::size_t j = 1; j <= b.size(); j++)
+                {
+                    int haut = ligne[j];
+                    ligne[j] = std::min(std::min(haut + 1, ligne[j - 1] + 1), diagonale + (a[i - 1] != b[j - 1]));
+                    diagonale = haut;
+                }
+            }
+            return ligne[b.size()];
+        }
+
+        /**
+         * \brief Distances entre la requête et les LARGEUR mots d'un bloc, une colonne de la matrice à la fois
+         *
+         * \param[in] colonnes les n caractères transposés du bloc
+         * \param[in] lettres chaque caractère de la requête, répété dans toutes les cases
+         * \param[in] m la longueur de la requête
+         * \param[in,out] d tampon de m + 1 registres
+         * \param[in] seuil le calcul s'arrête dès que toutes les distances dépassent seuil
+         * \param[out] distances la distance de chaque case du bloc
+         * \return false si le calcul s'est arrêté avant la fin (distances n'est alors pas rempli)
+         */
+        bool distancesBloc(const unsigned char* colonnes, std::size_t n, const Registre* lettres, std::size_t m,
+                           Registre* d, int seuil, unsigned char* distances)
+        {
+            const Registre un = repeter(1);
+            for (std::size_t i = 0; i <= m; i++) d[i] = repeter(i);
+            for (std::size_t j = 0; j < n; j++)
+            {
+                Registre c = charger(colonnes + j * LARGEUR);
+                Registre diagonale = d[0];
+                d[0] = repeter(j + 1);
+                Registre plusPetite = d[0];
+                for (std::size_t i = 1; i <= m; i++)
+                {
+                    Registre haut = d[i];
+                    d[i] = minimum(minimum(plus(haut, un), plus(d[i - 1], un)), plus(diagonale, differents(c, lettres[i - 1])));
+                    plusPetite = minimum(plusPetite, d[i]);
+                    diagonale = haut;
+                }
+                // Le minimum d'une colonne ne diminue jamais d'une colonne à l'autre : c'est une borne de la distance.
+                unsigned char bornes[LARGEUR];
+                ranger(bornes, plusPetite);
+                if (*std::min_element(bornes, bornes + LARGEUR) > seuil) return false;
+            }
+            ranger(distances, d[m]);
+            return true;
+        }
+    }
+
+    IndexSimilitude::IndexSimilitude()
+    {
+    }
+
+    void IndexSimilitude::construire(const std::vector<std::string>& mots)
+    {
+        this->mots = mots;
+        paquets.clear();
+        longs.clear();
+        std::vector<std::vector<std::uint32_t> > parLongueur(LONGUEUR_MAX + 1);
+        for (std::uint32_t i = 0; i < mots.size(); i++)
+        {
+            if (mots[i].size() > LONGUEUR_MAX) longs.push_back(i);
+            else parLongueur[mots[i].size()].push_back(i);
+        }
+        for (std::size_t n = 0; n <= LONGUEUR_MAX; n++)
+        {
+            if (parLongueur[n].empty()) continue;
+            Paquet p;
+            p.longueur = n;
+            std::size_t nbBlocs = (parLongueur[n].size() + LARGEUR - 1) / LARGEUR;
+            p.indices.assign(nbBlocs * LARGEUR, NUL);
+            p.colonnes.assign(nbBlocs * n * LARGEUR, 0);
+            p.signatures.assign(nbBlocs, 0);
+            for (std::size_t r = 0; r < parLongueur[n].size(); r++)
+            {
+                std::uint32_t i = parLongueur[n][r];
+                std::size_t b = r / LARGEUR, l = r % LARGEUR;
+                p.indices[r] = i;
+                for (std::size_t j = 0; j < n; j++) p.colonnes[(b * n + j) * LARGEUR + l] = mots[i][j];
+                p.signatures[b] |= signature(mots[i]);
+            }
+            paquets.push_back(std::move(p));
+        }
+    }
+
+    std::vector<std::pair<std::string, int> > IndexSimilitude::plusProches(const std::string& mot, std::size_t k) const
+    {
+        std::vector<std::pair<std::string, int> > resultat;
+        if (k == 0 || mots.empty()) return resultat;
+
+        typedef std::pair<int, std::uint32_t> Candidat;    // (distance, indice) : l'ordre des paires est celui du résultat
+        std::atomic<int> seuil(INT_MAX);                    // k-ième meilleure distance d'un des fils, borne de la k-ième globale
+        auto retenir = [&](std::priority_queue<Candidat>& meilleurs, Candidat c) {
+            if (meilleurs.size() < k) meilleurs.push(c);
+            else if (c < meilleurs.top())
+            {
+                meilleurs.pop();
+                meilleurs.push(c);
+            }
+            else return;
+            if (meilleurs.size() < k) return;
+            int courant = seuil.load();
+            while (meilleurs.top().first < courant && !seuil.compare_exchange_weak(courant, meilleurs.top().first)) { }
+        };
+
+        std::priority_queue<Candidat> principaux;
+        if (mot.size() > LONGUEUR_MAX) // requête trop longue pour les blocs : un mot à la fois
+        {
+            for (std::uint32_t i = 0; i < mots.size(); i++) retenir(principaux, Candidat(distanceEdition(mot, mots[i]), i));
+        }
+        else
+        {
+            for (std::uint32_t i : longs) retenir(principaux, Candidat(distanceEdition(mot, mots[i]), i));
+
+            int m = mot.size();
+            Registre lettres[LONGUEUR_MAX];
+            int compte[64] = {}; // occurrences des bigrammes de la requête, par bit de signature
+            std::uint64_t signatureMot = 0;
+            for (int i = 0; i < m; i++) lettres[i] = repeter(mot[i]);
+            for (int i = 0; i + 1 < m; i++)
+            {
+                unsigned b = bigramme(mot[i], mot[i + 1]);
+                compte[b]++;
+                signatureMot |= std::uint64_t(1) << b;
+            }
+            // Borne inférieure de la distance pour tout mot de longueur n d'un bloc : écart de longueur, et
+            // lemme des q-grammes (chaque opération détruit au plus 2 bigrammes).
+            auto borne = [&](int n, std::uint64_t signatureBloc) {
+                int resultat = std::abs(n - m);
+                int communs = 0;
+                for (std::uint64_t b = signatureMot & signatureBloc; b != 0; b &= b - 1) communs += compte[__builtin_ctzll(b)];
+                int manquants = std::max(n, m) - 1 - communs;
+                return std::max(resultat, (manquants + 1) / 2);
+            };
+
+            struct Tranche
+            {
+                std::uint32_t paquet, debut, fin;
+                int ecart;
+            };
+            const std::size_t BLOCS_PAR_TRANCHE = 64;
+            std::vector<Tranche> tranches;
+            std::size_t nbBlocs = 0;
+            for (std::uint32_t p = 0; p < paquets.size(); p++)
+            {
+                std::uint32_t n = paquets[p].signatures.size();
+                nbBlocs += n;
+                for (std::uint32_t debut = 0; debut < n; debut += BLOCS_PAR_TRANCHE)
+                {
+                    tranches.push_back(Tranche{p, debut, std::min<std::uint32_t>(n, debut + BLOCS_PAR_TRANCHE),
+                                               std::abs(int(paquets[p].longueur) - m)});
+                }
+            }
+            std::stable_sort(tranches.begin(), tranches.end(), [](const Tranche& a, const Tranche& b) { return a.ecart < b.ecart; });
+
+            std::atomic<std::size_t> prochaine(0);
+            auto travailler = [&](std::priority_queue<Candidat>& meilleurs) {
+                Registre d[LONGUEUR_MAX + 1];
+                unsigned char distances[LARGEUR];
+                for (std::size_t t = prochaine++; t < tranches.size(); t = prochaine++)
+                {
+                    const Tranche& tranche = tranches[t];
+                    if (tranche.ecart > seuil.load(std::memory_order_relaxed)) break; // les suivantes sont encore plus loin
+                    const Paquet& p = paquets[tranche.paquet];
+                    for (std::size_t b = tranche.debut; b < tranche.fin; b++)
+                    {
+                        if (borne(p.longueur, p.signatures[b]) > seuil.load(std::memory_order_relaxed)) continue;
+                        if (!distancesBloc(p.colonnes.data() + b * p.longueur * LARGEUR, p.longueur, lettres, m, d,
+                                           seuil.load(std::memory_order_relaxed), distances)) continue;
+                        for (std::size_t l = 0; l < LARGEUR; l++)
+                        {
+                            std::uint32_t i = p.indices[b * LARGEUR + l];
+                            if (i != NUL) retenir(meilleurs, Candidat(distances[l], i));
+                        }
+                    }
+                }
+            };
+
+            std::size_t nbFils = std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), nbBlocs / 256));
+            std::vector<std::priority_queue<Candidat> > parFil(nbFils - 1);
+            std::vector<std::future<void> > taches;
+            for (auto& meilleurs : parFil)
+            {
+                taches.push_back(std::async(std::launch::async, [&travailler, &meilleurs]() { travailler(meilleurs); }));
+            }
+            travailler(principaux);
+            for (auto& tache : taches) tache.get();
+            for (auto& meilleurs : parFil)
+            {
+                for (; !meilleurs.empty(); meilleurs.pop()) retenir(principaux, meilleurs.top());
+            }
+        }
+
+        std::vector<Candidat> tries;
+        for (; !principaux.empty(); principaux.pop()) tries.push_back(principaux.top());
+        for (auto itr = tries.rbegin(); itr != tries.rend(); ++itr)
+        {
+            resultat.emplace_back(mots[itr->second], itr->first);
+        }
+        return resultat;
+    }
+
+    std::size_t IndexSimilitude::taille() const
+    {
+        return mots.size();
+    }
+
+}//Fin du namespace
@@ -0,0 +1,93 @@
+/**
+* \file IndexSimilitude.h
+* \brief Interface de l'index des radicaux par longueur pour la recherche des mots les plus semblables
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _INDEXSIMILITUDE__H
+#define _INDEXSIMILITUDE__H
+
+namespace TP3
+{
+
+   /**
+   * \class IndexSimilitude
+   *
+   * \brief Donne les k mots d'un ensemble les plus proches d'un mot, en distance d'édition.
+   *
+   * Les mots sont rangés en paquets de même longueur, puis en blocs de LARGEUR mots
+   * transposés : le caractère j des LARGEUR mots d'un bloc est contigu. Un seul registre
+   * SIMD porte alors une case de la matrice de Levenshtein pour les LARGEUR mots à la fois
+   * (16 mots en SSE2, 32 en AVX2, distances sur 8 bits).
+   *
+   * Les blocs sont visités par écart de longueur croissant avec le mot cherché, en parallèle.
+   * Un bloc est sauté si une borne inférieure de la distance dépasse la k-ième meilleure
+   * distance trouvée jusque-là : l'écart de longueur, et le filtre de q-grammes (q = 2)
+   * calculé sur une signature de 64 bits des bigrammes du bloc.
+   *
+   */
+   class IndexSimilitude
+   {
+   public:
+
+      IndexSimilitude();
+
+      /**
+      * \brief Remplace les mots de l'index
+      * \pre mots est trié et sans doublon (l'ordre départage les distances égales)
+      */
+      void construire(const std::vector<std::string>& mots);
+
+      /**
+      * \brief Donne les k mots les plus proches de mot, avec leur distance d'édition
+      *
+      * \return au plus k paires (mot, distance), par distance croissante puis dans l'ordre des mots
+      */
+      std::vector<std::pair<std::string, int> > plusProches(const std::string& mot, std::size_t k) const;
+
+      /**
+      * \brief Donne le nombre de mots de l'index
+      */
+      std::size_t taille() const;
+
+#if defined(__AVX2__)
+      static constexpr std::size_t LARGEUR = 32;    // Mots par bloc, un par octet d'un registre.
+#else
+      static constexpr std::size_t LARGEUR = 16;
+#endif
+      static constexpr std::size_t LONGUEUR_MAX = 254; // Au-delà, les distances ne tiennent plus sur 8 bits.
+
+   private:
+
+      /**
+      * \brief Les mots d'une même longueur, par blocs transposés
+      */
+      struct Paquet
+      {
+         std::size_t longueur = 0;
+         std::vector<std::uint32_t> indices;        // Indice dans mots de chaque case; le dernier bloc est complété par NUL.
+         std::vector<unsigned char> colonnes;       // Bloc b, caractère j, case l : [(b * longueur + j) * LARGEUR + l].
+         std::vector<std::uint64_t> signatures;     // Par bloc : union des signatures de bigrammes de ses mots.
+      };
+
+      std::vector<std::string> mots;
+      std::vector<Paquet> paquets;                  // Un par longueur présente, jusqu'à LONGUEUR_MAX.
+      std::vector<std::uint32_t> longs;             // Mots plus longs que LONGUEUR_MAX, traités un à un.
+
+      static constexpr std::uint32_t NUL = 0xffffffffu;   // Case vide du dernier bloc d'un paquet.
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,295 @@
+/**
+* \file JournalDicoSynonymes.cpp
+* \brief Le code du journal en ajout seulement des modifications d'un DicoSynonymes.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "JournalDicoSynonymes.h"
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace TP3
+{
+    namespace
+    {
+        /**
+         * \brief Somme de contrôle FNV-1a sur 32 bits
+         */
+        std::uint32_t sommeControle(const char* donnees, std::size_t longueur)
+        {
+            std::uint32_t somme = 2166136261u;
+            for (std::size_t i = 0; i < longueur; i++)
+            {
+                somme = (somme ^ (unsigned char) donnees[i]) * 16777619u;
+            }
+            return somme;
+        }
+
+        void ecrireVarint(std::string& sortie, std::uint64_t valeur)
+        {
+            while (valeur >= 0x80)
+            {
+                sortie += char((valeur & 0x7f) | 0x80);
+                valeur >>= 7;
+            }
+            sortie += char(valeur);
+        }
+
+        /**
+         * \return false si les octets manquent avant la fin de la valeur
+         */
+        bool lireVarint(const std::string& entree, std::size_t& position, std::size_t fin, std::uint64_t& valeur)
+        {
+            valeur = 0;
+            for (int decalage = 0; position < fin && decalage < 64; decalage += 7)
+            {
+                unsigned char octet = entree[position++];
+                valeur |= std::uint64_t(octet & 0x7f) << decalage;
+                if ((octet & 0x80) == 0) return true;
+            }
+            return false;
+        }
+
+        void ecrireMot(std::string& sortie, const std::string& mot)
+        {
+            ecrireVarint(sortie, mot.size());
+            sortie += mot;
+        }
+
+        bool lireMot(const std::string& entree, std::size_t& position, std::size_t fin, std::string& mot)
+        {
+            std::uint64_t longueur;
+            if (!lireVarint(entree, position, fin, longueur) || longueur > fin - position) return false;
+            mot.assign(entree, position, longueur);
+            position += longueur;
+            return true;
+        }
+
+        void ecrireU32(std::string& sortie, std::uint32_t valeur)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                sortie += char((valeur >> (8 * i)) & 0xff);
+            }
+        }
+
+        std::uint32_t lireU32(const std::string& entree, std::size_t position)
+        {
+            std::uint32_t valeur = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                valeur |= std::uint32_t((unsigned char) entree[position + i]) << (8 * i);
+            }
+            return valeur;
+        }
+
+        std::string lireFichier(const std::string& chemin)
+        {
+            std::ifstream fichier(chemin, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(fichier), std::istreambuf_iterator<char>());
+        }
+
+        void ecrireTout(int fd, const std::string& donnees)
+        {
+            std::size_t ecrits = 0;
+            while (ecrits < donnees.size())
+            {
+                ssize_t n = ::write(fd, donnees.data() + ecrits, donnees.size() - ecrits);
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) throw std::runtime_error("JournalDicoSynonymes: erreur d'écriture");
+                ecrits += n;
+            }
+        }
+    }
+
+      /**
+      * \brief Ouvre (ou crée) un journal en ajout
+      *
+      * \param[in] chemin le chemin du fichier de journal
+      * \param[in] tailleLot le nombre d'enregistrements accumulés avant une synchronisation sur disque
+      *
+      * \post Une fin de journal incomplète est tronquée et la numérotation reprend après
+      *       le dernier enregistrement valide.
+      * \exception runtime_error si le fichier ne peut pas être ouvert
+      */
+    JournalDicoSynonymes::JournalDicoSynonymes(const std::string& chemin, std::size_t tailleLot)
+        : chemin(chemin), fd(-1), tailleLot(tailleLot == 0 ? 1 : tailleLot), nbEnAttente(0), numero(0)
+    {
+        std::string contenu = lireFichier(chemin);
+        std::size_t valide = 0;
+        Enregistrement enregistrement;
+        for (std::size_t suivant; (suivant = _decoder(contenu, valide, enregistrement)) != 0; valide = suivant)
+        {
+            numero = enregistrement.numero;
+        }
+        fd = ::open(chemin.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) throw std::runtime_error("JournalDicoSynonymes: impossible d'ouvrir " + chemin);
+        if (valide < contenu.size() && ::ftruncate(fd, valide) != 0) // lot interrompu par une panne
+        {
+            ::close(fd);
+            throw std::runtime_error("JournalDicoSynonymes: impossible de tronquer " + chemin);
+        }
+    }
+
+      /**
+      * \brief Destructeur, synchronise le dernier lot
+      */
+    JournalDicoSynonymes::~JournalDicoSynonymes()
+    {
+        try
+        {
+            synchroniser();
+        }
+        catch (const std::runtime_error&)
+        {
+            // on ne peut pas lancer d'exception d'un destructeur; le lot est perdu comme lors d'une panne
+        }
+        ::close(fd);
+    }
+
+      /**
+      * \brief Ajoute une opération au lot courant et synchronise le lot s'il est plein
+      *
+      * \return le numéro attribué à l'enregistrement
+      * \exception runtime_error si l'écriture sur disque échoue
+      */
+    std::uint64_t JournalDicoSynonymes::ajouter(Operation operation, const std::string& mot1, const std::string& mot2, int numGroupe)
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        std::string corps;
+        ecrireVarint(corps, numero + 1);
+        corps += char(operation);
+        ecrireMot(corps, mot1);
+        ecrireMot(corps, mot2);
+        ecrireVarint(corps, (std::uint32_t(numGroupe) << 1) ^ std::uint32_t(numGroupe >> 31)); // zigzag: -1 tient sur un octet
+        ecrireU32(lot, corps.size());
+        ecrireU32(lot, sommeControle(corps.data(), corps.size()));
+        lot += corps;
+        numero++;
+        if (++nbEnAttente >= tailleLot)
+        {
+            _ecrireLot();
+        }
+        return numero;
+    }
+
+      /**
+      * \brief Écrit le lot courant et attend qu'il soit sur disque
+      *
+      * \exception runtime_error si l'écriture sur disque échoue
+      */
+    void JournalDicoSynonymes::synchroniser()
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        _ecrireLot();
+    }
+
+      /**
+      * \brief Donne le numéro du dernier enregistrement ajouté (0 si le journal est vide)
+      */
+    std::uint64_t JournalDicoSynonymes::dernierNumero() const
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        return numero;
+    }
+
+      /**
+      * \brief Retire du journal les enregistrements de numéro inférieur ou égal à numero
+      *
+      * \post Le fichier est réécrit puis remplacé atomiquement; les ajouts concurrents attendent.
+      * \exception runtime_error si la réécriture échoue
+      */
+    void JournalDicoSynonymes::tronquerJusqua(std::uint64_t numeroLimite)
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        _ecrireLot();
+        std::string contenu = lireFichier(chemin);
+        std::size_t position = 0;
+        Enregistrement enregistrement;
+        for (std::size_t suivant; (suivant = _decoder(contenu, position, enregistrement)) != 0; position = suivant)
+        {
+            if (enregistrement.numero > numeroLimite) break;
+        }
+        std::string temporaire = chemin + ".tmp";
+        int nouveau = ::open(temporaire.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (nouveau < 0) throw std::runtime_error("JournalDicoSynonymes: impossible de créer " + temporaire);
+        try
+        {
+            ecrireTout(nouveau, contenu.substr(position));
+        }
+        catch (const std::runtime_error&)
+        {
+            ::close(nouveau);
+            throw;
+        }
+        if (::fdatasync(nouveau) != 0 || std::rename(temporaire.c_str(), chemin.c_str()) != 0)
+        {
+            ::close(nouveau);
+            throw std::runtime_error("JournalDicoSynonymes: impossible de remplacer " + chemin);
+        }
+        ::close(fd);
+        fd = nouveau;
+    }
+
+      /**
+      * \brief Lit tous les enregistrements valides d'un fichier de journal
+      *
+      * \return les enregistrements dans l'ordre, vide si le fichier n'existe pas
+      */
+    std::vector<JournalDicoSynonymes::Enregistrement> JournalDicoSynonymes::lire(const std::string& chemin)
+    {
+        std::string contenu = lireFichier(chemin);
+        std::vector<Enregistrement> enregistrements;
+        std::size_t position = 0;
+        Enregistrement enregistrement;
+        for (std::size_t suivant; (suivant = _decoder(contenu, position, enregistrement)) != 0; position = suivant)
+        {
+            enregistrements.push_back(enregistrement);
+        }
+        return enregistrements;
+    }
+
+    /**
+     * \brief Écrit le lot courant puis attend qu'il soit sur disque (verrou déjà pris)
+     */
+    void JournalDicoSynonymes::_ecrireLot()
+    {
+        if (lot.empty()) return;
+        ecrireTout(fd, lot);
+        if (::fdatasync(fd) != 0) throw std::runtime_error("JournalDicoSynonymes: fdatasync a échoué");
+        lot.clear();
+        nbEnAttente = 0;
+    }
+
+    /**
+     * \brief Décode l'enregistrement qui commence à position
+     * \return la position qui suit l'enregistrement, ou 0 s'il est incomplet ou corrompu
+     */
+    std::size_t JournalDicoSynonymes::_decoder(const std::string& donnees, std::size_t position, Enregistrement& enregistrement)
+    {
+        if (donnees.size() - position < 8) return 0;
+        std::uint32_t longueur = lireU32(donnees, position);
+        std::uint32_t somme = lireU32(donnees, position + 4);
+        std::size_t debut = position + 8;
+        if (longueur > donnees.size() - debut || sommeControle(donnees.data() + debut, longueur) != somme) return 0;
+        std::size_t fin = debut + longueur;
+        std::uint64_t numero, groupe;
+        if (!lireVarint(donnees, debut, fin, numero) || debut >= fin) return 0;
+        enregistrement.numero = numero;
+        enregistrement.operation = Operation((unsigned char) donnees[debut++]);
+        if (!lireMot(donnees, debut, fin, enregistrement.mot1) || !lireMot(donnees, debut, fin, enregistrement.mot2)
+            || !lireVarint(donnees, debut, fin, groupe)) return 0;
+        enregistrement.numGroupe = int(std::uint32_t(groupe >> 1) ^ -std::uint32_t(groupe & 1));
+        return fin;
+    }
+
+}//Fin du namespace
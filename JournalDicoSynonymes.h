@@ -0,0 +1,135 @@
+/**
+* \file JournalDicoSynonymes.h
+* \brief Interface du journal en ajout seulement des modifications d'un DicoSynonymes
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#ifndef _JOURNALDICOSYNONYMES__H
+#define _JOURNALDICOSYNONYMES__H
+
+namespace TP3
+{
+
+   /**
+   * \class JournalDicoSynonymes
+   *
+   * \brief Journal binaire en ajout seulement des opérations de modification d'un dictionnaire.
+   *
+   * Chaque enregistrement est [longueur u32][somme de contrôle u32][corps], le corps contenant
+   * le numéro de l'enregistrement, l'opération, deux mots et un numéro de groupe encodés en
+   * entiers de longueur variable. Les enregistrements sont accumulés en mémoire et écrits avec
+   * un seul fdatasync par lot (validation groupée). À la lecture, on s'arrête au premier
+   * enregistrement incomplet ou corrompu, ce qui correspond à un lot interrompu par une panne.
+   *
+   */
+   class JournalDicoSynonymes
+   {
+   public:
+
+      enum Operation : std::uint8_t
+      {
+         AJOUTER_RADICAL = 1,
+         AJOUTER_FLEXION,
+         AJOUTER_SYNONYME,
+         SUPPRIMER_RADICAL,
+         SUPPRIMER_FLEXION,
+         SUPPRIMER_SYNONYME
+      };
+
+      /**
+      * \brief Une opération lue du journal
+      */
+      struct Enregistrement
+      {
+         std::uint64_t numero;
+         Operation operation;
+         std::string mot1;      // Le radical visé par l'opération.
+         std::string mot2;      // La flexion ou le synonyme, vide sinon.
+         int numGroupe;         // Le numéro de groupe passé à ajouterSynonyme/supprimerSynonyme, les traits pour ajouterFlexion.
+      };
+
+      /**
+      * \brief Ouvre (ou crée) un journal en ajout
+      *
+      * \param[in] chemin le chemin du fichier de journal
+      * \param[in] tailleLot le nombre d'enregistrements accumulés avant une synchronisation sur disque
+      *
+      * \post Une fin de journal incomplète est tronquée et la numérotation reprend après
+      *       le dernier enregistrement valide.
+      * \exception runtime_error si le fichier ne peut pas être ouvert
+      */
+      JournalDicoSynonymes(const std::string& chemin, std::size_t tailleLot = 64);
+
+      /**
+      * \brief Destructeur, synchronise le dernier lot
+      */
+      ~JournalDicoSynonymes();
+
+      JournalDicoSynonymes(const JournalDicoSynonymes&) = delete;
+      JournalDicoSynonymes& operator=(const JournalDicoSynonymes&) = delete;
+
+      /**
+      * \brief Ajoute une opération au lot courant et synchronise le lot s'il est plein
+      *
+      * \return le numéro attribué à l'enregistrement
+      * \exception runtime_error si l'écriture sur disque échoue
+      */
+      std::uint64_t ajouter(Operation operation, const std::string& mot1, const std::string& mot2 = "", int numGroupe = 0);
+
+      /**
+      * \brief Écrit le lot courant et attend qu'il soit sur disque
+      *
+      * \exception runtime_error si l'écriture sur disque échoue
+      */
+      void synchroniser();
+
+      /**
+      * \brief Donne le numéro du dernier enregistrement ajouté (0 si le journal est vide)
+      */
+      std::uint64_t dernierNumero() const;
+
+      /**
+      * \brief Retire du journal les enregistrements de numéro inférieur ou égal à numeroLimite
+      *
+      * \post Le fichier est réécrit puis remplacé atomiquement; les ajouts concurrents attendent.
+      * \exception runtime_error si la réécriture échoue
+      */
+      void tronquerJusqua(std::uint64_t numeroLimite);
+
+      /**
+      * \brief Lit tous les enregistrements valides d'un fichier de journal
+      *
+      * \return les enregistrements dans l'ordre, vide si le fichier n'existe pas
+      */
+      static std::vector<Enregistrement> lire(const std::string& chemin);
+
+   private:
+
+      std::string chemin;
+      int fd;
+      std::size_t tailleLot;
+      std::size_t nbEnAttente;         // Nombre d'enregistrements dans lot.
+      std::string lot;                 // Enregistrements encodés pas encore écrits.
+      std::uint64_t numero;
+      mutable std::mutex verrou;
+
+      void _ecrireLot();
+
+      static std::size_t _decoder(const std::string& donnees, std::size_t position, Enregistrement& enregistrement);
+   };
+
+}//Fin du namespace
+
+#endif
@@ -0,0 +1,330 @@
+/**
+* \file ParadigmesFlexions.cpp
+* \brief Le code des paradigmes de flexion et des flexions d'un radical.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "ParadigmesFlexions.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace TP3
+{
+
+    namespace
+    {
+        void serialiser(const RegleFlexion& regle, std::pmr::string& cle)
+        {
+            cle += static_cast<char>(regle.retirer);
+            std::uint32_t valeur = regle.retirer == RegleFlexion::EXCEPTION ? regle.exception : std::uint32_t(regle.suffixe.size());
+            cle.append(reinterpret_cast<const char*>(&valeur), sizeof(valeur));
+            cle += regle.suffixe;
+        }
+
+        /**
+         * \brief Donne les octets qu'une chaîne réserve hors de l'objet
+         */
+        std::size_t horsObjet(const std::pmr::string& chaine)
+        {
+            return chaine.capacity() > std::pmr::string().capacity() ? chaine.capacity() + 1 : 0;
+        }
+    }
+
+    ParadigmesFlexions::ParadigmesFlexions(std::pmr::memory_resource* ressource)
+        : ressource(ressource), parCle(ressource), suivants(ressource), nbInutilises(0), nbReglesUtilisees(0), nbOctets(0)
+    {
+    }
+
+    const Paradigme* ParadigmesFlexions::interner(const Paradigme& paradigme)
+    {
+        if (paradigme.empty()) return nullptr;
+        std::lock_guard<std::mutex> garde(verrou);
+        Rangement* rangement = _ranger(paradigme);
+        _retenir(*rangement);
+        return rangement;
+    }
+
+    const Paradigme* ParadigmesFlexions::ajouter(const Paradigme* paradigme, const RegleFlexion& regle)
+    {
+        // Les radicaux d'un même paradigme ajoutent leurs flexions dans le même ordre : le
+        // paradigme suivant est presque toujours déjà connu, sans recopier les règles
+        std::pmr::string cle(reinterpret_cast<const char*>(&paradigme), sizeof(paradigme));
+        serialiser(regle, cle);
+        std::lock_guard<std::mutex> garde(verrou);
+        auto existant = suivants.find(cle);
+        if (existant != suivants.end())
+        {
+            _retenir(*existant->second);
+            return existant->second;
+        }
+        Paradigme nouvelles = paradigme == nullptr ? Paradigme() : *paradigme;
+        nouvelles.push_back(regle);
+        Rangement* suivant = _ranger(nouvelles);
+        _retenir(*suivant);
+        auto insere = suivants.emplace(std::move(cle), suivant).first;
+        nbOctets += insere->first.size() + horsObjet(insere->first);
+        // la transition disparaît avec le premier de ses deux paradigmes qui est libéré
+        suivant->transitions.push_back(&insere->first);
+        if (paradigme != nullptr)
+        {
+            const_cast<Rangement*>(static_cast<const Rangement*>(paradigme))->transitions.push_back(&insere->first);
+        }
+        return suivant;
+    }
+
+    const Paradigme* ParadigmesFlexions::retenir(const Paradigme* paradigme)
+    {
+        if (paradigme == nullptr) return nullptr;
+        std::lock_guard<std::mutex> garde(verrou);
+        _retenir(*const_cast<Rangement*>(static_cast<const Rangement*>(paradigme)));
+        return paradigme;
+    }
+
+    void ParadigmesFlexions::liberer(const Paradigme* paradigme)
+    {
+        if (paradigme == nullptr) return;
+        std::lock_guard<std::mutex> garde(verrou);
+        _liberer(*const_cast<Rangement*>(static_cast<const Rangement*>(paradigme)));
+    }
+
+    std::size_t ParadigmesFlexions::nombre() const
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        return parCle.size() - nbInutilises;
+    }
+
+    std::size_t ParadigmesFlexions::octets() const
+    {
+        std::lock_guard<std::mutex> garde(verrou);
+        return nbOctets;
+    }
+
+    /**
+     * \brief Donne le paradigme rangé égal à paradigme, en rangeant une copie dans la ressource s'il
+     *        ne l'est pas encore; le verrou doit être pris
+     */
+    ParadigmesFlexions::Rangement* ParadigmesFlexions::_ranger(const Paradigme& paradigme)
+    {
+        std::pmr::string cle;
+        for (const RegleFlexion& regle : paradigme) serialiser(regle, cle);
+        auto existant = parCle.find(cle);
+        if (existant != parCle.end()) return &existant->second;
+        auto insere = parCle.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(cle)), std::forward_as_tuple()).first;
+        Rangement& rangement = insere->second;
+        rangement.reserve(paradigme.size());
+        rangement.octets = sizeof(*insere) + insere->first.size() + horsObjet(insere->first);
+        for (const RegleFlexion& regle : paradigme)
+        {
+            rangement.push_back(RegleFlexion{regle.retirer, regle.exception, std::pmr::string(regle.suffixe, ressource)});
+            rangement.octets += horsObjet(rangement.back().suffixe);
+        }
+        rangement.octets += rangement.capacity() * sizeof(RegleFlexion);
+        rangement.cle = &insere->first;
+        nbOctets += rangement.octets;
+        nbInutilises++; // jusqu'à sa première référence
+        return &rangement;
+    }
+
+    /**
+     * \brief Compte une référence à rangement; le verrou doit être pris
+     */
+    void ParadigmesFlexions::_retenir(Rangement& rangement)
+    {
+        if (rangement.references++ != 0) return;
+        nbInutilises--;
+        nbReglesUtilisees += rangement.size();
+    }
+
+    /**
+     * \brief Rend une référence à rangement, puis libère les paradigmes inutilisés s'ils sont plus
+     *        nombreux que les règles des paradigmes utilisés; le verrou doit être pris
+     */
+    void ParadigmesFlexions::_liberer(Rangement& rangement)
+    {
+        if (--rangement.references != 0) return;
+        nbInutilises++;
+        nbReglesUtilisees -= rangement.size();
+        if (nbInutilises <= INUTILISES_MIN + nbReglesUtilisees) return;
+        for (auto itr = parCle.begin(); itr != parCle.end();)
+        {
+            if (itr->second.references != 0)
+            {
+                ++itr;
+                continue;
+            }
+            _oublier(itr->second);
+            nbOctets -= itr->second.octets;
+            itr = parCle.erase(itr);
+        }
+        nbInutilises = 0;
+    }
+
+    /**
+     * \brief Retire de suivants les transitions qui partent de rangement ou y mènent; le verrou doit être pris
+     */
+    void ParadigmesFlexions::_oublier(Rangement& rangement)
+    {
+        for (const std::pmr::string* cle : rangement.transitions)
+        {
+            auto transition = suivants.find(*cle);
+            const Paradigme* depart = nullptr;
+            std::memcpy(&depart, cle->data(), sizeof(depart));
+            Rangement* autre = transition->second != &rangement ? transition->second
+                                                                : const_cast<Rangement*>(static_cast<const Rangement*>(depart));
+            if (autre != nullptr)
+            {
+                auto& transitions = autre->transitions;
+                transitions.erase(std::find(transitions.begin(), transitions.end(), cle));
+            }
+            nbOctets -= transition->first.size() + horsObjet(transition->first);
+            suivants.erase(transition);
+        }
+        rangement.transitions.clear();
+    }
+
+    FlexionsRadical::FlexionsRadical(const std::pmr::string& radical, ParadigmesFlexions& paradigmes, std::pmr::memory_resource* ressource)
+        : radical(&radical), paradigmes(&paradigmes), regles(nullptr), exceptions(ressource)
+    {
+    }
+
+    FlexionsRadical::~FlexionsRadical()
+    {
+        paradigmes->liberer(regles);
+    }
+
+    FlexionsRadical& FlexionsRadical::operator=(const FlexionsRadical& autre)
+    {
+        if (this == &autre) return *this;
+        if (autre.paradigmes == paradigmes) _remplacer(paradigmes->retenir(autre.regles));
+        else _remplacer(autre.regles == nullptr ? nullptr : paradigmes->interner(*autre.regles));
+        exceptions.assign(autre.exceptions.begin(), autre.exceptions.end());
+        return *this;
+    }
+
+    FlexionsRadical::const_iterator FlexionsRadical::begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    FlexionsRadical::const_iterator FlexionsRadical::end() const
+    {
+        return const_iterator(this, size());
+    }
+
+    std::size_t FlexionsRadical::size() const
+    {
+        return regles == nullptr ? 0 : regles->size();
+    }
+
+    bool FlexionsRadical::empty() const
+    {
+        return regles == nullptr;
+    }
+
+    std::pmr::string FlexionsRadical::forme(std::size_t i) const
+    {
+        const RegleFlexion& regle = (*regles)[i];
+        if (regle.retirer == RegleFlexion::EXCEPTION) return exceptions[regle.exception];
+        std::pmr::string resultat(std::string_view(*radical).substr(0, radical->size() - regle.retirer));
+        resultat += regle.suffixe;
+        return resultat;
+    }
+
+    void FlexionsRadical::forme(std::size_t i, std::string& resultat) const
+    {
+        const RegleFlexion& regle = (*regles)[i];
+        if (regle.retirer == RegleFlexion::EXCEPTION)
+        {
+            resultat.assign(exceptions[regle.exception]);
+            return;
+        }
+        std::size_t garde = radical->size() - regle.retirer;
+        resultat.reserve(garde + regle.suffixe.size()); // une seule allocation pour les formes longues
+        resultat.assign(*radical, 0, garde);
+        resultat += regle.suffixe;
+    }
+
+    FlexionsRadical::const_iterator FlexionsRadical::trouver(std::string_view forme) const
+    {
+        for (std::size_t i = 0; i < size(); i++)
+        {
+            if (_egale((*regles)[i], forme)) return const_iterator(this, i);
+        }
+        return end();
+    }
+
+    void FlexionsRadical::push_back(std::string_view forme)
+    {
+        _remplacer(paradigmes->ajouter(regles, _regle(forme)));
+    }
+
+    FlexionsRadical::const_iterator FlexionsRadical::erase(const_iterator position)
+    {
+        Paradigme nouvelles;
+        const RegleFlexion& retiree = (*regles)[position.position];
+        for (std::size_t i = 0; i < regles->size(); i++)
+        {
+            if (i == position.position) continue;
+            nouvelles.push_back((*regles)[i]);
+            RegleFlexion& regle = nouvelles.back();
+            // les exceptions qui suivent celle retirée reculent d'une place
+            if (retiree.retirer == RegleFlexion::EXCEPTION && regle.retirer == RegleFlexion::EXCEPTION
+                && regle.exception > retiree.exception) regle.exception--;
+        }
+        if (retiree.retirer == RegleFlexion::EXCEPTION) exceptions.erase(exceptions.begin() + retiree.exception);
+        _remplacer(paradigmes->interner(nouvelles));
+        return const_iterator(this, position.position);
+    }
+
+    const Paradigme* FlexionsRadical::paradigme() const
+    {
+        return regles;
+    }
+
+    std::size_t FlexionsRadical::nombreExceptions() const
+    {
+        return exceptions.size();
+    }
+
+    /**
+     * \brief Donne la règle de forme par rapport au radical; une forme irrégulière est ajoutée aux exceptions
+     */
+    RegleFlexion FlexionsRadical::_regle(std::string_view forme)
+    {
+        std::size_t commun = 0;
+        while (commun < radical->size() && commun < forme.size() && (*radical)[commun] == forme[commun]) commun++;
+        if (commun == 0 || radical->size() - commun > RETRAIT_MAX)
+        {
+            exceptions.emplace_back(forme);
+            return RegleFlexion{RegleFlexion::EXCEPTION, std::uint32_t(exceptions.size() - 1), std::pmr::string()};
+        }
+        return RegleFlexion{std::uint8_t(radical->size() - commun), 0, std::pmr::string(forme.substr(commun))};
+    }
+
+    /**
+     * \brief Dit si la règle donne forme, sans construire la flexion
+     */
+    bool FlexionsRadical::_egale(const RegleFlexion& regle, std::string_view forme) const
+    {
+        if (regle.retirer == RegleFlexion::EXCEPTION) return std::string_view(exceptions[regle.exception]) == forme;
+        std::size_t garde = radical->size() - regle.retirer;
+        return forme.size() == garde + regle.suffixe.size() && forme.compare(0, garde, std::string_view(*radical).substr(0, garde)) == 0
+               && forme.compare(garde, std::string_view::npos, regle.suffixe) == 0;
+    }
+
+    /**
+     * \brief Prend nouvelles, dont on détient une référence, à la place du paradigme courant
+     */
+    void FlexionsRadical::_remplacer(const Paradigme* nouvelles)
+    {
+        paradigmes->liberer(regles);
+        regles = nouvelles;
+    }
+
+}//Fin du namespace
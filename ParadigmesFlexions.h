@@ -0,0 +1,275 @@
+/**
+* \file ParadigmesFlexions.h
+* \brief Interface des paradigmes de flexion partagés et des flexions d'un radical rangées par paradigme
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _PARADIGMESFLEXIONS__H
+#define _PARADIGMESFLEXIONS__H
+
+namespace TP3
+{
+
+   /**
+   * \brief Comment obtenir une flexion à partir de son radical : retirer quelques octets à la fin du
+   *        radical puis ajouter un suffixe, ou prendre la forme telle quelle parmi les exceptions du radical.
+   */
+   struct RegleFlexion
+   {
+      static constexpr std::uint8_t EXCEPTION = 0xff;
+
+      std::uint8_t retirer;        // Octets retirés à la fin du radical, ou EXCEPTION.
+      std::uint32_t exception;     // Si retirer vaut EXCEPTION : la position de la forme dans les exceptions du radical.
+      std::pmr::string suffixe;
+   };
+
+   /**
+   * \brief Les règles des flexions d'un radical, dans leur ordre d'ajout
+   */
+   typedef std::pmr::vector<RegleFlexion> Paradigme;
+
+   /**
+   * \class ParadigmesFlexions
+   *
+   * \brief Registre des paradigmes d'un dictionnaire.
+   *
+   * La plupart des radicaux se fléchissent de la même façon (grand : +s, +e, +es; bateau : +x;
+   * cheval : -l +ux) : chaque paradigme distinct n'est rangé qu'une fois et les radicaux en
+   * gardent un pointeur. Chaque pointeur rendu par interner, ajouter ou retenir compte une
+   * référence, que son détenteur rend avec liberer. Un paradigme rangé ne change plus et vit tant
+   * qu'il a une référence, ce qui permet de le lire sans verrou; seules les méthodes du registre
+   * prennent le verrou. Un paradigme qui n'a plus de référence reste rangé, car les radicaux qui
+   * ajoutent leurs flexions une à une repassent par les mêmes débuts de paradigme, jusqu'à ce que
+   * ces paradigmes inutilisés dépassent en nombre les règles des paradigmes utilisés : ils sont
+   * alors tous libérés. La mémoire du registre dépend donc des paradigmes utilisés, et non du
+   * nombre de modifications faites. Les paradigmes, leurs suffixes et les clés sont alloués dans
+   * la ressource du registre.
+   *
+   */
+   class ParadigmesFlexions
+   {
+   public:
+
+      /**
+      * \param[in] ressource la mémoire des paradigmes rangés; elle doit survivre au registre
+      */
+      explicit ParadigmesFlexions(std::pmr::memory_resource* ressource = std::pmr::get_default_resource());
+
+      ParadigmesFlexions(const ParadigmesFlexions&) = delete;
+      ParadigmesFlexions& operator=(const ParadigmesFlexions&) = delete;
+
+      /**
+      * \brief Donne le paradigme rangé égal à paradigme, en le rangeant s'il ne l'est pas encore
+      * \return nullptr si paradigme est vide; sinon une référence à rendre avec liberer
+      */
+      const Paradigme* interner(const Paradigme& paradigme);
+
+      /**
+      * \brief Donne le paradigme rangé fait des règles de paradigme suivies de regle
+      * \param[in] paradigme un paradigme rangé dans ce registre, ou nullptr pour le paradigme vide
+      * \return une référence à rendre avec liberer; celle de paradigme est gardée
+      */
+      const Paradigme* ajouter(const Paradigme* paradigme, const RegleFlexion& regle);
+
+      /**
+      * \brief Compte une référence de plus à un paradigme rangé dans ce registre
+      * \return paradigme
+      */
+      const Paradigme* retenir(const Paradigme* paradigme);
+
+      /**
+      * \brief Rend une référence obtenue de interner, ajouter ou retenir
+      * \param[in] paradigme un paradigme rangé dans ce registre, ou nullptr
+      */
+      void liberer(const Paradigme* paradigme);
+
+      /**
+      * \brief Donne le nombre de paradigmes rangés qui ont au moins une référence
+      */
+      std::size_t nombre() const;
+
+      /**
+      * \brief Donne le nombre d'octets réservés par les paradigmes rangés (règles, suffixes et clés)
+      */
+      std::size_t octets() const;
+
+   private:
+
+      /**
+      * \brief Un paradigme rangé, avec ses références et les transitions de suivants qui le touchent
+      */
+      struct Rangement : Paradigme
+      {
+         explicit Rangement(const allocator_type& allocateur) : Paradigme(allocateur), references(0), cle(nullptr),
+                                                                 octets(0), transitions(allocateur) { }
+
+         std::size_t references;
+         const std::pmr::string* cle;                           // Sa clé dans parCle.
+         std::size_t octets;                                    // Compté dans nbOctets.
+         std::pmr::vector<const std::pmr::string*> transitions; // Clés de suivants qui en partent ou y mènent.
+      };
+
+      static constexpr std::size_t INUTILISES_MIN = 64;         // En deçà, les paradigmes inutilisés ne sont pas libérés.
+
+      mutable std::mutex verrou;
+      std::pmr::memory_resource* ressource;
+      std::pmr::unordered_map<std::pmr::string, Rangement> parCle;          // Paradigme sérialisé -> paradigme rangé (noeuds stables).
+      std::pmr::unordered_map<std::pmr::string, Rangement*> suivants;       // Paradigme rangé et règle ajoutée -> paradigme rangé.
+      std::size_t nbInutilises;                                             // Paradigmes rangés sans référence.
+      std::size_t nbReglesUtilisees;                                        // Règles des paradigmes qui ont une référence.
+      std::size_t nbOctets;
+
+      Rangement* _ranger(const Paradigme& paradigme);
+      void _retenir(Rangement& rangement);
+      void _liberer(Rangement& rangement);
+      void _oublier(Rangement& rangement);
+   };
+
+   /**
+   * \class FlexionsRadical
+   *
+   * \brief Les flexions d'un radical, rangées comme un paradigme partagé plus les formes qui n'en
+   *        suivent pas les règles.
+   *
+   * Une flexion est régulière si elle garde au moins le premier octet du radical et n'en retire
+   * pas plus de RETRAIT_MAX à la fin; sinon (aller : vais, oeil : yeux) elle est rangée en entier
+   * dans les exceptions du radical. Les formes sont recalculées à la lecture : un itérateur donne
+   * des chaînes par valeur, dans l'ordre d'ajout, et trouver les compare sans les construire.
+   *
+   */
+   class FlexionsRadical
+   {
+   public:
+
+      static constexpr std::size_t RETRAIT_MAX = 3;
+
+      class const_iterator
+      {
+      public:
+         typedef std::input_iterator_tag iterator_category;
+         typedef std::pmr::string value_type;
+         typedef std::ptrdiff_t difference_type;
+         typedef const std::pmr::string* pointer;
+         typedef std::pmr::string reference;
+
+         const_iterator(const FlexionsRadical* flexions, std::size_t position) : flexions(flexions), position(position) { }
+         std::pmr::string operator*() const { return flexions->forme(position); }
+         const_iterator& operator++() { ++position; return *this; }
+         const_iterator operator++(int) { const_iterator avant = *this; ++position; return avant; }
+         bool operator==(const const_iterator& autre) const { return position == autre.position; }
+         bool operator!=(const const_iterator& autre) const { return position != autre.position; }
+
+      private:
+         friend class FlexionsRadical;
+         const FlexionsRadical* flexions;
+         std::size_t position;
+      };
+
+      /**
+      * \param[in] radical le radical dont ce sont les flexions; il doit vivre aussi longtemps que l'objet
+      * \param[in] paradigmes le registre où ranger le paradigme; il doit vivre aussi longtemps que l'objet
+      * \param[in] ressource la mémoire des exceptions
+      */
+      FlexionsRadical(const std::pmr::string& radical, ParadigmesFlexions& paradigmes, std::pmr::memory_resource* ressource);
+
+      FlexionsRadical(const FlexionsRadical&) = delete;
+
+      ~FlexionsRadical();
+
+      /**
+      * \brief Recopie le paradigme et les exceptions de autre, qui doit avoir le même radical
+      *
+      * Si autre range son paradigme dans un autre registre (un autre dictionnaire), le paradigme
+      * est rangé dans celui de l'objet.
+      */
+      FlexionsRadical& operator=(const FlexionsRadical& autre);
+
+      const_iterator begin() const;
+      const_iterator end() const;
+      std::size_t size() const;
+      bool empty() const;
+
+      /**
+      * \brief Donne la flexion de position i, dans l'ordre d'ajout
+      * \pre i < size()
+      */
+      std::pmr::string forme(std::size_t i) const;
+
+      /**
+      * \brief Écrit la flexion de position i dans resultat, sans chaîne intermédiaire
+      * \pre i < size()
+      */
+      void forme(std::size_t i, std::string& resultat) const;
+
+      /**
+      * \brief Donne la position de forme, ou end() si ce n'est pas une flexion du radical
+      */
+      const_iterator trouver(std::string_view forme) const;
+
+      /**
+      * \brief Ajoute une flexion à la fin
+      */
+      void push_back(std::string_view forme);
+
+      /**
+      * \brief Retire une flexion, sans changer l'ordre des autres
+      * \return la position de la flexion qui suivait
+      */
+      const_iterator erase(const_iterator position);
+
+      /**
+      * \brief Remplace les flexions par celles de [debut, fin), en ne rangeant qu'un paradigme
+      */
+      template <typename Iterateur>
+      void assign(Iterateur debut, Iterateur fin);
+
+      /**
+      * \brief Donne le paradigme partagé, nullptr s'il n'y a aucune flexion
+      */
+      const Paradigme* paradigme() const;
+
+      /**
+      * \brief Donne le nombre d'exceptions
+      */
+      std::size_t nombreExceptions() const;
+
+   private:
+
+      const std::pmr::string* radical;
+      ParadigmesFlexions* paradigmes;
+      const Paradigme* regles;                        // Partagé, une référence dans paradigmes; nullptr : aucune flexion.
+      std::pmr::vector<std::pmr::string> exceptions;  // Formes qui ne suivent pas de règle, dans l'ordre d'ajout.
+
+      RegleFlexion _regle(std::string_view forme);
+      bool _egale(const RegleFlexion& regle, std::string_view forme) const;
+      void _remplacer(const Paradigme* nouvelles);
+   };
+
+   template <typename Iterateur>
+   void FlexionsRadical::assign(Iterateur debut, Iterateur fin)
+   {
+      exceptions.clear();
+      Paradigme nouvelles;
+      for (; debut != fin; ++debut) nouvelles.push_back(_regle(std::string_view(*debut)));
+      _remplacer(paradigmes->interner(nouvelles));
+   }
+
+}//Fin du namespace
+
+#endif
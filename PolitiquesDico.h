@@ -0,0 +1,128 @@
+/**
+* \file PolitiquesDico.h
+* \brief Politiques de compilation du dictionnaire : ordre des radicaux et index de hachage
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+#ifndef _POLITIQUESDICO__H
+#define _POLITIQUESDICO__H
+
+// Les politiques sont choisies par macros pour tout le programme, et non passées en paramètres
+// d'un modèle BasicDicoSynonymes : le dictionnaire reste compilé une fois dans DicoSynonymes.cpp.
+// DicoSynonymes est déclaré dans un espace de noms inline dont le nom dépend des politiques
+// choisies : une unité compilée avec d'autres macros que DicoSynonymes.cpp ne trouve pas ses
+// méthodes à l'édition des liens, au lieu de partager en silence un objet de disposition différente.
+#if defined(DICO_SANS_CASSE) && defined(DICO_SANS_INDEX_HACHAGE)
+#define DICO_POLITIQUES politiquesSansCasseSansIndex
+#elif defined(DICO_SANS_CASSE)
+#define DICO_POLITIQUES politiquesSansCasse
+#elif defined(DICO_SANS_INDEX_HACHAGE)
+#define DICO_POLITIQUES politiquesSansIndex
+#else
+#define DICO_POLITIQUES politiquesParDefaut
+#endif
+
+namespace TP3
+{
+
+   /**
+   * \struct OrdreBinaire
+   *
+   * \brief Ordre des radicaux octet par octet, celui de std::string (par défaut)
+   *
+   * Une politique d'ordre fournit comparer (négatif, nul ou positif comme std::string::compare)
+   * et hacher, qui doit donner la même valeur à deux clés que comparer dit égales.
+   *
+   */
+   struct OrdreBinaire
+   {
+      static int comparer(std::string_view a, std::string_view b)
+      {
+         return a.compare(b);
+      }
+
+      static std::size_t hacher(std::string_view cle)
+      {
+         return std::hash<std::string_view>()(cle);
+      }
+   };
+
+   /**
+   * \struct OrdreSansCasse
+   *
+   * \brief Ordre qui ignore la casse des lettres ASCII (« Chat » et « chat » sont le même radical)
+   *
+   * Les octets d'un caractère UTF-8 multioctet sont comparés tels quels.
+   *
+   */
+   struct OrdreSansCasse
+   {
+      static int comparer(std::string_view a, std::string_view b)
+      {
+         std::size_t n = a.size() < b.size() ? a.size() : b.size();
+         for (std::size_t i = 0; i < n; i++)
+         {
+            unsigned char x = _minuscule(a[i]), y = _minuscule(b[i]);
+            if (x != y) return x < y ? -1 : 1;
+         }
+         return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+      }
+
+      static std::size_t hacher(std::string_view cle)
+      {
+         std::size_t h = 14695981039346656037ull; // FNV-1a sur les octets ramenés en minuscules
+         for (char c : cle)
+         {
+            h = (h ^ _minuscule(c)) * 1099511628211ull;
+         }
+         return h ^ (h >> 29);
+      }
+
+   private:
+
+      static unsigned char _minuscule(char c)
+      {
+         unsigned char u = static_cast<unsigned char>(c);
+         return u >= 'A' && u <= 'Z' ? u + ('a' - 'A') : u;
+      }
+   };
+
+   /**
+   * \class SansIndex
+   *
+   * \brief Index vide, avec l'interface de IndexRadicaux : le dictionnaire cherche alors ses radicaux dans l'arbre
+   *
+   * Toutes les méthodes sont vides et se compilent en rien; actif permet au dictionnaire
+   * d'écarter le code qui ne sert qu'avec un vrai index.
+   *
+   */
+   template <typename T>
+   class SansIndex
+   {
+   public:
+
+      static constexpr bool actif = false;
+
+      explicit SansIndex(std::pmr::memory_resource* = nullptr) { }
+
+      T* trouver(std::string_view) const { return nullptr; }
+      void inserer(std::string_view, T*) { }
+      bool effacer(std::string_view) { return false; }
+      void vider() { }
+      std::size_t taille() const { return 0; }
+   };
+
+}//Fin du namespace
+
+#endif
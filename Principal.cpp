@@ -10,6 +10,7 @@
 */
 
 #include "DicoSynonymes.h"
+#include <algorithm>
 using namespace std;
 using namespace TP3;
 
@@ -146,70 +147,81 @@ int main()
 				string chaine = "Nous poursuivrons nos etudes plus lentement";
 				cout << "Phrase a transformer: " << chaine << endl;
 				string resultat = "";
-				istringstream iss(chaine);
-				string mot;
-				while (iss >> mot)
+				// Les expressions de plusieurs mots (pomme de terre) sont reconnues avant les mots seuls
+				vector<DicoSynonymes::Segment> segments = dicoSyn.decouper(chaine);
+				size_t finPrecedent = 0;
+				for (const DicoSynonymes::Segment& segment : segments)
 				{
-					try
+					resultat += chaine.substr(finPrecedent, segment.debut - finPrecedent); // espaces et ponctuation conservés
+					finPrecedent = segment.debut + segment.longueur;
+					string mot = chaine.substr(segment.debut, segment.longueur);
+					const string& motNormalise = segment.cle; // minuscules sans accents, comme les formes du dictionnaire
+					const DicoSynonymes::Expansion* expansion = dicoSyn.expansion(motNormalise);
+					if (expansion == nullptr) // la plupart des mots d'un texte ne sont pas dans le dictionnaire
 					{
-						radical = dicoSyn.rechercherRadical(mot);
-						cout << "Radical trouve: " << radical << endl
-								<< "Pour changer le mot " << mot << ", tappez la lettre o: ";
-						char repch;
-						cin >> repch;
-						if (repch != 'o')
-						{
-							cout << "Le mot " << mot << " ne sera pas change" << endl;
-							resultat += (mot + " ");
-						}
-						else
+						resultat += mot;
+						continue;
+					}
+					radical = expansion->radical;
+					cout << "Radical trouve: " << radical << endl
+							<< "Pour changer le mot " << mot << ", tappez la lettre o: ";
+					char repch;
+					cin >> repch;
+					if (repch != 'o')
+					{
+						cout << "Le mot " << mot << " ne sera pas change" << endl;
+						resultat += mot;
+						continue;
+					}
+					int nbsens = expansion->sens.size();
+					int repin = 1;
+					if (nbsens > 1)
+					{
+						for (int j = 0; j < nbsens; j++)
 						{
-							int nbsens = dicoSyn.getNombreSens(radical);
-							int repin = 1;
-							if (nbsens > 1)
-							{
-								for (int j = 0; j < nbsens; j++)
-								{
-									cout << "Sens #" << j + 1 << " : ";
-									cout << dicoSyn.getSens(radical, j) << endl;
-								}
-								cout << "Quel sens choisissez-vous:? ";
-								cin >> repin;
-							}
-							std::vector<std::string> synonymes = dicoSyn.getSynonymes(radical, repin-1);
-							int nbSynonymes = 0;
-							for (vector<string>::const_iterator it = synonymes.begin(); it != synonymes.end(); ++it)
-							{
-								nbSynonymes++;
-								cout << "Synonyme #" << nbSynonymes << ": " << *it << endl;
-							}
-							cout << "Quel synonyme choisissez-vous:? ";
-							cin >> repin;
-							vector<string>::const_iterator it2 = synonymes.begin();
-							for (int k = 0; k != repin - 1; k++)
-								it2++;
-							std::vector<std::string> flexions = dicoSyn.getFlexions(*it2);
-							int nbFlexions = 0;
-							for (vector<string>::const_iterator it = flexions.begin(); it != flexions.end(); ++it)
-							{
-								nbFlexions++;
-								cout << "Flexion #" << nbFlexions << ": " << *it << endl;
-							}
-							cout << "Quelle flexion choisissez-vous?: ";
-							cin >> repin;
-							it2 = flexions.begin();
-							for (int l = 0; l != repin - 1; l++)
-								it2++;
-							resultat += (*it2 + " ");
+							cout << "Sens #" << j + 1 << " : ";
+							cout << expansion->sens[j] << endl;
 						}
+						cout << "Quel sens choisissez-vous:? ";
+						cin >> repin;
+					}
+					if (repin < 1 || repin > nbsens || expansion->debutSens[repin - 1] == expansion->debutSens[repin])
+					{
+						resultat += mot;
+						continue;
+					}
+					// Si la flexion est étiquetée, on ne propose que les formes qui ont les mêmes traits
+					DicoSynonymes::Traits traits = dicoSyn.getTraits(radical, motNormalise);
+					vector<const DicoSynonymes::Candidat*> formes;
+					for (unsigned int k = expansion->debutSens[repin - 1]; k < expansion->debutSens[repin]; k++)
+					{
+						if (traits == 0 || expansion->candidats[k].traits == traits) formes.push_back(&expansion->candidats[k]);
+					}
+					if (formes.empty()) // aucune forme avec les mêmes traits : on les propose toutes
+					{
+						for (unsigned int k = expansion->debutSens[repin - 1]; k < expansion->debutSens[repin]; k++)
+							formes.push_back(&expansion->candidats[k]);
+					}
+					for (unsigned int k = 0; k < formes.size(); k++)
+					{
+						cout << "Forme #" << k + 1 << ": " << formes[k]->forme << " (" << formes[k]->synonyme << ")" << endl;
+					}
+					repin = 1;
+					if (formes.size() > 1)
+					{
+						cout << "Quelle forme choisissez-vous?: ";
+						cin >> repin;
 					}
-					catch (std::logic_error& e)
+					if (repin < 1 || repin > int(formes.size()))
 					{
-						resultat += (mot + " ");
-						mot.clear();
+						resultat += mot;
 						continue;
 					}
+					string forme = formes[repin - 1]->forme;
+					replace(forme.begin(), forme.end(), '_', ' '); // une expression s'écrit avec des espaces
+					resultat += forme;
 				}
+				resultat += chaine.substr(finPrecedent);
 				cout << "Voici le texte transforme: " << endl;
 				cout << resultat << endl;
 				break;
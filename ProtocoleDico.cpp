@@ -0,0 +1,91 @@
+/**
+* \file ProtocoleDico.cpp
+* \brief Le code du protocole binaire du serveur de dictionnaire.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "ProtocoleDico.h"
+#include <cstring>
+
+namespace TP3
+{
+namespace ProtocoleDico
+{
+
+    /**
+     * \brief Ajoute un entier de 32 bits, dans l'ordre natif, à la fin du tampon
+     */
+    static void _ajouter32(std::string& tampon, std::uint32_t valeur)
+    {
+        tampon.append(reinterpret_cast<const char*>(&valeur), sizeof(valeur));
+    }
+
+    /**
+     * \brief Lit un entier de 32 bits, dans l'ordre natif, à une adresse quelconque
+     */
+    static std::uint32_t _lire32(const char* donnees)
+    {
+        std::uint32_t valeur;
+        std::memcpy(&valeur, donnees, sizeof(valeur));
+        return valeur;
+    }
+
+    void ecrire(const Trame& trame, std::string& tampon)
+    {
+        std::size_t longueur = TAILLE_ENTETE - 4;
+        for (const auto& champ : trame.champs) longueur += 4 + champ.size();
+        if (longueur > LONGUEUR_MAX) throw std::runtime_error("ProtocoleDico::ecrire: trame trop longue");
+        tampon.reserve(tampon.size() + 4 + longueur);
+        _ajouter32(tampon, std::uint32_t(longueur));
+        _ajouter32(tampon, trame.numero);
+        tampon.push_back(char(trame.code));
+        for (const auto& champ : trame.champs)
+        {
+            _ajouter32(tampon, std::uint32_t(champ.size()));
+            tampon += champ;
+        }
+    }
+
+    std::size_t lire(const char* donnees, std::size_t taille, Trame& trame)
+    {
+        if (taille < 4) return 0;
+        std::uint32_t longueur = _lire32(donnees);
+        if (longueur < TAILLE_ENTETE - 4 || longueur > LONGUEUR_MAX)
+            throw std::runtime_error("ProtocoleDico::lire: longueur de trame invalide");
+        if (taille < 4 + std::size_t(longueur)) return 0;
+        const char* fin = donnees + 4 + longueur;
+        trame.numero = _lire32(donnees + 4);
+        trame.code = std::uint8_t(donnees[8]);
+        trame.champs.clear();
+        for (const char* p = donnees + TAILLE_ENTETE; p < fin; )
+        {
+            if (fin - p < 4) throw std::runtime_error("ProtocoleDico::lire: champ tronqué");
+            std::uint32_t tailleChamp = _lire32(p);
+            p += 4;
+            if (std::size_t(fin - p) < tailleChamp) throw std::runtime_error("ProtocoleDico::lire: champ tronqué");
+            trame.champs.emplace_back(p, tailleChamp);
+            p += tailleChamp;
+        }
+        return 4 + longueur;
+    }
+
+    std::string champEntier(std::int32_t valeur)
+    {
+        return std::string(reinterpret_cast<const char*>(&valeur), sizeof(valeur));
+    }
+
+    std::int32_t entier(const std::string& champ)
+    {
+        if (champ.size() != sizeof(std::int32_t)) throw std::runtime_error("ProtocoleDico::entier: champ de taille invalide");
+        std::int32_t valeur;
+        std::memcpy(&valeur, champ.data(), sizeof(valeur));
+        return valeur;
+    }
+
+}
+}//Fin du namespace
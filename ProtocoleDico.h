@@ -0,0 +1,111 @@
+/**
+* \file ProtocoleDico.h
+* \brief Protocole binaire entre le serveur de dictionnaire (ServeurDico) et ses clients
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _PROTOCOLEDICO__H
+#define _PROTOCOLEDICO__H
+
+namespace TP3
+{
+
+   /**
+   * \brief Trames échangées sur le socket Unix du serveur.
+   *
+   * Disposition d'une trame (entiers dans l'ordre natif de la machine, le socket étant local) :
+   *   uint32 longueur (octets qui suivent ce champ) | uint32 numero | uint8 code
+   *   | champs : uint32 longueur, octets
+   *
+   * Une requête porte une Operation dans code; la réponse reprend son numéro et porte un Statut.
+   * Le client peut envoyer plusieurs requêtes sans attendre les réponses : le serveur répond
+   * à chaque connexion dans l'ordre de ses requêtes.
+   *
+   * Champs des requêtes et de leurs réponses (statut OK) :
+   *   RADICAL           mot                          -> radical
+   *   FLEXIONS          radical                      -> flexions...
+   *   SENS              radical                      -> sens... (sens i : getSens(radical, i))
+   *   SYNONYMES         radical, position (entier)   -> synonymes...
+   *   TRANSFORMER       phrase                       -> phrase où chaque mot ou expression connus prend la première forme
+   *                                                     du sens choisi d'après ses voisins (choisirSens), de mêmes
+   *                                                     traits s'il y en a
+   *   AJOUTER_RADICAL   radical                      -> (rien)
+   *   AJOUTER_FLEXION   radical, flexion             -> (rien)
+   *   AJOUTER_SYNONYME  radical, synonyme, groupe    -> groupe attribué (entier)
+   *   SUPPRIMER_RADICAL radical                      -> (rien)
+   * Statut ABSENT : le mot ou le radical n'est pas dans le dictionnaire, sans champ.
+   * Statut ERREUR : un champ, le message d'erreur.
+   */
+   namespace ProtocoleDico
+   {
+      const std::uint32_t LONGUEUR_MAX = 1 << 20;   // Longueur maximale d'une trame acceptée.
+      const std::size_t TAILLE_ENTETE = 9;           // longueur, numero, code.
+
+      enum Operation : std::uint8_t
+      {
+         RADICAL = 1,
+         FLEXIONS,
+         SENS,
+         SYNONYMES,
+         TRANSFORMER,
+         AJOUTER_RADICAL,
+         AJOUTER_FLEXION,
+         AJOUTER_SYNONYME,
+         SUPPRIMER_RADICAL
+      };
+
+      enum Statut : std::uint8_t
+      {
+         OK = 0,
+         ABSENT,
+         ERREUR
+      };
+
+      struct Trame
+      {
+         std::uint32_t numero;
+         std::uint8_t code;
+         std::vector<std::string> champs;
+      };
+
+      /**
+      * \brief Ajoute une trame à la fin d'un tampon d'envoi
+      */
+      void ecrire(const Trame& trame, std::string& tampon);
+
+      /**
+      * \brief Lit la première trame complète d'un tampon de réception
+      * \param[in] donnees le début des octets reçus et pas encore lus
+      * \param[in] taille le nombre de ces octets
+      * \param[out] trame la trame lue
+      * \return le nombre d'octets de la trame, 0 si elle n'est pas encore arrivée au complet
+      * \exception runtime_error si la trame est mal formée ou plus longue que LONGUEUR_MAX
+      */
+      std::size_t lire(const char* donnees, std::size_t taille, Trame& trame);
+
+      /**
+      * \brief Champ qui porte un entier
+      */
+      std::string champEntier(std::int32_t valeur);
+
+      /**
+      * \brief Entier porté par un champ
+      * \exception runtime_error si le champ n'a pas 4 octets
+      */
+      std::int32_t entier(const std::string& champ);
+   }
+
+}//Fin du namespace
+
+#endif
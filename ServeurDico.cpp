@@ -0,0 +1,369 @@
+/**
+* \file ServeurDico.cpp
+* \brief Serveur de dictionnaire : charge un dictionnaire et répond aux requêtes reçues sur un socket Unix
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+* Usage : ServeurDico <dictionnaire.txt> [socket (défaut /tmp/dico.sock)]
+* Compilation : g++ -std=c++17 -O2 -pthread ServeurDico.cpp ProtocoleDico.cpp puis les .cpp du
+*               dictionnaire (tous sauf Principal.cpp, ClientCharge.cpp, TransformerFichier.cpp,
+*               TestsDicoSynonymes.cpp et BancDicoSynonymes.cpp)
+*
+* Le protocole est décrit dans ProtocoleDico.h. Un seul fil sert toutes les connexions avec epoll :
+* le dictionnaire n'a donc pas besoin d'être protégé, et ses caches (radicaux, expansions) sont
+* partagés par tous les clients. À chaque réveil, le serveur lit tout ce qui est arrivé sur les
+* connexions prêtes, traite toutes les requêtes complètes, puis envoie les réponses d'une connexion
+* en un seul appel : un client qui envoie ses requêtes à la chaîne reçoit ses réponses par lots.
+*
+*/
+
+#include "DicoSynonymes.h"
+#include "ProtocoleDico.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+using namespace TP3;
+
+namespace
+{
+	const size_t SORTIE_MAX = 1 << 20;	// Au-delà, les requêtes d'une connexion attendent que ses réponses partent.
+	const size_t ENTREE_MAX = 2 * size_t(ProtocoleDico::LONGUEUR_MAX);	// Au-delà, un réveil ne lit plus rien (une trame entière y tient).
+
+	struct Connexion
+	{
+		string entree;					// Octets reçus et pas encore traités.
+		string sortie;					// Réponses pas encore envoyées.
+		size_t envoyes = 0;				// Début de ce qui reste à envoyer dans sortie.
+		bool attendEcriture = false;	// EPOLLOUT est demandé.
+		bool attendLecture = true;		// EPOLLIN est demandé.
+		bool retenue = false;			// Des requêtes reçues attendent que sortie se vide.
+	};
+
+	volatile sig_atomic_t arret = 0;
+
+	void arreter(int)
+	{
+		arret = 1;
+	}
+
+	/**
+	 * \brief Exécute une requête et ajoute sa réponse à la fin de sortie
+	 */
+	void traiter(DicoSynonymes& dico, const ProtocoleDico::Trame& requete, string& sortie)
+	{
+		ProtocoleDico::Trame reponse;
+		reponse.numero = requete.numero;
+		reponse.code = ProtocoleDico::OK;
+		const vector<string>& champs = requete.champs;
+		auto exiger = [&](size_t nbChamps) {
+			if (champs.size() != nbChamps) throw logic_error("nombre de champs invalide");
+		};
+		try
+		{
+			switch (requete.code)
+			{
+			case ProtocoleDico::RADICAL:
+			{
+				exiger(1);
+				// Même règle que rechercherRadical, mais sans parcourir l'arbre quand le mot n'est pas dans son cache
+				const DicoSynonymes::Expansion* expansion = dico.expansion(champs[0]);
+				if (expansion) reponse.champs.push_back(expansion->radical);
+				else reponse.code = ProtocoleDico::ABSENT;
+				break;
+			}
+			case ProtocoleDico::FLEXIONS:
+			{
+				exiger(1);
+				optional<vector<string> > flexions = dico.essayerFlexions(champs[0]);
+				if (flexions) reponse.champs = std::move(*flexions);
+				else reponse.code = ProtocoleDico::ABSENT;
+				break;
+			}
+			case ProtocoleDico::SENS:
+			{
+				exiger(1);
+				optional<int> nbSens = dico.essayerNombreSens(champs[0]);
+				if (!nbSens)
+				{
+					reponse.code = ProtocoleDico::ABSENT;
+					break;
+				}
+				for (int i = 0; i < *nbSens; i++)
+				{
+					reponse.champs.push_back(dico.essayerSens(champs[0], i).value_or(""));
+				}
+				break;
+			}
+			case ProtocoleDico::SYNONYMES:
+			{
+				exiger(2);
+				optional<vector<string> > synonymes = dico.essayerSynonymes(champs[0], ProtocoleDico::entier(champs[1]));
+				if (synonymes) reponse.champs = std::move(*synonymes);
+				else reponse.code = ProtocoleDico::ABSENT;
+				break;
+			}
+			case ProtocoleDico::TRANSFORMER:
+				exiger(1);
+				reponse.champs.push_back(dico.transformer(champs[0]));
+				break;
+			case ProtocoleDico::AJOUTER_RADICAL:
+				exiger(1);
+				dico.ajouterRadical(champs[0]);
+				break;
+			case ProtocoleDico::AJOUTER_FLEXION:
+				exiger(2);
+				dico.ajouterFlexion(champs[0], champs[1]);
+				break;
+			case ProtocoleDico::AJOUTER_SYNONYME:
+			{
+				exiger(3);
+				int numGroupe = ProtocoleDico::entier(champs[2]);
+				dico.ajouterSynonyme(champs[0], champs[1], numGroupe);
+				reponse.champs.push_back(ProtocoleDico::champEntier(numGroupe));
+				break;
+			}
+			case ProtocoleDico::SUPPRIMER_RADICAL:
+				exiger(1);
+				dico.supprimerRadical(champs[0]);
+				break;
+			default:
+				throw logic_error("opération inconnue");
+			}
+		}
+		catch (const exception& e)
+		{
+			reponse.code = ProtocoleDico::ERREUR;
+			reponse.champs.assign(1, e.what());
+		}
+		ProtocoleDico::ecrire(reponse, sortie);
+	}
+
+	/**
+	 * \brief Traite les requêtes complètes reçues sur une connexion, tant que ses réponses en attente restent sous SORTIE_MAX
+	 * \return le nombre de requêtes traitées
+	 * \exception runtime_error si le client a envoyé une trame mal formée
+	 */
+	size_t traiterEntree(DicoSynonymes& dico, Connexion& connexion)
+	{
+		ProtocoleDico::Trame requete;
+		size_t lus = 0, nbRequetes = 0;
+		connexion.retenue = false;
+		for (;;)
+		{
+			size_t taille = ProtocoleDico::lire(connexion.entree.data() + lus, connexion.entree.size() - lus, requete);
+			if (taille == 0) break;
+			if (connexion.sortie.size() - connexion.envoyes >= SORTIE_MAX)
+			{
+				connexion.retenue = true;
+				break;
+			}
+			lus += taille;
+			traiter(dico, requete, connexion.sortie);
+			nbRequetes++;
+		}
+		connexion.entree.erase(0, lus);
+		return nbRequetes;
+	}
+
+	/**
+	 * \brief Envoie ce que le socket accepte des réponses en attente, et demande EPOLLOUT s'il en reste
+	 *
+	 * Tant que la connexion est retenue, EPOLLIN n'est plus demandé : un client qui envoie sans
+	 * lire ses réponses reste bloqué par son socket au lieu de remplir la mémoire du serveur.
+	 * \return false si la connexion est rompue
+	 */
+	bool envoyer(int epoll, int socketClient, Connexion& connexion)
+	{
+		while (connexion.envoyes < connexion.sortie.size())
+		{
+			ssize_t n = send(socketClient, connexion.sortie.data() + connexion.envoyes,
+							 connexion.sortie.size() - connexion.envoyes, MSG_NOSIGNAL);
+			if (n < 0 && errno == EINTR) continue;
+			if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			if (n < 0) return false;
+			connexion.envoyes += n;
+		}
+		bool reste = connexion.envoyes < connexion.sortie.size();
+		if (!reste)
+		{
+			connexion.sortie.clear();
+			connexion.envoyes = 0;
+		}
+		bool lire = !connexion.retenue;
+		if (reste != connexion.attendEcriture || lire != connexion.attendLecture)
+		{
+			epoll_event evenement{};
+			evenement.events = (lire ? uint32_t(EPOLLIN) : 0u) | (reste ? uint32_t(EPOLLOUT) : 0u);
+			evenement.data.fd = socketClient;
+			epoll_ctl(epoll, EPOLL_CTL_MOD, socketClient, &evenement);
+			connexion.attendEcriture = reste;
+			connexion.attendLecture = lire;
+		}
+		return true;
+	}
+
+	/**
+	 * \brief Lit ce qui est disponible sur une connexion, jusqu'à ENTREE_MAX octets en attente (le reste au prochain réveil)
+	 * \return false si le client a fermé la connexion ou qu'elle est rompue
+	 */
+	bool recevoir(int socketClient, Connexion& connexion)
+	{
+		char tampon[1 << 16];
+		while (connexion.entree.size() < ENTREE_MAX)
+		{
+			ssize_t n = recv(socketClient, tampon, sizeof(tampon), 0);
+			if (n > 0)
+			{
+				connexion.entree.append(tampon, n);
+				continue;
+			}
+			if (n < 0 && errno == EINTR) continue;
+			return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		cerr << "Usage : " << argv[0] << " <dictionnaire.txt> [socket]" << endl;
+		return 1;
+	}
+	string chemin = argc > 2 ? argv[2] : "/tmp/dico.sock";
+	DicoSynonymes dico;
+	try
+	{
+		dico.chargerEnParallele(argv[1]);
+	}
+	catch (const exception& e)
+	{
+		cerr << "ERREUR: " << e.what() << endl;
+		return 1;
+	}
+
+	sockaddr_un adresse{};
+	adresse.sun_family = AF_UNIX;
+	if (chemin.size() >= sizeof(adresse.sun_path))
+	{
+		cerr << "ERREUR: chemin de socket trop long" << endl;
+		return 1;
+	}
+	strcpy(adresse.sun_path, chemin.c_str());
+	int ecoute = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	unlink(chemin.c_str());
+	if (ecoute < 0 || bind(ecoute, reinterpret_cast<sockaddr*>(&adresse), sizeof(adresse)) < 0 || listen(ecoute, SOMAXCONN) < 0)
+	{
+		cerr << "ERREUR: " << chemin << ": " << strerror(errno) << endl;
+		return 1;
+	}
+	int epoll = epoll_create1(EPOLL_CLOEXEC);
+	epoll_event evenement{};
+	evenement.events = EPOLLIN;
+	evenement.data.fd = ecoute;
+	epoll_ctl(epoll, EPOLL_CTL_ADD, ecoute, &evenement);
+
+	struct sigaction action{};
+	action.sa_handler = arreter;
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+	cout << "Dictionnaire de " << dico.nombreRadicaux() << " radicaux servi sur " << chemin << endl;
+
+	unordered_map<int, Connexion> connexions;
+	vector<int> prets;					// Connexions qui ont des requêtes à traiter dans ce lot.
+	epoll_event evenements[256];
+	size_t nbRequetes = 0, nbLots = 0;
+	while (!arret)
+	{
+		int n = epoll_wait(epoll, evenements, 256, -1);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			cerr << "ERREUR: epoll_wait: " << strerror(errno) << endl;
+			break;
+		}
+		prets.clear();
+		for (int i = 0; i < n; i++)
+		{
+			int fd = evenements[i].data.fd;
+			if (fd == ecoute)
+			{
+				int client;
+				while ((client = accept4(ecoute, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+				{
+					epoll_event nouveau{};
+					nouveau.events = EPOLLIN;
+					nouveau.data.fd = client;
+					epoll_ctl(epoll, EPOLL_CTL_ADD, client, &nouveau);
+					connexions.emplace(client, Connexion());
+				}
+				continue;
+			}
+			Connexion& connexion = connexions[fd];
+			bool ouverte = true;
+			if (evenements[i].events & EPOLLOUT) ouverte = envoyer(epoll, fd, connexion);
+			if (ouverte && (evenements[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) ouverte = recevoir(fd, connexion);
+			if (!ouverte)
+			{
+				close(fd); // retire aussi fd de epoll
+				connexions.erase(fd);
+				continue;
+			}
+			prets.push_back(fd);
+		}
+
+		// Toutes les requêtes du lot sont traitées avant le premier envoi
+		for (int fd : prets)
+		{
+			try
+			{
+				nbRequetes += traiterEntree(dico, connexions[fd]);
+			}
+			catch (const exception& e)
+			{
+				cerr << "ERREUR: connexion " << fd << ": " << e.what() << endl;
+				close(fd);
+				connexions.erase(fd);
+			}
+		}
+		for (int fd : prets)
+		{
+			auto connexion = connexions.find(fd);
+			if (connexion == connexions.end()) continue;
+			try
+			{
+				bool ouverte = envoyer(epoll, fd, connexion->second);
+				// Tout est parti mais des requêtes ont été retenues : aucun événement ne viendra les réveiller
+				while (ouverte && connexion->second.retenue && !connexion->second.attendEcriture)
+				{
+					nbRequetes += traiterEntree(dico, connexion->second);
+					ouverte = envoyer(epoll, fd, connexion->second);
+				}
+				if (ouverte) continue;
+			}
+			catch (const exception& e)
+			{
+				cerr << "ERREUR: connexion " << fd << ": " << e.what() << endl;
+			}
+			close(fd);
+			connexions.erase(connexion);
+		}
+		nbLots++;
+	}
+
+	for (auto& connexion : connexions) close(connexion.first);
+	close(epoll);
+	close(ecoute);
+	unlink(chemin.c_str());
+	cout << nbRequetes << " requetes traitees en " << nbLots << " lots" << endl;
+	return 0;
+}
@@ -0,0 +1,498 @@
+/**
+* \file TestsDicoSynonymes.cpp
+* \brief Tests de non-régression du dictionnaire des synonymes
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+* Usage : TestsDicoSynonymes [PetitDico.txt]
+* Compilation : g++ -std=c++17 -g -fsanitize=address -pthread TestsDicoSynonymes.cpp puis les .cpp du
+*               dictionnaire (tous sauf Principal.cpp, ServeurDico.cpp, ClientCharge.cpp,
+*               TransformerFichier.cpp et BancDicoSynonymes.cpp)
+*
+* Chaque test affiche ce qui ne va pas; le programme retourne 1 si un test a échoué. Les fichiers
+* temporaires (index, journal) sont écrits dans le dossier temporaire du système.
+*
+*/
+
+#include "DicoSynonymes.h"
+#include <filesystem>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <unistd.h>
+using namespace std;
+using namespace TP3;
+
+namespace
+{
+	string cheminDico = "PetitDico.txt";
+	int nbEchecs = 0;
+
+	void verifier(bool condition, const string& test, const string& message)
+	{
+		if (condition) return;
+		nbEchecs++;
+		cerr << "ECHEC " << test << " : " << message << endl;
+	}
+
+	/**
+	 * \brief Donne un chemin propre au processus dans le dossier temporaire, après en avoir retiré le fichier
+	 */
+	string cheminTemporaire(const string& nom)
+	{
+		filesystem::path chemin = filesystem::temp_directory_path() / ("tests_dico_" + to_string(getpid()) + "_" + nom);
+		filesystem::remove(chemin);
+		return chemin.string();
+	}
+
+	void chargerPetitDico(DicoSynonymes& dico)
+	{
+		ifstream fichier(cheminDico);
+		if (!fichier.is_open()) throw runtime_error("impossible d'ouvrir " + cheminDico);
+		dico.chargerDicoSynonyme(fichier);
+	}
+
+	/**
+	 * \brief Écrit, radical par radical dans l'ordre, les flexions et les synonymes de chaque sens
+	 */
+	string contenu(const DicoSynonymes& dico)
+	{
+		ostringstream sortie;
+		for (int i = 0; i < dico.nombreRadicaux(); i++)
+		{
+			string radical = dico.kieme(i);
+			sortie << radical << " :";
+			for (const string& flexion : dico.getFlexions(radical)) sortie << ' ' << flexion;
+			for (int sens = 0; sens < dico.getNombreSens(radical); sens++)
+			{
+				sortie << " |";
+				for (const string& synonyme : dico.getSynonymes(radical, sens)) sortie << ' ' << synonyme;
+			}
+			sortie << '\n';
+		}
+		return sortie.str();
+	}
+
+	void testerIndex()
+	{
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		string avant = contenu(dico);
+		string chemin = cheminTemporaire("index");
+		dico.sauvegarderIndex(chemin);
+		dico.chargerIndex(chemin); // les paradigmes des nouveaux noeuds doivent survivre au retrait des anciens
+		verifier(contenu(dico) == avant, "index", "chargerIndex ne redonne pas le dictionnaire sauvegardé");
+		dico.ajouterFlexion("grand", "grandissime");
+		verifier(dico.getFlexions("grand").back() == "grandissime", "index", "ajouterFlexion après chargerIndex");
+
+		DicoSynonymes autre;
+		autre.chargerIndex(chemin);
+		verifier(contenu(autre) == avant, "index", "chargerIndex dans un dictionnaire vide");
+		filesystem::remove(chemin);
+	}
+
+	void testerRecuperation()
+	{
+		string journal = cheminTemporaire("journal");
+		string instantane = cheminTemporaire("instantane");
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		dico.activerJournal(journal, instantane, 1);
+		dico.ajouterRadical("minuscule");
+		dico.ajouterFlexion("minuscule", "minuscules");
+		dico.compacterJournal();
+		dico.ajouterFlexion("grand", "grandissime");
+		dico.supprimerFlexion("gros", "grosses");
+		dico.ajouterRadical("infime");
+		dico.ajouterFlexion("infime", "infimes");
+		dico.desactiverJournal();
+
+		DicoSynonymes recupere;
+		recupere.recuperer(instantane, journal); // rejoue le journal sur l'instantané chargé par chargerIndex
+		verifier(contenu(recupere) == contenu(dico), "recuperation", "recuperer ne redonne pas le dictionnaire journalisé");
+		filesystem::remove(journal);
+		filesystem::remove(instantane);
+	}
+
+	void testerSynonymePartage()
+	{
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		vector<string> groupe = dico.getSynonymes("grand", 0);
+		int numGroupe = 0;
+		dico.ajouterSynonyme("lent", "gros", numGroupe); // gros est déjà dans ce groupe, mis par grand
+		verifier(dico.getSynonymes("grand", 0) == groupe, "synonyme partage", "le groupe garde une seule fois chaque mot");
+		verifier(dico.getNombreSens("lent") == 2 && dico.getSynonymes("lent", 1) == groupe, "synonyme partage",
+		         "le radical prend le sens du groupe");
+		bool lance = false;
+		try
+		{
+			dico.ajouterSynonyme("lent", "gros", numGroupe);
+		}
+		catch (const logic_error&)
+		{
+			lance = true;
+		}
+		verifier(lance, "synonyme partage", "un synonyme déjà dans les sens du radical est refusé");
+	}
+
+	void testerFusion()
+	{
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		int n = dico.nombreRadicaux();
+		DicoSynonymes autre;
+		autre.ajouterRadical("grand");
+		autre.ajouterFlexion("grand", "grandissime");
+		autre.ajouterRadical("minuscule");
+		autre.ajouterFlexion("minuscule", "minuscules");
+		int numGroupe = -1;
+		autre.ajouterSynonyme("minuscule", "infime", numGroupe); // infime devient aussi un radical
+		string contenuAutre = contenu(autre);
+
+		dico.fusionner(autre);
+		vector<string> flexions = dico.getFlexions("grand");
+		verifier(dico.nombreRadicaux() == n + 2, "fusion", "fusionner ajoute les radicaux absents seulement");
+		verifier(find(flexions.begin(), flexions.end(), "grandissime") != flexions.end(), "fusion",
+		         "un radical présent reçoit les flexions qui lui manquent");
+		verifier(dico.getSynonymes("minuscule", 0) == vector<string>{"infime"}, "fusion", "les sens de autre suivent");
+		verifier(contenu(autre) == contenuAutre, "fusion", "autre reste inchangé");
+
+		dico.retirer(autre); // grand aussi, même s'il venait du fichier : rang("grand") vaut alors rang("grandir")
+		vector<string> ordre = dico.page(0, dico.nombreRadicaux());
+		verifier(dico.nombreRadicaux() == n - 1 && dico.rang("grand") == dico.rang("grandir") && is_sorted(ordre.begin(), ordre.end()),
+		         "fusion", "retirer enlève les radicaux de autre et garde l'ordre");
+		verifier(contenu(autre) == contenuAutre, "fusion", "autre reste inchangé par retirer");
+	}
+
+	void testerAvecLuiMeme()
+	{
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		string avant = contenu(dico);
+		dico.fusionner(dico);
+		verifier(contenu(dico) == avant, "avec lui-meme", "fusionner ne double pas les sens");
+		dico.retirer(dico);
+		verifier(dico.nombreRadicaux() == 0 && contenu(dico).empty(), "avec lui-meme", "retirer vide le dictionnaire");
+		dico.ajouterRadical("grand");
+		int numGroupe = -1;
+		dico.ajouterSynonyme("grand", "gros", numGroupe);
+		verifier(numGroupe == 0, "avec lui-meme", "retirer ne garde pas les groupes");
+	}
+
+	void testerChargementParallele()
+	{
+		DicoSynonymes complet;
+		chargerPetitDico(complet);
+		string attendu = contenu(complet);
+		for (unsigned int nbFils : {1u, 2u, 3u, 8u})
+		{
+			DicoSynonymes dico;
+			dico.chargerEnParallele(cheminDico, nbFils);
+			verifier(contenu(dico) == attendu, "chargement parallele", to_string(nbFils) + " fil(s) : pas le résultat de chargerDicoSynonyme");
+		}
+
+		// Un radical en double : rien n'est ajouté
+		string doublon = cheminTemporaire("double.txt");
+		ofstream(doublon) << "minuscule\nminuscules\ninfime\ninfimes\nminuscule\nminuscules\n$\n";
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		bool lance = false;
+		try
+		{
+			dico.chargerEnParallele(doublon, 2);
+		}
+		catch (const logic_error&)
+		{
+			lance = true;
+		}
+		verifier(lance && contenu(dico) == attendu, "chargement parallele", "un radical en double laisse le dictionnaire inchangé");
+		filesystem::remove(doublon);
+
+		// Dans un dictionnaire non vide, les radicaux présents reçoivent les flexions qui leur manquent
+		DicoSynonymes partiel;
+		partiel.ajouterRadical("grand");
+		partiel.ajouterFlexion("grand", "grandissime");
+		partiel.chargerEnParallele(cheminDico, 2);
+		vector<string> flexions = partiel.getFlexions("grand");
+		verifier(partiel.nombreRadicaux() == complet.nombreRadicaux() && flexions.size() == complet.getFlexions("grand").size() + 1
+		         && find(flexions.begin(), flexions.end(), "grandissime") != flexions.end(),
+		         "chargement parallele", "chargement dans un dictionnaire non vide");
+	}
+
+	void testerPositions()
+	{
+		DicoSynonymes dico;
+		set<string> attendus;
+		mt19937 generateur(7);
+		for (int operation = 0; operation < 4000; operation++)
+		{
+			string mot = "m" + to_string(generateur() % 1500);
+			if (attendus.count(mot) != 0 && generateur() % 3 == 0) // des retraits, pour les rotations de supprimerRadical
+			{
+				dico.supprimerRadical(mot);
+				attendus.erase(mot);
+			}
+			else if (attendus.insert(mot).second) dico.ajouterRadical(mot);
+			if (operation % 200 != 199) continue;
+
+			vector<string> ordre(attendus.begin(), attendus.end());
+			int n = int(ordre.size());
+			verifier(dico.nombreRadicaux() == n, "positions", "nombreRadicaux");
+			for (int k = 0; k < n; k += 7)
+			{
+				verifier(dico.kieme(k) == ordre[k], "positions", "kieme(" + to_string(k) + ")");
+				verifier(dico.rang(ordre[k]) == k, "positions", "rang(" + ordre[k] + ")");
+				verifier(dico.rang(ordre[k] + "!") == k + 1, "positions", "rang d'un mot absent");
+			}
+			int debut = int(generateur() % (n + 10));
+			vector<string> page(ordre.begin() + min(debut, n), ordre.begin() + min(debut + 25, n));
+			verifier(dico.page(debut, 25) == page, "positions", "page(" + to_string(debut) + ", 25)");
+		}
+		bool lance = false;
+		try
+		{
+			dico.kieme(dico.nombreRadicaux());
+		}
+		catch (const logic_error&)
+		{
+			lance = true;
+		}
+		verifier(lance, "positions", "kieme hors des positions lance logic_error");
+	}
+
+	void testerTransducteur()
+	{
+		map<string, uint32_t> mots;
+		mt19937 generateur(3);
+		while (mots.size() < 3000) // petit alphabet : beaucoup de préfixes et de suffixes partagés
+		{
+			string mot;
+			for (size_t i = 0, n = 1 + generateur() % 8; i < n; i++) mot += char('a' + generateur() % 5);
+			mots.emplace(mot, generateur() % 1000);
+		}
+		TransducteurFlexions transducteur;
+		transducteur.construire(vector<pair<string, uint32_t> >(mots.begin(), mots.end()));
+		verifier(transducteur.taille() == mots.size(), "transducteur", "taille");
+		for (const auto& paire : mots)
+		{
+			verifier(transducteur.trouver(paire.first) == paire.second, "transducteur", "trouver(" + paire.first + ")");
+			verifier(transducteur.trouver(paire.first + "z") == TransducteurFlexions::AUCUN, "transducteur", "mot absent");
+			string prefixe = paire.first.substr(0, paire.first.size() - 1);
+			if (mots.count(prefixe) == 0)
+				verifier(transducteur.trouver(prefixe) == TransducteurFlexions::AUCUN, "transducteur", "préfixe absent");
+		}
+		bool lance = false;
+		try
+		{
+			transducteur.construire({{"b", 0}, {"a", 1}});
+		}
+		catch (const logic_error&)
+		{
+			lance = true;
+		}
+		verifier(lance, "transducteur", "des mots dans le désordre lancent logic_error");
+
+		DicoSynonymes dico;
+		chargerPetitDico(dico);
+		for (int i = 0; i < dico.nombreRadicaux(); i++)
+		{
+			for (const string& flexion : dico.getFlexions(dico.kieme(i)))
+			{
+				int numero = dico.numeroRadical(flexion);
+				verifier(numero >= 0 && dico.kieme(numero) == dico.rechercherRadical(flexion), "transducteur",
+				         "numeroRadical(" + flexion + ") n'est pas le radical de rechercherRadical");
+			}
+		}
+		verifier(dico.numeroRadical("grandissime") == -1, "transducteur", "numeroRadical d'un mot absent");
+		dico.ajouterFlexion("grand", "grandissime");
+		verifier(dico.numeroRadical("grandissime") == dico.rang("grand"), "transducteur", "reconstruit après ajouterFlexion");
+		dico.supprimerFlexion("grand", "grandissime");
+		verifier(dico.numeroRadical("grandissime") == -1, "transducteur", "reconstruit après supprimerFlexion");
+	}
+
+	/**
+	 * \brief Ressource qui lance bad_alloc une fois ses allocations permises épuisées
+	 */
+	class RessourceLimitee : public pmr::memory_resource
+	{
+	public:
+		long permises = -1; // -1 : sans limite
+
+	private:
+		void* do_allocate(size_t octets, size_t alignement) override
+		{
+			if (permises == 0) throw bad_alloc();
+			if (permises > 0) permises--;
+			return pmr::new_delete_resource()->allocate(octets, alignement);
+		}
+
+		void do_deallocate(void* p, size_t octets, size_t alignement) override
+		{
+			pmr::new_delete_resource()->deallocate(p, octets, alignement);
+		}
+
+		bool do_is_equal(const pmr::memory_resource& autre) const noexcept override
+		{
+			return this == &autre;
+		}
+	};
+
+	void testerSynonymesALaDemande()
+	{
+		DicoSynonymes complet;
+		chargerPetitDico(complet);
+		string attendu = contenu(complet);
+		string copie = cheminTemporaire("dico.txt");
+		filesystem::copy_file(cheminDico, copie);
+
+		{
+			DicoSynonymes dico;
+			ifstream fichier(cheminDico);
+			dico.chargerDicoSynonyme(fichier, true);
+			verifier(contenu(dico) == attendu, "a la demande", "chargerDicoSynonyme");
+		}
+
+		// Un fichier modifié : rien n'est construit, puis l'appel qui suit sa remise en état réussit
+		{
+			DicoSynonymes dico;
+			dico.chargerEnParallele(copie, 1, true);
+			ofstream(copie, ios::app) << "\n";
+			for (int essai = 0; essai < 2; essai++)
+			{
+				bool lance = false;
+				try
+				{
+					dico.getNombreSens("grand");
+				}
+				catch (const runtime_error&)
+				{
+					lance = true;
+				}
+				verifier(lance, "a la demande", "un fichier modifié lance runtime_error à chaque essai");
+			}
+			filesystem::copy_file(cheminDico, copie, filesystem::copy_options::overwrite_existing);
+			verifier(contenu(dico) == attendu, "a la demande", "nouvel essai après la remise en état du fichier");
+		}
+
+		// Un nouveau chargement remplace une section qui ne peut plus être relue
+		{
+			DicoSynonymes dico;
+			dico.chargerEnParallele(copie, 1, true);
+			ofstream(copie, ios::app) << "\n";
+			string autre = cheminTemporaire("autre.txt");
+			ofstream(autre) << "minuscule\nminuscules\n$\nminuscule petit\n";
+			dico.chargerEnParallele(autre);
+			verifier(dico.getNombreSens("grand") == 0, "a la demande", "la section abandonnée n'a pas de groupes");
+			verifier(dico.getSynonymes("minuscule", 0) == vector<string>{"petit"}, "a la demande", "le nouveau chargement");
+			filesystem::remove(autre);
+			filesystem::copy_file(cheminDico, copie, filesystem::copy_options::overwrite_existing);
+		}
+
+		// Une construction interrompue ne laisse aucun groupe : le nouvel essai donne les mêmes sens
+		for (bool enMemoire : {false, true})
+		{
+			RessourceLimitee ressource;
+			DicoSynonymes dico(&ressource);
+			if (enMemoire)
+			{
+				ifstream fichier(cheminDico);
+				dico.chargerDicoSynonyme(fichier, true);
+			}
+			else dico.chargerEnParallele(copie, 1, true);
+			int nbEchecsConstruction = 0;
+			for (long permises = 0; ; permises += 5)
+			{
+				ressource.permises = permises;
+				try
+				{
+					dico.getNombreSens("grand");
+					break;
+				}
+				catch (const bad_alloc&)
+				{
+					nbEchecsConstruction++;
+				}
+			}
+			ressource.permises = -1;
+			verifier(nbEchecsConstruction > 1, "a la demande", "la construction est interrompue en cours de route");
+			verifier(contenu(dico) == attendu, "a la demande", "groupes après des constructions interrompues");
+		}
+
+		// Plusieurs fils qui lisent les sens ensemble : une seule construction, attendue par tous
+		{
+			DicoSynonymes dico;
+			dico.chargerEnParallele(copie, 1, true);
+			vector<string> lus(4);
+			vector<thread> fils;
+			for (string& lu : lus)
+			{
+				fils.emplace_back([&dico, &lu]() { lu = contenu(dico); });
+			}
+			for (thread& f : fils) f.join();
+			for (const string& lu : lus) verifier(lu == attendu, "a la demande", "lecture par plusieurs fils");
+		}
+		filesystem::remove(copie);
+	}
+
+	void testerParadigmes()
+	{
+		ParadigmesFlexions registre;
+		pmr::string radical("mot");
+		{
+			FlexionsRadical flexions(radical, registre, pmr::get_default_resource());
+			flexions.push_back("mots");
+			for (int i = 0; i < 20000; i++) // chaque modification range un nouveau paradigme
+			{
+				string forme = "mot" + to_string(i);
+				flexions.push_back(forme);
+				flexions.erase(flexions.trouver(forme));
+			}
+			verifier(flexions.size() == 1 && flexions.forme(0) == "mots", "paradigmes", "flexions modifiées");
+			verifier(registre.nombre() == 1, "paradigmes", "un seul paradigme est utilisé");
+			verifier(registre.octets() < 64 * 1024, "paradigmes", "les paradigmes inutilisés ne sont pas libérés ("
+			                                                      + to_string(registre.octets()) + " octets)");
+		}
+		verifier(registre.nombre() == 0, "paradigmes", "le dernier radical a rendu son paradigme");
+
+		pmr::string oeil("oeil");
+		FlexionsRadical formes(oeil, registre, pmr::get_default_resource());
+		formes.push_back("oeils");
+		formes.push_back("yeux"); // irrégulière : gardée entière dans les exceptions
+		string forme = "une chaine plus longue que la forme";
+		formes.forme(1, forme);
+		verifier(forme == "yeux" && formes.forme(0) == "oeils", "paradigmes", "forme d'une flexion irrégulière");
+		formes.forme(0, forme);
+		verifier(forme == "oeils", "paradigmes", "forme écrite dans une chaîne existante");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1) cheminDico = argv[1];
+	try
+	{
+		testerIndex();
+		testerRecuperation();
+		testerParadigmes();
+		testerSynonymesALaDemande();
+		testerSynonymePartage();
+		testerFusion();
+		testerAvecLuiMeme();
+		testerChargementParallele();
+		testerPositions();
+		testerTransducteur();
+	}
+	catch (const exception& e)
+	{
+		cerr << "ERREUR: " << e.what() << endl;
+		return 1;
+	}
+	if (nbEchecs != 0) return 1;
+	cout << "Tous les tests ont réussi." << endl;
+	return 0;
+}
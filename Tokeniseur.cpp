@@ -0,0 +1,264 @@
+/**
+* \file Tokeniseur.cpp
+* \brief Le code du découpage en mots et de la normalisation des mots.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "Tokeniseur.h"
+#include <cstdint>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TP3
+{
+    namespace
+    {
+        /**
+         * \brief Indique si un octet fait partie d'un mot : lettre ou chiffre ASCII, ou octet non ASCII
+         */
+        inline bool estOctetMot(unsigned char c)
+        {
+            return c >= 0x80 || (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+        }
+
+#if defined(__AVX2__)
+        const std::size_t BLOC = 32;
+        const std::uint32_t BLOC_PLEIN = 0xffffffffu;
+
+        inline __m256i dansIntervalle(__m256i x, char bas, char haut)
+        {
+            __m256i d = _mm256_sub_epi8(x, _mm256_set1_epi8(bas));
+            return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(char(haut - bas))), d);
+        }
+
+        /**
+         * \brief Masque des octets de mot d'un bloc de 32 octets (bit i pour l'octet i)
+         */
+        inline std::uint32_t masqueMots(const char* bloc)
+        {
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloc));
+            __m256i lettre = dansIntervalle(_mm256_or_si256(b, _mm256_set1_epi8(0x20)), 'a', 'z');
+            __m256i chiffre = dansIntervalle(b, '0', '9');
+            return std::uint32_t(_mm256_movemask_epi8(_mm256_or_si256(lettre, chiffre)))
+                 | std::uint32_t(_mm256_movemask_epi8(b)); // bit de poids fort : octet non ASCII
+        }
+
+        /**
+         * \brief Met en minuscules un bloc de 32 octets s'il est entièrement ASCII
+         * \return false si le bloc contient un octet non ASCII (il n'est alors pas modifié)
+         */
+        inline bool minusculesBloc(char* bloc)
+        {
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloc));
+            if (_mm256_movemask_epi8(b) != 0) return false;
+            __m256i majuscule = dansIntervalle(b, 'A', 'Z');
+            b = _mm256_add_epi8(b, _mm256_and_si256(majuscule, _mm256_set1_epi8(0x20)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(bloc), b);
+            return true;
+        }
+#elif defined(__SSE2__)
+        const std::size_t BLOC = 16;
+        const std::uint32_t BLOC_PLEIN = 0xffffu;
+
+        inline __m128i dansIntervalle(__m128i x, char bas, char haut)
+        {
+            __m128i d = _mm_sub_epi8(x, _mm_set1_epi8(bas));
+            return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(char(haut - bas))), d);
+        }
+
+        /**
+         * \brief Masque des octets de mot d'un bloc de 16 octets (bit i pour l'octet i)
+         */
+        inline std::uint32_t masqueMots(const char* bloc)
+        {
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bloc));
+            __m128i lettre = dansIntervalle(_mm_or_si128(b, _mm_set1_epi8(0x20)), 'a', 'z');
+            __m128i chiffre = dansIntervalle(b, '0', '9');
+            return std::uint32_t(_mm_movemask_epi8(_mm_or_si128(lettre, chiffre)))
+                 | std::uint32_t(_mm_movemask_epi8(b)); // bit de poids fort : octet non ASCII
+        }
+
+        /**
+         * \brief Met en minuscules un bloc de 16 octets s'il est entièrement ASCII
+         * \return false si le bloc contient un octet non ASCII (il n'est alors pas modifié)
+         */
+        inline bool minusculesBloc(char* bloc)
+        {
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bloc));
+            if (_mm_movemask_epi8(b) != 0) return false;
+            __m128i majuscule = dansIntervalle(b, 'A', 'Z');
+            b = _mm_add_epi8(b, _mm_and_si128(majuscule, _mm_set1_epi8(0x20)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bloc), b);
+            return true;
+        }
+#endif
+
+        /**
+         * \brief Longueur de la ponctuation UTF-8 qui commence à p, 0 s'il n'y en a pas
+         */
+        std::size_t ponctuationUtf8(const unsigned char* p, std::size_t reste)
+        {
+            if (reste >= 2 && p[0] == 0xC2 && (p[1] == 0xA0 || p[1] == 0xAB || p[1] == 0xBB)) return 2; // insécable « »
+            if (reste >= 3 && p[0] == 0xE2 && p[1] == 0x80)
+            {
+                switch (p[2])
+                {
+                case 0x93: case 0x94:               // – —
+                case 0x98: case 0x99:               // ‘ ’
+                case 0x9C: case 0x9D:               // “ ”
+                case 0xA6: case 0xAF:               // … et espace fine insécable
+                    return 3;
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * \brief Ajoute le mot [debut, fin), en le coupant aux ponctuations UTF-8 qu'il contient
+         */
+        void ajouterMot(const char* texte, std::size_t debut, std::size_t fin, std::vector<Jeton>& jetons)
+        {
+            const unsigned char* octets = reinterpret_cast<const unsigned char*>(texte);
+            std::size_t courant = debut;
+            for (std::size_t i = debut; i < fin; )
+            {
+                std::size_t n = octets[i] >= 0x80 ? ponctuationUtf8(octets + i, fin - i) : 0;
+                if (n == 0)
+                {
+                    i++;
+                    continue;
+                }
+                if (i > courant) jetons.push_back(Jeton{courant, i - courant});
+                i += n;
+                courant = i;
+            }
+            if (fin > courant) jetons.push_back(Jeton{courant, fin - courant});
+        }
+
+        /**
+         * \brief Lettre de base des caractères U+00C0 à U+00FF (deuxième octet 0x80 à 0xBF après 0xC3),
+         *        nullptr pour ceux qu'on ne change pas (× ÷ Þ þ Ð ð)
+         */
+        const char* const PLIAGE_C3[64] = {
+            "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",          // À Á Â Ã Ä Å Æ Ç È É Ê Ë Ì Í Î Ï
+            nullptr, "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", nullptr, "ss", // Ð Ñ Ò Ó Ô Õ Ö × Ø Ù Ú Û Ü Ý Þ ß
+            "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",          // à á â ã ä å æ ç è é ê ë ì í î ï
+            nullptr, "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", nullptr, "y"   // ð ñ ò ó ô õ ö ÷ ø ù ú û ü ý þ ÿ
+        };
+    }
+
+      /**
+      * \brief Découpe un texte UTF-8 en mots
+      *
+      * \param[in] texte le début du texte
+      * \param[in] longueur le nombre d'octets du texte
+      * \param[out] jetons les mots trouvés sont ajoutés à la fin, dans l'ordre du texte
+      */
+    void tokeniser(const char* texte, std::size_t longueur, std::vector<Jeton>& jetons)
+    {
+        std::size_t debutMot = 0;
+        bool dansMot = false;
+        std::size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        for (; i + BLOC <= longueur; i += BLOC)
+        {
+            std::uint32_t masque = masqueMots(texte + i);
+            if (masque == (dansMot ? BLOC_PLEIN : 0)) continue; // le bloc ne change rien
+            // bit k : l'octet k n'est pas du même type que celui qui le précède
+            std::uint32_t transitions = (masque ^ ((masque << 1) | (dansMot ? 1u : 0u))) & BLOC_PLEIN;
+            while (transitions != 0)
+            {
+                std::size_t position = i + __builtin_ctz(transitions);
+                if (dansMot) ajouterMot(texte, debutMot, position, jetons);
+                else debutMot = position;
+                dansMot = !dansMot;
+                transitions &= transitions - 1;
+            }
+        }
+#endif
+        for (; i < longueur; i++)
+        {
+            bool octetMot = estOctetMot(texte[i]);
+            if (octetMot == dansMot) continue;
+            if (dansMot) ajouterMot(texte, debutMot, i, jetons);
+            else debutMot = i;
+            dansMot = octetMot;
+        }
+        if (dansMot) ajouterMot(texte, debutMot, longueur, jetons);
+    }
+
+      /**
+      * \brief Découpe un texte UTF-8 en mots
+      */
+    std::vector<Jeton> tokeniser(const std::string& texte)
+    {
+        std::vector<Jeton> jetons;
+        tokeniser(texte.data(), texte.size(), jetons);
+        return jetons;
+    }
+
+      /**
+      * \brief Met un mot UTF-8 en minuscules et retire ses accents, sur place
+      *
+      * \param[in,out] mot le début du mot
+      * \param[in] longueur le nombre d'octets du mot
+      * \return la nouvelle longueur du mot
+      */
+    std::size_t normaliser(char* mot, std::size_t longueur)
+    {
+        std::size_t lecture = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        while (lecture + BLOC <= longueur && minusculesBloc(mot + lecture)) // tant que rien n'a raccourci
+        {
+            lecture += BLOC;
+        }
+#endif
+        std::size_t ecriture = lecture;
+        while (lecture < longueur)
+        {
+            unsigned char c = mot[lecture];
+            const char* remplacement = nullptr;
+            if (c < 0x80)
+            {
+                mot[ecriture++] = (c >= 'A' && c <= 'Z') ? char(c + 0x20) : char(c);
+                lecture++;
+                continue;
+            }
+            if (lecture + 1 < longueur)
+            {
+                unsigned char suivant = mot[lecture + 1];
+                if (c == 0xC3 && suivant >= 0x80 && suivant <= 0xBF) remplacement = PLIAGE_C3[suivant - 0x80];
+                else if (c == 0xC5 && (suivant == 0x92 || suivant == 0x93)) remplacement = "oe"; // Œ œ
+                else if (c == 0xC5 && suivant == 0xB8) remplacement = "y";                       // Ÿ
+            }
+            if (remplacement == nullptr) // caractère conservé tel quel, octet par octet
+            {
+                mot[ecriture++] = mot[lecture++];
+                continue;
+            }
+            for (const char* r = remplacement; *r != '\0'; r++) // au plus 2 octets, jamais plus que la séquence lue
+            {
+                mot[ecriture++] = *r;
+            }
+            lecture += 2;
+        }
+        return ecriture;
+    }
+
+      /**
+      * \brief Met un mot UTF-8 en minuscules et retire ses accents, sur place
+      */
+    void normaliser(std::string& mot)
+    {
+        mot.resize(normaliser(&mot[0], mot.size()));
+    }
+
+}//Fin du namespace
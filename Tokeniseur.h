@@ -0,0 +1,70 @@
+/**
+* \file Tokeniseur.h
+* \brief Découpage d'un texte en mots et normalisation des mots pour la recherche dans le dictionnaire
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifndef _TOKENISEUR__H
+#define _TOKENISEUR__H
+
+namespace TP3
+{
+
+   /**
+   * \brief Position d'un mot dans le texte découpé
+   */
+   struct Jeton
+   {
+      std::size_t debut;
+      std::size_t longueur;
+   };
+
+   /**
+   * \brief Découpe un texte UTF-8 en mots.
+   *
+   * Un mot est une suite maximale de lettres et chiffres ASCII et d'octets non ASCII; tout autre
+   * caractère ASCII (espaces, ponctuation, apostrophe, trait d'union) sépare les mots, tout comme
+   * les ponctuations UTF-8 usuelles en français (« » ’ … – — et l'espace insécable).
+   * La classification se fait par blocs de 32 (AVX2) ou 16 (SSE2) octets, sinon octet par octet.
+   *
+   * \param[in] texte le début du texte
+   * \param[in] longueur le nombre d'octets du texte
+   * \param[out] jetons les mots trouvés sont ajoutés à la fin, dans l'ordre du texte
+   */
+   void tokeniser(const char* texte, std::size_t longueur, std::vector<Jeton>& jetons);
+
+   /**
+   * \brief Découpe un texte UTF-8 en mots, voir tokeniser(const char*, std::size_t, std::vector<Jeton>&)
+   */
+   std::vector<Jeton> tokeniser(const std::string& texte);
+
+   /**
+   * \brief Met un mot UTF-8 en minuscules et retire ses accents, sur place.
+   *
+   * Les lettres latines accentuées (Latin-1 et œ, Œ, Ÿ) deviennent leur lettre de base
+   * (é -> e, Ç -> c, œ -> oe, æ -> ae, ß -> ss), comme les formes du dictionnaire (enorme, etude).
+   * Les autres caractères non ASCII sont laissés tels quels. Le mot ne peut que raccourcir.
+   *
+   * \param[in,out] mot le début du mot
+   * \param[in] longueur le nombre d'octets du mot
+   * \return la nouvelle longueur du mot
+   */
+   std::size_t normaliser(char* mot, std::size_t longueur);
+
+   /**
+   * \brief Met un mot UTF-8 en minuscules et retire ses accents, sur place
+   */
+   void normaliser(std::string& mot);
+
+}//Fin du namespace
+
+#endif
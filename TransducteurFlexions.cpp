@@ -0,0 +1,167 @@
+/**
+* \file TransducteurFlexions.cpp
+* \brief Le code du transducteur acyclique minimal des flexions.
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3.
+*
+*/
+
+#include "TransducteurFlexions.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace TP3
+{
+
+    TransducteurFlexions::TransducteurFlexions() : debutArcs(1, 0), racine(AUCUN), nbMots(0)
+    {
+    }
+
+    void TransducteurFlexions::construire(const std::vector<std::pair<std::string, std::uint32_t> >& paires)
+    {
+        vider();
+        std::unordered_map<std::string, std::uint32_t> registre; // état figé, sérialisé -> son numéro
+        std::string cle;
+        std::vector<EtatEnConstruction> chemin(1, EtatEnConstruction{{}, AUCUN}); // chemin[i] : l'état après i octets du dernier mot
+        std::string precedent;
+        for (const auto& paire : paires)
+        {
+            const std::string& mot = paire.first;
+            if (mot.empty() || (nbMots > 0 && !(precedent < mot)))
+                throw std::logic_error("TransducteurFlexions::construire: les mots doivent être non vides, triés et sans doublon");
+            std::size_t commun = 0;
+            while (commun < precedent.size() && commun < mot.size() && precedent[commun] == mot[commun]) commun++;
+
+            // Les états du précédent mot après le préfixe commun ne changeront plus : on les fige
+            for (std::size_t i = precedent.size(); i > commun; i--)
+            {
+                chemin[i - 1].arcs.back().cible = _figer(chemin[i], registre, cle);
+            }
+
+            // Le suffixe du mot
+            if (chemin.size() < mot.size() + 1) chemin.resize(mot.size() + 1);
+            for (std::size_t i = commun + 1; i <= mot.size(); i++)
+            {
+                chemin[i].arcs.clear();
+                chemin[i].sortieFinale = AUCUN;
+                chemin[i - 1].arcs.push_back(ArcEnConstruction{static_cast<unsigned char>(mot[i - 1]), AUCUN, 0});
+            }
+            chemin[mot.size()].sortieFinale = 0;
+
+            // Le long du préfixe commun, chaque arc garde la partie de sa sortie commune à ce mot
+            // et repousse le reste sur les arcs (et la sortie finale) de l'état suivant
+            std::uint32_t sortie = paire.second;
+            for (std::size_t i = 1; i <= commun; i++)
+            {
+                ArcEnConstruction& arc = chemin[i - 1].arcs.back();
+                std::uint32_t partagee = std::min(arc.sortie, sortie);
+                std::uint32_t reste = arc.sortie - partagee;
+                arc.sortie = partagee;
+                sortie -= partagee;
+                if (reste == 0) continue;
+                for (auto& suivant : chemin[i].arcs) suivant.sortie += reste;
+                if (chemin[i].sortieFinale != AUCUN) chemin[i].sortieFinale += reste;
+            }
+            chemin[commun].arcs.back().sortie = sortie; // le premier arc du suffixe porte ce qui reste
+            precedent = mot;
+            nbMots++;
+        }
+        for (std::size_t i = precedent.size(); i > 0; i--)
+        {
+            chemin[i - 1].arcs.back().cible = _figer(chemin[i], registre, cle);
+        }
+        racine = _figer(chemin[0], registre, cle);
+        // figé : plus rien ne s'y ajoute
+        debutArcs.shrink_to_fit();
+        etiquettes.shrink_to_fit();
+        cibles.shrink_to_fit();
+        sorties.shrink_to_fit();
+        sortiesFinales.shrink_to_fit();
+    }
+
+    std::uint32_t TransducteurFlexions::trouver(std::string_view mot) const
+    {
+        if (racine == AUCUN) return AUCUN;
+        std::uint32_t etat = racine;
+        std::uint32_t somme = 0;
+        for (char c : mot)
+        {
+            const unsigned char etiquette = static_cast<unsigned char>(c);
+            const unsigned char* debut = etiquettes.data() + debutArcs[etat];
+            const unsigned char* fin = etiquettes.data() + debutArcs[etat + 1];
+            const unsigned char* arc = std::lower_bound(debut, fin, etiquette);
+            if (arc == fin || *arc != etiquette) return AUCUN;
+            std::size_t position = arc - etiquettes.data();
+            somme += sorties[position];
+            etat = cibles[position];
+        }
+        return sortiesFinales[etat] == AUCUN ? AUCUN : somme + sortiesFinales[etat];
+    }
+
+    std::size_t TransducteurFlexions::taille() const
+    {
+        return nbMots;
+    }
+
+    std::size_t TransducteurFlexions::nombreEtats() const
+    {
+        return sortiesFinales.size();
+    }
+
+    std::size_t TransducteurFlexions::nombreArcs() const
+    {
+        return etiquettes.size();
+    }
+
+    std::size_t TransducteurFlexions::octets() const
+    {
+        return debutArcs.capacity() * sizeof(std::uint32_t) + etiquettes.capacity()
+               + (cibles.capacity() + sorties.capacity() + sortiesFinales.capacity()) * sizeof(std::uint32_t);
+    }
+
+    void TransducteurFlexions::vider()
+    {
+        debutArcs.assign(1, 0);
+        etiquettes.clear();
+        cibles.clear();
+        sorties.clear();
+        sortiesFinales.clear();
+        racine = AUCUN;
+        nbMots = 0;
+    }
+
+    /**
+     * \brief Donne le numéro de l'état figé équivalent à etat, en le figeant s'il n'y en a pas encore
+     * \param[in,out] registre les états déjà figés, par leur forme sérialisée
+     * \param[out] cle tampon de sérialisation, réutilisé d'un appel à l'autre
+     */
+    std::uint32_t TransducteurFlexions::_figer(const EtatEnConstruction& etat, std::unordered_map<std::string, std::uint32_t>& registre,
+                                               std::string& cle)
+    {
+        // Deux états sont équivalents s'ils ont la même sortie finale et les mêmes arcs (étiquette, cible, sortie)
+        cle.assign(reinterpret_cast<const char*>(&etat.sortieFinale), sizeof(etat.sortieFinale));
+        for (const auto& arc : etat.arcs)
+        {
+            cle += static_cast<char>(arc.etiquette);
+            cle.append(reinterpret_cast<const char*>(&arc.cible), sizeof(arc.cible));
+            cle.append(reinterpret_cast<const char*>(&arc.sortie), sizeof(arc.sortie));
+        }
+        auto existant = registre.find(cle);
+        if (existant != registre.end()) return existant->second;
+        std::uint32_t numero = std::uint32_t(sortiesFinales.size());
+        for (const auto& arc : etat.arcs)
+        {
+            etiquettes.push_back(arc.etiquette);
+            cibles.push_back(arc.cible);
+            sorties.push_back(arc.sortie);
+        }
+        debutArcs.push_back(std::uint32_t(etiquettes.size()));
+        sortiesFinales.push_back(etat.sortieFinale);
+        registre.emplace(cle, numero);
+        return numero;
+    }
+
+}//Fin du namespace
@@ -0,0 +1,121 @@
+/**
+* \file TransducteurFlexions.h
+* \brief Interface d'un transducteur acyclique minimal figé, d'un mot vers un entier de 32 bits
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef _TRANSDUCTEURFLEXIONS__H
+#define _TRANSDUCTEURFLEXIONS__H
+
+namespace TP3
+{
+
+   /**
+   * \class TransducteurFlexions
+   *
+   * \brief Transducteur d'états finis acyclique et minimal, construit une fois à partir de paires
+   *        (mot, valeur) triées, qui associe à chaque mot sa valeur (par exemple le numéro du
+   *        radical d'une flexion).
+   *
+   * Les mots qui partagent un préfixe partagent leurs premiers états, et ceux qui partagent un
+   * suffixe leurs derniers (grand, grands, grande, grandes : 8 arcs pour 24 octets de texte).
+   * La valeur d'un mot est la somme des sorties des arcs de son chemin et de la sortie finale de
+   * son dernier état; chaque sortie est repoussée le plus près possible de la racine, ce qui
+   * permet de fusionner les états de même suffixe même quand leurs mots n'ont pas la même valeur.
+   *
+   * La construction suit l'algorithme incrémental de Mihov et Maurel : les mots arrivent triés,
+   * seul le chemin du dernier mot reste modifiable, et chaque état qui le quitte est remplacé par
+   * un état équivalent déjà figé s'il y en a un. Les états figés sont rangés dans des tableaux
+   * (arcs triés par octet) : trouver() lit le mot octet par octet, sans allocation.
+   *
+   */
+   class TransducteurFlexions
+   {
+   public:
+
+      static constexpr std::uint32_t AUCUN = 0xffffffffu;   // Mot absent, pour trouver().
+
+      TransducteurFlexions();
+
+      /**
+      * \brief Remplace le contenu par les paires données
+      * \pre Les mots sont non vides, triés par octets (ordre de std::string) et sans doublon;
+      *      les valeurs sont plus petites que AUCUN
+      * \exception logic_error si un mot est vide ou n'est pas après le précédent
+      */
+      void construire(const std::vector<std::pair<std::string, std::uint32_t> >& paires);
+
+      /**
+      * \brief Donne la valeur de mot, ou AUCUN si mot n'est pas dans le transducteur
+      */
+      std::uint32_t trouver(std::string_view mot) const;
+
+      /**
+      * \brief Donne le nombre de mots
+      */
+      std::size_t taille() const;
+
+      /**
+      * \brief Donne le nombre d'états
+      */
+      std::size_t nombreEtats() const;
+
+      /**
+      * \brief Donne le nombre d'arcs
+      */
+      std::size_t nombreArcs() const;
+
+      /**
+      * \brief Donne le nombre d'octets réservés par le transducteur figé
+      */
+      std::size_t octets() const;
+
+      /**
+      * \brief Retire tous les mots
+      */
+      void vider();
+
+   private:
+
+      // L'état e a les arcs [debutArcs[e], debutArcs[e + 1]), triés par étiquette.
+      std::vector<std::uint32_t> debutArcs;
+      std::vector<unsigned char> etiquettes;
+      std::vector<std::uint32_t> cibles;
+      std::vector<std::uint32_t> sorties;
+      std::vector<std::uint32_t> sortiesFinales;   // AUCUN si l'état n'est pas final.
+      std::uint32_t racine;
+      std::size_t nbMots;
+
+      struct ArcEnConstruction
+      {
+         unsigned char etiquette;
+         std::uint32_t cible;
+         std::uint32_t sortie;
+      };
+
+      struct EtatEnConstruction
+      {
+         std::vector<ArcEnConstruction> arcs;
+         std::uint32_t sortieFinale;                 // AUCUN si l'état n'est pas final.
+      };
+
+      std::uint32_t _figer(const EtatEnConstruction& etat, std::unordered_map<std::string, std::uint32_t>& registre,
+                           std::string& cle);
+   };
+
+}//Fin du namespace
+
+#endif
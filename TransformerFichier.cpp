@@ -0,0 +1,237 @@
+/**
+* \file TransformerFichier.cpp
+* \brief Transforme un fichier texte en entier avec le dictionnaire, en lisant et écrivant pendant le calcul
+* \author IFT-2008
+* \version 0.1
+* \date 22 juillet 2024
+*
+* Travail pratique numéro 3
+*
+* Usage : TransformerFichier <dictionnaire.txt> <entree> <sortie> [anneau|secours|flux]
+* Compilation : g++ -std=c++17 -O2 -pthread TransformerFichier.cpp AnneauES.cpp puis les .cpp du
+*               dictionnaire (tous sauf Principal.cpp, ServeurDico.cpp, ClientCharge.cpp,
+*               TestsDicoSynonymes.cpp et BancDicoSynonymes.cpp)
+*
+* Chaque ligne de l'entrée est transformée par DicoSynonymes::transformer et écrite dans la sortie;
+* la sortie a exactement les mêmes fins de ligne que l'entrée.
+*
+* En mode anneau (défaut), l'entrée est lue par blocs de TAILLE_BLOC octets avec AnneauES : les
+* NB_BLOCS blocs qui suivent celui qu'on transforme sont déjà demandés, et les sorties des blocs
+* précédents s'écrivent pendant ce temps. Le mode secours fait de même avec le fil pread/pwrite
+* d'AnneauES au lieu d'io_uring. Le mode flux est la version directe (getline et ofstream), pour
+* comparer. L'entrée doit être un fichier ordinaire (les lectures se font à une position).
+*
+*/
+
+#include "DicoSynonymes.h"
+#include "AnneauES.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+using namespace TP3;
+using Horloge = chrono::steady_clock;
+
+namespace
+{
+	const size_t TAILLE_BLOC = 1 << 20;	// Octets lus par requête.
+	const unsigned int NB_BLOCS = 4;	// Blocs d'entrée, et de sortie, en cours à la fois.
+
+	/**
+	 * \brief Ajoute à sortie les lignes complètes de texte transformées, et donne la position qui suit la dernière
+	 */
+	size_t transformerLignes(const DicoSynonymes& dico, const string& texte, string& sortie)
+	{
+		string ligne;
+		size_t debut = 0;
+		for (size_t fin = texte.find('\n'); fin != string::npos; fin = texte.find('\n', debut))
+		{
+			ligne.assign(texte, debut, fin - debut);
+			sortie += dico.transformer(ligne);
+			sortie += '\n';
+			debut = fin + 1;
+		}
+		return debut;
+	}
+
+	/**
+	 * \brief La version directe : une ligne lue, une ligne écrite
+	 */
+	void transformerFlux(const DicoSynonymes& dico, const string& entree, const string& sortie)
+	{
+		ifstream lecture(entree, ios::binary);
+		if (!lecture) throw runtime_error("impossible d'ouvrir " + entree);
+		ofstream ecriture(sortie, ios::binary | ios::trunc);
+		if (!ecriture) throw runtime_error("impossible de créer " + sortie);
+		string ligne;
+		while (getline(lecture, ligne))
+		{
+			ecriture << dico.transformer(ligne);
+			if (!lecture.eof()) ecriture << '\n'; // la dernière ligne n'a pas toujours de fin de ligne
+		}
+		if (lecture.bad() || !ecriture.flush()) throw runtime_error("erreur de lecture ou d'écriture");
+	}
+
+	/**
+	 * \brief La version asynchrone : NB_BLOCS lectures en avance, NB_BLOCS écritures en retard
+	 */
+	void transformerAnneau(const DicoSynonymes& dico, const string& entree, const string& sortie, bool secours)
+	{
+		int fdEntree = open(entree.c_str(), O_RDONLY);
+		if (fdEntree < 0) throw runtime_error("impossible d'ouvrir " + entree + " : " + strerror(errno));
+		int fdSortie = open(sortie.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fdSortie < 0)
+		{
+			close(fdEntree);
+			throw runtime_error("impossible de créer " + sortie + " : " + strerror(errno));
+		}
+		struct Bloc
+		{
+			vector<char> donnees;
+			size_t attendus = 0;	// Octets demandés pour le bloc en cours de lecture.
+			size_t lus = 0;
+		};
+		struct Ecriture
+		{
+			string donnees;
+			size_t ecrits = 0;
+			uint64_t position = 0;
+			bool enCours = false;
+		};
+		try
+		{
+			struct stat etat;
+			if (fstat(fdEntree, &etat) != 0 || !S_ISREG(etat.st_mode)) throw runtime_error(entree + " n'est pas un fichier ordinaire");
+			const uint64_t taille = uint64_t(etat.st_size);
+			const uint64_t nbMorceaux = (taille + TAILLE_BLOC - 1) / TAILLE_BLOC;
+			// Les tampons sont déclarés avant l'anneau : sur une exception, ~AnneauES attend les requêtes
+			// en cours pendant qu'ils existent encore
+			vector<Bloc> blocs(NB_BLOCS);
+			vector<Ecriture> ecritures(NB_BLOCS);	// Jeton d'une écriture : NB_BLOCS + sa position dans ecritures.
+			for (Bloc& bloc : blocs) bloc.donnees.resize(TAILLE_BLOC);
+			AnneauES anneau(2 * NB_BLOCS, secours);
+			cerr << "anneau : " << (anneau.noyau() ? "io_uring" : "fil pread/pwrite") << endl;
+
+			// Le morceau k (octets [k * TAILLE_BLOC, (k + 1) * TAILLE_BLOC)) se lit dans le bloc k % NB_BLOCS
+			auto demanderLecture = [&](uint64_t morceau) {
+				Bloc& bloc = blocs[morceau % NB_BLOCS];
+				bloc.attendus = size_t(min<uint64_t>(TAILLE_BLOC, taille - morceau * TAILLE_BLOC));
+				bloc.lus = 0;
+				anneau.lire(fdEntree, bloc.donnees.data(), bloc.attendus, morceau * TAILLE_BLOC, morceau % NB_BLOCS);
+			};
+			// Traite un achèvement; une lecture ou une écriture partielle est relancée pour le reste
+			vector<uint64_t> morceauDuBloc(NB_BLOCS);
+			auto achever = [&]() {
+				AnneauES::Achevement fin = anneau.attendre();
+				if (fin.resultat < 0) throw runtime_error(string("erreur d'entrée-sortie : ") + strerror(int(-fin.resultat)));
+				if (fin.jeton < NB_BLOCS)
+				{
+					Bloc& bloc = blocs[fin.jeton];
+					if (fin.resultat == 0) throw runtime_error(entree + " a raccourci pendant la lecture");
+					bloc.lus += size_t(fin.resultat);
+					if (bloc.lus < bloc.attendus)
+						anneau.lire(fdEntree, bloc.donnees.data() + bloc.lus, bloc.attendus - bloc.lus,
+									morceauDuBloc[fin.jeton] * TAILLE_BLOC + bloc.lus, fin.jeton);
+					return;
+				}
+				Ecriture& ecriture = ecritures[fin.jeton - NB_BLOCS];
+				ecriture.ecrits += size_t(fin.resultat);
+				if (ecriture.ecrits < ecriture.donnees.size())
+					anneau.ecrire(fdSortie, ecriture.donnees.data() + ecriture.ecrits, ecriture.donnees.size() - ecriture.ecrits,
+								  ecriture.position + ecriture.ecrits, fin.jeton);
+				else
+					ecriture.enCours = false;
+			};
+
+			for (uint64_t morceau = 0; morceau < min<uint64_t>(NB_BLOCS, nbMorceaux); morceau++)
+			{
+				morceauDuBloc[morceau] = morceau;
+				demanderLecture(morceau);
+			}
+			string texte;			// Le morceau en cours, précédé de la ligne incomplète du précédent.
+			uint64_t positionSortie = 0;
+			for (uint64_t morceau = 0; morceau < nbMorceaux; morceau++)
+			{
+				Bloc& bloc = blocs[morceau % NB_BLOCS];
+				while (bloc.lus < bloc.attendus) achever();
+				texte.append(bloc.donnees.data(), bloc.attendus);
+				if (morceau + NB_BLOCS < nbMorceaux) // le bloc est recopié : on peut déjà y lire la suite
+				{
+					morceauDuBloc[morceau % NB_BLOCS] = morceau + NB_BLOCS;
+					demanderLecture(morceau + NB_BLOCS);
+					anneau.soumettre();
+				}
+				Ecriture& ecriture = ecritures[morceau % NB_BLOCS];
+				while (ecriture.enCours) achever();
+				ecriture.donnees.clear();
+				size_t fait = transformerLignes(dico, texte, ecriture.donnees);
+				texte.erase(0, fait);
+				if (morceau + 1 == nbMorceaux && !texte.empty()) // dernière ligne, sans fin de ligne
+				{
+					ecriture.donnees += dico.transformer(texte);
+					texte.clear();
+				}
+				if (ecriture.donnees.empty()) continue;
+				ecriture.ecrits = 0;
+				ecriture.position = positionSortie;
+				ecriture.enCours = true;
+				positionSortie += ecriture.donnees.size();
+				anneau.ecrire(fdSortie, ecriture.donnees.data(), ecriture.donnees.size(), ecriture.position, NB_BLOCS + morceau % NB_BLOCS);
+				anneau.soumettre();
+			}
+			while (anneau.enCours() > 0) achever();
+		}
+		catch (...)
+		{
+			close(fdEntree);
+			close(fdSortie);
+			throw;
+		}
+		close(fdEntree);
+		if (close(fdSortie) != 0) throw runtime_error("erreur d'écriture de " + sortie + " : " + strerror(errno));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 4 || argc > 5)
+	{
+		cerr << "Usage : " << argv[0] << " <dictionnaire.txt> <entree> <sortie> [anneau|secours|flux]" << endl;
+		return 1;
+	}
+	string mode = argc == 5 ? argv[4] : "anneau";
+	if (mode != "anneau" && mode != "secours" && mode != "flux")
+	{
+		cerr << "Mode inconnu : " << mode << endl;
+		return 1;
+	}
+	try
+	{
+		DicoSynonymes dico;
+		Horloge::time_point debut = Horloge::now();
+		dico.chargerEnParallele(argv[1]);
+		dico.expansion(""); // les tables des expansions sont construites avant la mesure
+		double chargement = chrono::duration<double>(Horloge::now() - debut).count();
+
+		debut = Horloge::now();
+		if (mode == "flux")
+			transformerFlux(dico, argv[2], argv[3]);
+		else
+			transformerAnneau(dico, argv[2], argv[3], mode == "secours");
+		double duree = chrono::duration<double>(Horloge::now() - debut).count();
+
+		struct stat etat;
+		double octets = stat(argv[2], &etat) == 0 ? double(etat.st_size) : 0;
+		cout << "Dictionnaire chargé en " << chargement << " s" << endl
+			 << "Transformé " << octets / 1e6 << " Mo en " << duree << " s : " << octets / 1e6 / duree << " Mo/s (" << mode << ")" << endl;
+	}
+	catch (const exception& e)
+	{
+		cerr << "Erreur : " << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}